@@ -23,11 +23,14 @@
 #ifndef CROSS_H
 #define CROSS_H
 
+#include <memory>
+
 class Master;
 class Input;
 template<typename> class Grid;
 template<typename> class Soil_grid;
 template<typename> class Fields;
+template<typename> class Netcdf_output;
 
 enum class Cross_direction {Top_to_bottom, Bottom_to_top};
 
@@ -65,11 +68,20 @@ class Cross
         Field3d_io<TF> field3d_io;
 
         bool swcross;
+        bool swnetcdf; ///< Write the cross-sections into NetCDF files instead of binary files.
+        bool swaggregate; ///< Write all slices of a variable and orientation as one record per time into a single file.
+        int iotimeprec;
+        unsigned long iosampletime; ///< Sampling time in units of the output time, which sets the record index.
         TF sampletime;
         unsigned long isampletime;
 
         std::vector<std::string> crosslist; ///< List with all crosses from the ini file.
 
+        std::unique_ptr<Netcdf_output<TF>> netcdf_output;
+
+        std::map<std::string, int> keepbits;   ///< Number of kept mantissa bits of lossy cross-sections per variable.
+        std::map<std::string, TF> error_bound; ///< Absolute error bound of lossy cross-sections per variable.
+
         std::vector<int> jxz;   ///< Index of nearest full y position of xz input
         std::vector<int> ixz;   ///< Index of nearest full x position of yz input
         std::vector<int> kxy;   ///< Index of nearest full height level of xy input
@@ -87,5 +99,10 @@ class Cross
 
         //int check_list(std::vector<std::string> *, FieldMap *, std::string crossname);
         int check_save(int, char *);
+        int get_record(int);
+        bool apply_lossy(TF*, const TF*, const int, const std::string&);
+        void save_netcdf(
+                TF*, const TF, TF*, const std::string&, const std::string&,
+                const std::vector<int>&, const std::array<int,3>&, const int, const int, const int);
 };
 #endif
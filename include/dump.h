@@ -23,10 +23,14 @@
 #ifndef DUMP_H
 #define DUMP_H
 
+#include <array>
+#include <memory>
+
 class Master;
 class Input;
 template<typename> class Grid;
 template<typename> class Fields;
+template<typename> class Netcdf_output;
 
 template<typename TF>
 class Dump
@@ -43,7 +47,7 @@ class Dump
         std::vector<std::string>& get_dumplist();
 
         bool do_dump(unsigned long, unsigned long);
-        void save_dump(TF*, const std::string&, int);
+        void save_dump(TF*, const std::string&, int, const std::array<int,3>& loc={0,0,0});
 
     private:
         Master& master;
@@ -52,9 +56,22 @@ class Dump
         Field3d_io<TF> field3d_io;
 
         std::vector<std::string> dumplist; // List with all dumps from the ini file.
+
+        std::map<std::string, int> keepbits;   // Number of kept mantissa bits of lossy dumps per variable.
+        std::map<std::string, TF> error_bound; // Absolute error bound of lossy dumps per variable.
+        std::map<std::string, std::array<int,3>> coarsen; // Number of cells in x, y, and z that are averaged per variable.
+        std::map<std::string, std::vector<TF>> region;     // Bounds x0,x1,y0,y1,z0,z1 [m] of the dumped region per variable.
+        std::map<std::string, std::array<int,3>> stride;  // Stride in x, y, and z of the dumped region per variable.
         bool swdump;                       // Statistics on/off switch
         bool swdoubledump;                 // On/off switch for two consecutive dumps in time
+        bool swnetcdf;                     // Write the dumps into NetCDF files instead of binary files
         double sampletime;
         unsigned long isampletime;
+
+        std::unique_ptr<Netcdf_output<TF>> netcdf_output;
+
+        void save_dump_netcdf(TF*, const std::string&, int, const std::array<int,3>&);
+        void save_dump_coarse(TF*, const std::string&, int, const std::array<int,3>&, const std::array<int,3>&);
+        void save_dump_region(TF*, const std::string&, int, const std::array<int,3>&);
 };
 #endif
@@ -30,6 +30,11 @@
 #  define CUDA_MACRO
 #endif
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
 namespace Fast_math
 {
     template<typename TF>
@@ -61,5 +66,179 @@ namespace Fast_math
     {
         return a*a*a*a*a*a*a*a*a;
     }
+
+    /*
+     * Branch free versions of exp, log, pow and cbrt, which vectorize in the loops of the
+     * physics kernels, as opposed to the libm calls. Modules opt in by calling them as
+     * `Fast_math::exp()` etc. The maximum relative errors, with respect to libm, are
+     * about 5e-16 (double) and 2e-7 (float) for `exp()` and `log()`; `pow(x, y)`
+     * adds an error of about |y*log(x)| times that of `log()`. The argument of `log()`
+     * has to be positive and normal, `pow()` and `pow_two_thirds()` return 0 for x <= 0.
+     * NaN arguments are returned as NaN, also when compiled with -ffast-math.
+     * On the GPU, the CUDA math functions are used.
+     */
+    namespace Detail
+    {
+        // Integer type with the size of TF, and the layout of TF.
+        template<typename TF> struct Float_bits;
+
+        template<> struct Float_bits<double>
+        {
+            using Int = std::int64_t;
+            static constexpr int nmantissa = 52;
+            static constexpr Int bias = 1023;
+            static constexpr double shifter = 6755399441055744.;  // 1.5*2^52.
+        };
+
+        template<> struct Float_bits<float>
+        {
+            using Int = std::int32_t;
+            static constexpr int nmantissa = 23;
+            static constexpr Int bias = 127;
+            static constexpr float shifter = 12582912.f;  // 1.5*2^23.
+        };
+
+        template<typename TF>
+        inline typename Float_bits<TF>::Int to_bits(const TF a)
+        {
+            typename Float_bits<TF>::Int i;
+            std::memcpy(&i, &a, sizeof(TF));
+            return i;
+        }
+
+        template<typename TF>
+        inline TF from_bits(const typename Float_bits<TF>::Int i)
+        {
+            TF a;
+            std::memcpy(&a, &i, sizeof(TF));
+            return a;
+        }
+
+        // Return `x` if it is NaN and `a` otherwise. The test and the selection are done on the bits,
+        // because -ffast-math removes `x != x` and `std::isnan()`, and a conditional blocks vectorization.
+        template<typename TF>
+        inline TF propagate_nan(const TF x, const TF a)
+        {
+            using Int = typename Float_bits<TF>::Int;
+            constexpr Int abs_mask = ~(Int(1) << (8*sizeof(TF) - 1));
+            constexpr Int inf_bits = ((Int(2)*Float_bits<TF>::bias + 1) << Float_bits<TF>::nmantissa);
+
+            const Int x_bits = to_bits(x);
+            const Int mask = -Int((x_bits & abs_mask) > inf_bits);
+            return from_bits<TF>((to_bits(a) & ~mask) | (x_bits & mask));
+        }
+
+        // Taylor polynomial of exp(r) for |r| <= ln(2)/2.
+        inline double exp_poly(const double r)
+        {
+            return 1. + r*(1. + r*(1./2. + r*(1./6. + r*(1./24. + r*(1./120. + r*(1./720.
+                 + r*(1./5040. + r*(1./40320. + r*(1./362880. + r*(1./3628800.
+                 + r*(1./39916800. + r*(1./479001600.))))))))))));
+        }
+
+        inline float exp_poly(const float r)
+        {
+            return 1.f + r*(1.f + r*(1.f/2.f + r*(1.f/6.f + r*(1.f/24.f + r*(1.f/120.f
+                 + r*(1.f/720.f + r*(1.f/5040.f)))))));
+        }
+
+        // Series of atanh(s)/s = 1 + s^2/3 + s^4/5 + ..., for s^2 <= 0.0295.
+        inline double log_poly(const double z)
+        {
+            return 1. + z*(1./3. + z*(1./5. + z*(1./7. + z*(1./9. + z*(1./11.
+                 + z*(1./13. + z*(1./15. + z*(1./17. + z*(1./19.)))))))));
+        }
+
+        inline float log_poly(const float z)
+        {
+            return 1.f + z*(1.f/3.f + z*(1.f/5.f + z*(1.f/7.f + z*(1.f/9.f))));
+        }
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF exp(const TF x)
+    {
+        #ifdef __CUDA_ARCH__
+        return ::exp(x);
+        #else
+        using Fb = Detail::Float_bits<TF>;
+
+        constexpr TF log2e = TF(1.4426950408889634);
+        constexpr TF ln2_hi = TF(0.693145751953125);
+        constexpr TF ln2_lo = TF(1.4286068203094172e-06);
+
+        // Keep 2^n within the normal range.
+        const TF x_max = TF(Fb::bias) * TF(0.6931471805599453);
+        const TF xc = std::min(std::max(x, -x_max + TF(1.)), x_max);
+
+        // x = n*ln(2) + r, with the integer n stored in the lowest bits of `kd`. The rounding is done
+        // with `rint()`, as -ffast-math would cancel rounding by adding and subtracting the shifter.
+        const TF n = std::rint(xc*log2e);
+        const TF kd = n + Fb::shifter;
+        const TF r = (xc - n*ln2_hi) - n*ln2_lo;
+
+        const typename Fb::Int ni = Detail::to_bits(kd) - Detail::to_bits(Fb::shifter);
+        const TF scale = Detail::from_bits<TF>((ni + Fb::bias) << Fb::nmantissa);
+
+        return Detail::propagate_nan(x, scale * Detail::exp_poly(r));
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF log(const TF x)
+    {
+        #ifdef __CUDA_ARCH__
+        return ::log(x);
+        #else
+        using Fb = Detail::Float_bits<TF>;
+        using Int = typename Fb::Int;
+
+        constexpr TF sqrt2 = TF(1.4142135623730951);
+        constexpr TF ln2 = TF(0.6931471805599453);
+        constexpr Int mantissa_mask = (Int(1) << Fb::nmantissa) - 1;
+
+        // x = m * 2^e, with m in [sqrt(1/2), sqrt(2)).
+        const Int bits = Detail::to_bits(x);
+        const Int e_raw = (bits >> Fb::nmantissa) - Fb::bias;
+        const TF m_raw = Detail::from_bits<TF>((bits & mantissa_mask) | (Fb::bias << Fb::nmantissa));
+
+        const bool high = m_raw > sqrt2;
+        const TF m = high ? TF(0.5)*m_raw : m_raw;
+        const TF e = TF(e_raw) + (high ? TF(1.) : TF(0.));
+
+        // log(m) = 2*atanh(s), with s = (m-1)/(m+1).
+        const TF s = (m - TF(1.)) / (m + TF(1.));
+        return Detail::propagate_nan(x, e*ln2 + TF(2.)*s*Detail::log_poly(s*s));
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF pow(const TF x, const TF y)
+    {
+        #ifdef __CUDA_ARCH__
+        return ::pow(x, y);
+        #else
+        // `log()` returns a finite value for x <= 0, which is masked out afterwards.
+        const TF a = Fast_math::exp(y * Fast_math::log(x));
+        return Detail::propagate_nan(x, Detail::propagate_nan(y, (x > TF(0.)) ? a : TF(0.)));
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF cbrt(const TF x)
+    {
+        #ifdef __CUDA_ARCH__
+        return ::cbrt(x);
+        #else
+        const TF a = Fast_math::pow(std::abs(x), TF(1.)/TF(3.));
+        return std::copysign(a, x);
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF pow_two_thirds(const TF x)
+    {
+        return Fast_math::pow(x, TF(2.)/TF(3.));
+    }
 }
 #endif
@@ -23,6 +23,11 @@
 #ifndef FIELD3D_IO_H
 #define FIELD3D_IO_H
 
+#include <array>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
 #include "transpose.h"
 
 class Master;
@@ -35,16 +40,76 @@ class Field3d_io
         Field3d_io(Master&, Grid<TF>&);
         ~Field3d_io();
 
+        void init(); ///< Creates the transpose and MPI datatypes that are reused for all IO.
+
         int save_field3d(TF*, TF*, TF*, const char*, const TF, int, int); // Saves a full 3d field.
         int load_field3d(TF*, TF*, TF*, const char*, const TF, int, int); // Loads a full 3d field.
 
+        // Saves a full 3d field with compression, which is lossless unless keepbits or error_bound is set.
+        int save_field3d_compressed(TF*, TF*, const char*, int, int, int, int keepbits=0, TF error_bound=0);
+        int load_field3d_compressed(TF*, const char*, int, int); // Loads a compressed full 3d field.
+        bool is_compressed_field3d(const char*); // Checks whether a field file starts with the compressed header.
+
+        // Saves a 3d field averaged over blocks of the given number of cells in x, y, and z, with the vertical weights per level.
+        int save_field3d_coarse(TF*, const TF*, const char*, int, int, const std::array<int,3>&);
+
+        // Saves every n-th point of a region of a 3d field. The range holds the global start and end indices
+        // without ghost cells in x and y, and with ghost cells in z. Only processes that intersect the region take part.
+        int save_field3d_region(TF*, TF*, const char*, const std::array<int,6>&, const std::array<int,3>&);
+
         int save_xz_slice(TF*, TF, TF*, const char*, int, int, int); // Saves a xz-slice from a 3d field.
         int save_yz_slice(TF*, TF, TF*, const char*, int, int, int); // Saves a yz-slice from a 3d field.
         int save_xy_slice(TF*, TF, TF*, const char*, int kslice=0);  // Saves a xy-slice from a 3d field.
         int load_xy_slice(TF*, TF*, const char*, int kslice=-1); // Loads a xy-slice.
 
+        // Save all slices of one orientation as a single record of an appendable file, with the record index given by the last argument.
+        int save_xz_slices(TF*, TF, TF*, const char*, const std::vector<int>&, int, int, int);
+        int save_yz_slices(TF*, TF, TF*, const char*, const std::vector<int>&, int, int, int);
+        int save_xy_slices(TF*, TF, TF*, const char*, const std::vector<int>&, int, int);
+
+        // Gather slices without ghost cells on the first process. The output is only filled on the first process.
+        void gather_xz_slice(std::vector<TF>&, TF*, TF, TF*, int, int, int);
+        void gather_yz_slice(std::vector<TF>&, TF*, TF, TF*, int, int, int);
+        void gather_xy_slice(std::vector<TF>&, TF*, TF, TF*, int kslice=0);
+
+        // Saves/loads multiple 3d fields in a single indexed file, with the fields at offsets that are aligned to the given number of bytes.
+        int save_checkpoint(const std::vector<std::pair<std::string, TF*>>&, const char*, int, int, long alignment=1048576);
+        int load_checkpoint(const std::vector<std::pair<std::string, TF*>>&, std::vector<bool>&, const char*, int, int);
+
+        // Copies the fields into a staging buffer and writes the checkpoint in a background thread.
+        // The write has to be completed with finish_checkpoint_async(), which is also done before the next checkpoint.
+        int save_checkpoint_async(const std::vector<std::pair<std::string, TF*>>&, const char*, int, int, long alignment=1048576);
+        int finish_checkpoint_async();
+        bool checkpoint_in_flight() const { return checkpoint_writer.valid(); }
+
     private:
         Master& master;
         Grid<TF>& grid;
+        Transpose<TF> transpose;
+
+        void init_mpi();
+        void exit_mpi();
+        bool mpi_types_allocated;
+
+        void gather_block(std::vector<TF>&, const TF*, int, int, int, int, int, int, int);
+        int write_slices(const TF*, const std::vector<int>&, int, const char*, const std::vector<int>&, int, int, int, int);
+
+        std::vector<TF> checkpoint_buffer;   ///< Staging buffer of the asynchronous checkpoint.
+        std::future<int> checkpoint_writer;  ///< Background write of the asynchronous checkpoint.
+
+        #ifdef USEMPI
+        MPI_Datatype get_subarray_3d(int);  ///< Returns (and caches) the file view of a non-transposed field with given number of levels.
+        MPI_Datatype get_subarray_xz(int);  ///< Returns (and caches) the file view of an xz-slice with given number of levels.
+        MPI_Datatype get_subarray_yz(int);  ///< Returns (and caches) the file view of an yz-slice with given number of levels.
+
+        MPI_Datatype subarray_transposed;   ///< File view of a full 3d field in transposed order.
+        MPI_Datatype subarray_xy;           ///< File view of an xy-slice.
+        std::map<int, MPI_Datatype> subarrays_3d;
+        std::map<int, MPI_Datatype> subarrays_xz;
+        std::map<int, MPI_Datatype> subarrays_yz;
+
+        MPI_Comm get_sub_comm(const std::vector<int>&, bool); ///< Returns (and caches) the communicator of the processes that hold data of a partial write.
+        std::map<std::vector<int>, MPI_Comm> sub_comms;
+        #endif
 };
 #endif
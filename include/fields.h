@@ -117,6 +117,7 @@ class Fields
 
         void save(int);
         void load(int);
+        void flush_checkpoint(); ///< Waits until an asynchronous checkpoint is written.
 
         TF check_momentum();
         TF check_tke();
@@ -195,6 +196,12 @@ class Fields
 
         bool calc_mean_profs;
 
+        bool swcheckpoint;       ///< Switch for saving the restart fields in a single indexed file.
+        bool swcheckpointasync;  ///< Switch for writing the checkpoint file in the background.
+        bool swcompress;         ///< Switch for lossless compression of the restart files.
+        int compress_level;      ///< Zlib compression level of the restart files.
+        int checkpoint_align;    ///< Alignment in bytes of the fields in the checkpoint file.
+
         int n_tmp_fields;   ///< Number of temporary fields.
         int n_tmp_fields_xy;   ///< Number of temporary fields.
 
@@ -0,0 +1,91 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LOSSY_COMPRESSION_H
+#define LOSSY_COMPRESSION_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Lossy preconditioning of output data. Both transforms replace the trailing bits of the values
+// by zeros or by repeating patterns, which the subsequent lossless stage compresses very well.
+namespace Lossy_compression
+{
+    // Round to the nearest value with only keepbits significant mantissa bits (round half to even).
+    // The relative error is bounded by 2^-(keepbits+1). A keepbits of zero or negative disables the rounding.
+    template<typename TF>
+    void round_keepbits(TF* const data, const size_t n, const int keepbits)
+    {
+        using Bits = typename std::conditional<sizeof(TF) == 8, uint64_t, uint32_t>::type;
+        constexpr int mantissa_bits = std::numeric_limits<TF>::digits - 1;
+
+        if (keepbits <= 0 || keepbits >= mantissa_bits)
+            return;
+
+        const int shift = mantissa_bits - keepbits;
+        const Bits half_minus_one = (Bits(1) << (shift-1)) - 1;
+        const Bits mask = ~((Bits(1) << shift) - 1);
+
+        for (size_t i=0; i<n; ++i)
+        {
+            if (!std::isfinite(data[i]))
+                continue;
+
+            Bits bits;
+            std::memcpy(&bits, &data[i], sizeof(TF));
+            bits += half_minus_one + ((bits >> shift) & 1);
+            bits &= mask;
+            std::memcpy(&data[i], &bits, sizeof(TF));
+        }
+    }
+
+    // Quantize to multiples of twice the error bound, such that the absolute error does not exceed
+    // the bound. Values for which rounding errors would violate the bound are kept as they are.
+    template<typename TF>
+    void quantize(TF* const data, const size_t n, const TF error_bound)
+    {
+        if (error_bound <= TF(0))
+            return;
+
+        const TF step = TF(2)*error_bound;
+
+        for (size_t i=0; i<n; ++i)
+        {
+            const TF quantized = std::round(data[i]/step)*step;
+            if (std::abs(quantized - data[i]) <= error_bound)
+                data[i] = quantized;
+        }
+    }
+
+    // Apply both transforms.
+    template<typename TF>
+    void apply(TF* const data, const size_t n, const int keepbits, const TF error_bound)
+    {
+        quantize(data, n, error_bound);
+        round_keepbits(data, n, keepbits);
+    }
+}
+#endif
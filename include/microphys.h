@@ -36,6 +36,7 @@ template<typename> class Thermo;
 template<typename> class Field3d;
 
 enum class Microphys_type {Disabled, Warm_2mom, Nsw6};
+enum class Sedimentation_type {SS08, Remap};
 
 /**
  * Base class for the microphysics scheme. This class is abstract and only
@@ -81,6 +82,9 @@ class Microphys
         #endif
 
     protected:
+        // Read the sedimentation scheme, shared by the schemes with precipitation.
+        static Sedimentation_type read_sedimentation_type(Input&);
+
         Master& master;
         Grid<TF>& grid;
         Fields<TF>& fields;
@@ -34,6 +34,7 @@
 
 #include "microphys.h"
 #include "field3d_operators.h"
+#include "microphys_active_columns.h"
 
 class Master;
 class Input;
@@ -188,6 +189,7 @@ class Microphys_2mom_warm : public Microphys<TF>
 
         bool swmicrobudget;     // Output full microphysics budget terms
         TF cflmax;              // Max CFL number in microphysics sedimentation
+        Sedimentation_type swsedimentation; // Sedimentation scheme
 
         std::vector<std::string> crosslist;                  // Cross-sections handled by this class
         std::vector<std::string> available_masks = {"qr"};   // Vector with the masks that fields can provide
@@ -201,6 +203,12 @@ class Microphys_2mom_warm : public Microphys<TF>
         TF* rr_bot_g;
         #endif
 
+        // Columns with cloud (ql > ql_min), rain (qr > qr_min) and either of both, rebuilt every call to exec.
+        Microphys_active_columns cloud_columns;
+        Microphys_active_columns rain_columns;
+        Microphys_active_columns warm_columns;
+        void build_active_columns(const TF* const);
+
         const std::string tend_name = "micro";
         const std::string tend_longname = "Microphysics";
 };
@@ -0,0 +1,170 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MICROPHYS_ACTIVE_COLUMNS_H
+#define MICROPHYS_ACTIVE_COLUMNS_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+
+// Index of the (i,j) columns that contain hydrometeors, together with the vertical
+// range over which they do. It is rebuilt every time step, so that the microphysics
+// process kernels only visit the cloudy and rainy parts of the domain.
+struct Microphys_active_columns
+{
+    std::vector<int> ij;    // Horizontal index i + j*icells of the active columns, sorted by j and i.
+    std::vector<int> kbot;  // First active level of each column.
+    std::vector<int> ktop;  // One past the last active level of each column.
+    std::vector<int> jbeg;  // The columns in xz slice j are jbeg[j] <= n < jbeg[j+1].
+
+    int kmin = 0;           // Lowest active level over all columns.
+    int kmax = 0;           // One past the highest active level over all columns.
+
+    int size() const { return static_cast<int>(ij.size()); }
+    bool has_slice(const int j) const { return jbeg[j+1] > jbeg[j]; }
+
+    void init(const int icells, const int jcells, const int ijcells)
+    {
+        ij.reserve(ijcells);
+        kbot.reserve(ijcells);
+        ktop.reserve(ijcells);
+        jbeg.resize(jcells+1);
+        kbot_ij.resize(ijcells);
+        ktop_ij.resize(ijcells);
+    }
+
+    // Mark a cell as active if any of the fields exceeds its threshold.
+    template<typename TF>
+    void build(
+            std::initializer_list<std::pair<const TF*, TF>> flds,
+            const int istart, const int jstart, const int kstart,
+            const int iend,   const int jend,   const int kend,
+            const int icells, const int ijcells)
+    {
+        ij.clear();
+        kbot.clear();
+        ktop.clear();
+
+        kmin = kend;
+        kmax = kstart;
+
+        std::fill(kbot_ij.begin(), kbot_ij.end(), kend);
+        std::fill(ktop_ij.begin(), ktop_ij.end(), kstart);
+
+        // Find the vertical extent of the active cells per column, sweeping
+        // through the fields in memory order.
+        for (auto& f : flds)
+            for (int k=kstart; k<kend; ++k)
+                for (int j=jstart; j<jend; ++j)
+                    #pragma omp simd
+                    for (int i=istart; i<iend; ++i)
+                    {
+                        const int ij  = i + j*icells;
+                        const int ijk = i + j*icells + k*ijcells;
+                        const bool active = (f.first[ijk] > f.second);
+
+                        kbot_ij[ij] = (active && k < kbot_ij[ij]) ? k : kbot_ij[ij];
+                        ktop_ij[ij] = (active && k >= ktop_ij[ij]) ? k+1 : ktop_ij[ij];
+                    }
+
+        // Store the active columns.
+        std::fill(jbeg.begin(), jbeg.begin()+jstart+1, 0);
+
+        for (int j=jstart; j<jend; ++j)
+        {
+            for (int i=istart; i<iend; ++i)
+            {
+                const int ij = i + j*icells;
+
+                if (ktop_ij[ij] > kbot_ij[ij])
+                {
+                    this->ij.push_back(ij);
+                    kbot.push_back(kbot_ij[ij]);
+                    ktop.push_back(ktop_ij[ij]);
+
+                    kmin = std::min(kmin, kbot_ij[ij]);
+                    kmax = std::max(kmax, ktop_ij[ij]);
+                }
+            }
+
+            jbeg[j+1] = size();
+        }
+
+        std::fill(jbeg.begin()+jend+1, jbeg.end(), size());
+    }
+
+    // Set the index to the union of two indices.
+    void merge(const Microphys_active_columns& a, const Microphys_active_columns& b)
+    {
+        ij.clear();
+        kbot.clear();
+        ktop.clear();
+
+        kmin = std::min(a.kmin, b.kmin);
+        kmax = std::max(a.kmax, b.kmax);
+
+        auto push = [&](const int ijn, const int kbotn, const int ktopn)
+        {
+            ij.push_back(ijn);
+            kbot.push_back(kbotn);
+            ktop.push_back(ktopn);
+        };
+
+        jbeg[0] = 0;
+
+        for (int j=0; j<static_cast<int>(jbeg.size())-1; ++j)
+        {
+            int na = a.jbeg[j];
+            int nb = b.jbeg[j];
+
+            // Both lists are sorted by ij within a slice.
+            while (na < a.jbeg[j+1] || nb < b.jbeg[j+1])
+            {
+                if (nb == b.jbeg[j+1] || (na < a.jbeg[j+1] && a.ij[na] < b.ij[nb]))
+                {
+                    push(a.ij[na], a.kbot[na], a.ktop[na]);
+                    ++na;
+                }
+                else if (na == a.jbeg[j+1] || b.ij[nb] < a.ij[na])
+                {
+                    push(b.ij[nb], b.kbot[nb], b.ktop[nb]);
+                    ++nb;
+                }
+                else
+                {
+                    push(a.ij[na], std::min(a.kbot[na], b.kbot[nb]), std::max(a.ktop[na], b.ktop[nb]));
+                    ++na;
+                    ++nb;
+                }
+            }
+
+            jbeg[j+1] = size();
+        }
+    }
+
+    private:
+        std::vector<int> kbot_ij;
+        std::vector<int> ktop_ij;
+};
+#endif
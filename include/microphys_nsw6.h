@@ -34,6 +34,7 @@
 
 #include "microphys.h"
 #include "field3d_operators.h"
+#include "microphys_active_columns.h"
 
 class Master;
 class Input;
@@ -90,6 +91,7 @@ class Microphys_nsw6 : public Microphys<TF>
 
         bool swmicrobudget;     // Output full microphysics budget terms
         double cflmax;          // Max CFL number in microphysics sedimentation
+        Sedimentation_type swsedimentation; // Sedimentation scheme
 
         std::vector<std::string> crosslist; // Cross-sections handled by this class
 
@@ -103,6 +105,8 @@ class Microphys_nsw6 : public Microphys<TF>
         std::vector<TF> rs_bot; // Snow rate at the bottom.
         std::vector<TF> rg_bot; // Graupel rate at the bottom.
 
+        Microphys_active_columns active_columns; // Columns with hydrometeors, rebuilt every call to exec.
+
         #ifdef USECUDA
         TF* rr_bot_g;
         TF* rs_bot_g;
@@ -0,0 +1,122 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MICROPHYS_SEDI_REMAP_H
+#define MICROPHYS_SEDI_REMAP_H
+
+#include <cmath>
+#include <algorithm>
+
+#include "defines.h"
+
+// Unconditionally stable sedimentation by Lagrangian remapping. Every grid cell is
+// shifted down over its fall distance w*dt, and its content is redistributed over
+// the grid levels that the displaced cell overlaps, or removed through the surface.
+// The scheme is conservative and positive definite for any sedimentation CFL number,
+// so it does not impose a time step limit.
+namespace Micro_sedimentation_remap
+{
+    template<typename TF>
+    inline TF minmod(const TF a, const TF b)
+    {
+        return (a*b <= TF(0.)) ? TF(0.) : ((std::abs(a) < std::abs(b)) ? a : b);
+    }
+
+    // Mass between the relative heights za and zb (-1/2 <= za <= zb <= 1/2) of a cell
+    // with total mass m, using a linear profile with relative slope s over the cell.
+    template<typename TF>
+    inline TF segment_mass(const TF m, const TF s, const TF za, const TF zb)
+    {
+        return m * ((zb - za) + TF(0.5)*s*(zb*zb - za*za));
+    }
+
+    // Remap a single column and add the sedimentation tendency to qt.
+    // Pointers q, qt and w point to level 0 of the column, with strides kk and kk_w.
+    // Returns the surface flux (e.g. kg m-2 s-1 for a specific humidity).
+    template<typename TF>
+    TF remap_column(
+            TF* const restrict qt, TF* const restrict mass_new,
+            const TF* const restrict q, const TF* const restrict w,
+            const TF* const restrict rho, const TF* const restrict dz,
+            const TF* const restrict dzi, const TF* const restrict zh,
+            const TF dt, const int kstart, const int kend,
+            const int kk, const int kk_w)
+    {
+        for (int k=kstart; k<kend; ++k)
+            mass_new[k] = TF(0.);
+
+        TF mass_sfc = TF(0.);
+
+        for (int k=kstart; k<kend; ++k)
+        {
+            const TF mass = rho[k] * q[k*kk] * dz[k];
+            const TF dz_fall = w[k*kk_w] * dt;
+
+            if (mass <= TF(0.))
+                continue;
+
+            if (dz_fall <= TF(0.))
+            {
+                mass_new[k] += mass;
+                continue;
+            }
+
+            // Limited linear profile inside the cell, relative to the cell mean.
+            const TF slope = minmod(q[k*kk] - q[(k-1)*kk], q[(k+1)*kk] - q[k*kk]) / q[k*kk];
+
+            // Bottom and top of the displaced cell.
+            const TF zbot = zh[k  ] - dz_fall;
+            const TF ztop = zh[k+1] - dz_fall;
+
+            // Distribute the mass over the levels that the displaced cell overlaps.
+            TF mass_left = mass;
+            int klow = k;
+            for (int kn=k; kn>=kstart && zh[kn+1]>zbot; --kn)
+            {
+                klow = kn;
+
+                const TF za = (std::max(zbot, zh[kn  ]) - zbot) * dzi[k] - TF(0.5);
+                const TF zb = (std::min(ztop, zh[kn+1]) - zbot) * dzi[k] - TF(0.5);
+
+                if (zb > za)
+                {
+                    const TF dmass = std::min(mass_left, segment_mass(mass, slope, za, zb));
+                    mass_new[kn] += dmass;
+                    mass_left -= dmass;
+                }
+            }
+
+            // What is left has fallen through the surface, or is round-off error that is
+            // assigned to the lowest level reached. This keeps the scheme exactly conservative.
+            if (zbot < zh[kstart])
+                mass_sfc += mass_left;
+            else
+                mass_new[klow] += mass_left;
+        }
+
+        for (int k=kstart; k<kend; ++k)
+            qt[k*kk] += (mass_new[k] / (rho[k]*dz[k]) - q[k*kk]) / dt;
+
+        return mass_sfc / dt;
+    }
+}
+#endif
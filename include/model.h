@@ -57,6 +57,7 @@ template<typename> class Source;
 
 template<typename> class Stats;
 template<typename> class Budget;
+template<typename> class Spectra;
 template<typename> class Column;
 template<typename> class Cross;
 template<typename> class Dump;
@@ -109,6 +110,7 @@ class Model
 
         std::shared_ptr<Stats<TF>> stats;
         std::shared_ptr<Budget<TF>> budget;
+        std::shared_ptr<Spectra<TF>> spectra;
         std::shared_ptr<Column<TF>> column;
         std::shared_ptr<Cross<TF>> cross;
         std::shared_ptr<Dump<TF>> dump;
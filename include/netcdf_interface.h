@@ -56,6 +56,8 @@ class Netcdf_variable
         void add_attribute(const std::string&, const double);
         void add_attribute(const std::string&, const float);
 
+        void set_chunking(const std::vector<int>&, const int deflate_level=0);
+
     private:
         Master& master;
         Netcdf_handle& nc_handle;
@@ -137,6 +139,11 @@ class Netcdf_handle
                 const float,
                 const int);
 
+        void set_chunking(
+                const int,
+                const std::vector<int>&,
+                const int);
+
         virtual int get_dim_id(const std::string&) = 0;
 
     protected:
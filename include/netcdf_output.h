@@ -0,0 +1,71 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETCDF_OUTPUT_H
+#define NETCDF_OUTPUT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "netcdf_interface.h"
+
+class Master;
+class Input;
+
+// A NetCDF file with a single output variable along an unlimited time dimension.
+template<typename TF>
+struct Netcdf_output_file
+{
+    std::unique_ptr<Netcdf_file> file;
+    std::unique_ptr<Netcdf_variable<double>> time_var;
+    std::unique_ptr<Netcdf_variable<TF>> var;
+    int record = -1;  ///< Index of the time record that is written.
+    int iotime = -1;  ///< Output time of the current record.
+};
+
+// Manages the NetCDF files of the cross-sections and dumps, one file per variable and orientation.
+template<typename TF>
+class Netcdf_output
+{
+    public:
+        using Dimension = std::pair<std::string, std::vector<TF>>;
+
+        Netcdf_output(Master&, Input&);
+
+        // Returns the file, created on first use, with its record set to the given output time.
+        Netcdf_output_file<TF>& get_file(
+                const std::string&, const std::string&, const int,
+                const std::vector<Dimension>&, const std::vector<int>&, const int deflate_level=0);
+
+        // Returns the global coordinates without ghost cells at the full or half positions of an equidistant grid.
+        static std::vector<TF> get_global_coordinates(const int, const TF, const bool);
+
+    private:
+        Master& master;
+        int iotimeprec;
+
+        std::map<std::string, Netcdf_output_file<TF>> files;
+};
+#endif
@@ -165,7 +165,7 @@ class Radiation_rrtmgp : public Radiation<TF>
                 Array<Float,2>&, Array<Float,2>&, Array<Float,2>&,
                 const Array<Float,2>&, const Array<Float,2>&, const Array<Float,1>&,
                 const Array<Float,2>&, const Array<Float,2>&, const Array<Float,2>&,
-                const bool, const int);
+                const bool, const int, const bool sample_gpt=false);
 
         void exec_shortwave(
                 Thermo<TF>&, Microphys<TF>&, Timeloop<TF>&, Stats<TF>&,
@@ -174,7 +174,7 @@ class Radiation_rrtmgp : public Radiation<TF>
                 const Array<Float,2>&, const Array<Float,2>&,
                 const Array<Float,2>&, const Array<Float,2>&,
                 const Array<Float,2>&, const Array<Float,2>&,
-                const bool, const int);
+                const bool, const int, const bool sample_gpt=false);
 
         #ifdef USECUDA
         void exec_longwave(
@@ -225,6 +225,24 @@ class Radiation_rrtmgp : public Radiation<TF>
         double dt_rad;
         unsigned long idt_rad;
 
+        int n_col_block; // Number of columns per block in the CPU solver.
+        int n_threads;   // Number of OpenMP threads that solve the blocks of the CPU solver.
+
+        // Coarse radiation: one radiation column per n_coarse x n_coarse block of columns.
+        std::string swcoarse; // "0", "mean" (block-averaged profiles) or "random" (one random column).
+        int n_coarse;
+
+        // Stochastic spectral sampling: the solver uses only a subset of the g-points of every band.
+        std::string swgptsample; // "0", "random" or "rotate".
+        int gpt_sample_factor;   // Number of g-points per band divided by the number of sampled g-points.
+        unsigned long gpt_sample_call; // Index of the radiation call that selects the sample.
+
+        // Bias and rms error of the sampled net fluxes with respect to the full spectrum.
+        std::vector<Float> lw_gpt_bias;
+        std::vector<Float> lw_gpt_rmse;
+        std::vector<Float> sw_gpt_bias;
+        std::vector<Float> sw_gpt_rmse;
+
         std::vector<std::string> crosslist;
 
         // RRTMGP related variables.
@@ -0,0 +1,77 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SPECTRA_H
+#define SPECTRA_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+class Master;
+class Input;
+template<typename> class Grid;
+template<typename> class Fields;
+template<typename> class FFT;
+template<typename> class Stats;
+
+/**
+ * Class for the computation of horizontal power spectra and cospectra during the run.
+ * The fields are transformed with the FFT of the pressure solver, and the spectral power
+ * is binned over the radial wavenumber at a set of heights. The spectra are written into
+ * the statistics files.
+ */
+template<typename TF>
+class Spectra
+{
+    public:
+        Spectra(Master&, Grid<TF>&, Fields<TF>&, FFT<TF>&, Stats<TF>&, Input&);
+        ~Spectra();
+
+        void init();
+        void create(Stats<TF>&);
+        void exec_stats(Stats<TF>&);
+
+    private:
+        Master& master;
+        Grid<TF>& grid;
+        Fields<TF>& fields;
+        FFT<TF>& fft;
+
+        bool swspectra;
+
+        std::vector<std::string> spectralist; ///< Variables of which the power spectrum is computed.
+        std::vector<std::pair<std::string, std::string>> cospectralist; ///< Pairs of variables for the cospectra.
+        std::vector<TF> zspectra; ///< Requested heights of the spectra.
+
+        std::vector<int> kspec;  ///< Full level indices of the requested heights.
+        std::vector<int> kspech; ///< Half level indices of the requested heights.
+
+        int nbins;   ///< Number of radial wavenumber bins.
+        TF dk;       ///< Width of the radial wavenumber bins.
+        std::vector<int> bin_index; ///< Radial bin of each local spectral coefficient, -1 for the mean.
+        std::vector<TF> bin_weight; ///< Weight of each local spectral coefficient in its bin.
+
+        void calc_spectrum(std::vector<TF>&, const std::string&, const std::string&);
+};
+#endif
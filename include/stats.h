@@ -24,6 +24,7 @@
 #define STATS_H
 
 #include <regex>
+#include <cstdint>
 #include "boundary_cyclic.h"
 
 class Master;
@@ -49,6 +50,14 @@ struct Prof_var
     Netcdf_variable<TF> ncvar;
     std::vector<TF> data;
     Level_type level;
+
+    // Accumulators for time averaged statistics.
+    std::vector<double> sum;
+    std::vector<double> sum2;
+    std::vector<int> nsamples;
+
+    std::unique_ptr<Netcdf_variable<TF>> ncvar_tvar;
+    std::vector<TF> data_tvar;
 };
 
 // Struct for time series
@@ -57,6 +66,27 @@ struct Time_series_var
 {
     Netcdf_variable<TF> ncvar;
     TF data;
+
+    // Accumulators for time averaged statistics.
+    double sum = 0.;
+    double sum2 = 0.;
+    int nsamples = 0;
+
+    std::unique_ptr<Netcdf_variable<TF>> ncvar_tvar;
+    TF data_tvar = 0.;
+};
+
+// Struct for multi-dimensional statistics (e.g. spectra), the first dimension is time.
+template<typename TF>
+struct Array_var
+{
+    Netcdf_variable<TF> ncvar;
+    std::vector<TF> data;
+    std::vector<int> dim_sizes;
+
+    // Accumulators for time averaged statistics.
+    std::vector<double> sum;
+    std::vector<int> nsamples;
 };
 
 // Typedefs for containers of profiles and time series
@@ -66,6 +96,9 @@ using Prof_map = std::map<std::string, Prof_var<TF>>;
 template<typename TF>
 using Time_series_map = std::map<std::string, Time_series_var<TF>>;
 
+template<typename TF>
+using Array_map = std::map<std::string, Array_var<TF>>;
+
 // structure
 template<typename TF>
 struct Mask
@@ -77,6 +110,9 @@ struct Mask
     std::vector<int> nmaskh;
     int nmask_bot;
 
+    std::vector<uint64_t> bits;  // Bit-packed mask at full levels, one bit per grid point along i.
+    std::vector<uint64_t> bitsh; // Bit-packed mask at half levels.
+
     std::unique_ptr<Netcdf_file> data_file;
     std::unique_ptr<Netcdf_variable<int>> iter_var;
     std::unique_ptr<Netcdf_variable<TF>> time_var;
@@ -84,6 +120,7 @@ struct Mask
     Prof_map<TF> soil_profs;
     Prof_map<TF> background_profs;
     Time_series_map<TF> tseries;
+    Array_map<TF> arrays;
 };
 
 template<typename TF>
@@ -116,6 +153,10 @@ class Stats
 
         void exec(const int, const double, const unsigned long);
 
+        // Query functions to skip the computation of fields without requested statistics.
+        bool is_needed(const std::string&);
+        bool is_any_needed(const std::vector<std::string>&);
+
         // Interface functions.
         void add_dimension(const std::string&, const int);
         void add_mask(const std::string&);
@@ -146,6 +187,11 @@ class Stats
                 const std::string&, const std::string&,
                 const std::string&, const std::string&, Stats_whitelist_type=Stats_whitelist_type::Default);
 
+        void add_array(
+                const std::string&, const std::string&,
+                const std::string&, const std::vector<std::string>&, const std::string&,
+                Stats_whitelist_type=Stats_whitelist_type::Default);
+
         void calc_mask_stats(
                 std::pair<const std::string, Mask<TF>>&,
                 const std::string&, const Field3d<TF>&, const TF, const TF);
@@ -174,6 +220,8 @@ class Stats
         void set_prof(const std::string&, const std::vector<TF>&);
         void set_prof_background(const std::string&, const std::vector<TF>&);
         void set_time_series(const std::string&, const TF);
+        void set_array(const std::string&, const std::vector<TF>&);
+        void calc_histograms();
 
         Mask_map<TF>& get_masks() { return masks; }
 
@@ -195,6 +243,7 @@ class Stats
         std::vector<std::string> varlist;
         std::vector<std::string> varlist_soil;
         std::vector<std::string> varlist_background;
+        std::vector<std::string> varlist_array;
         
         void add_operation(std::vector<std::string>&, const std::string&, const std::string&);
         void sanitize_operations_vector(const std::string&, std::vector<std::string>&);
@@ -204,6 +253,26 @@ class Stats
         double sampletime;
         unsigned long isampletime;
 
+        bool swtimeavg;         ///< Average the samples in time and only write the averages
+        bool swtimevar;         ///< Write the temporal variance of the samples next to the averages
+        double avgtime;         ///< Length of the averaging window [s]
+        unsigned long iavgtime;
+
+        // Histograms of one variable, or joint histograms of two variables, at each height.
+        struct Histogram
+        {
+            std::string name;
+            std::string var1;
+            std::string var2; ///< Empty for histograms of a single variable.
+        };
+
+        std::vector<Histogram> histograms;
+        std::map<std::string, std::pair<TF, TF>> hist_range; ///< Range of the bins per variable.
+        int histbins;    ///< Number of bins per variable.
+        bool swhistmask; ///< Compute the histograms for each mask instead of only for the domain.
+
+        void create_histograms();
+
         // Container for all stats, masks as uppermost in hierarchy
         Mask_map<TF> masks;
         std::vector<std::string> masklist;
@@ -0,0 +1,77 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_FUNCTIONS_H
+#define STATS_FUNCTIONS_H
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <netcdf.h>
+
+namespace Stats_functions
+{
+    // Help function(s) to switch between the different NetCDF data types
+    template<typename TF> TF netcdf_fp_fillvalue();
+    template<> inline double netcdf_fp_fillvalue<double>() { return NC_FILL_DOUBLE; }
+    template<> inline float  netcdf_fp_fillvalue<float>()  { return NC_FILL_FLOAT; }
+
+    template<typename TF>
+    bool is_valid_sample(const TF value)
+    {
+        return std::isfinite(value) && (value != netcdf_fp_fillvalue<TF>());
+    }
+
+    // Add one sample of a multi-dimensional statistic to the time average. Elements that hold
+    // a fill value, for instance histogram levels with an empty mask, do not count as a sample.
+    template<typename TF>
+    void accumulate_samples(std::vector<double>& sum, std::vector<int>& nsamples, const std::vector<TF>& data)
+    {
+        if (nsamples.empty())
+        {
+            sum.assign(data.size(), 0.);
+            nsamples.assign(data.size(), 0);
+        }
+
+        for (size_t n=0; n<data.size(); ++n)
+        {
+            if (is_valid_sample(data[n]))
+            {
+                sum[n] += data[n];
+                ++nsamples[n];
+            }
+        }
+    }
+
+    // Replace the data by its time average and reset the accumulators. Elements without
+    // a single valid sample in the averaging window get the fill value.
+    template<typename TF>
+    void average_samples(std::vector<TF>& data, std::vector<double>& sum, std::vector<int>& nsamples)
+    {
+        for (size_t n=0; n<data.size(); ++n)
+            data[n] = (n < nsamples.size() && nsamples[n] > 0) ? sum[n] / nsamples[n] : netcdf_fp_fillvalue<TF>();
+
+        std::fill(sum.begin(), sum.end(), 0.);
+        std::fill(nsamples.begin(), nsamples.end(), 0);
+    }
+}
+#endif
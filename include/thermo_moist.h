@@ -185,6 +185,31 @@ class Thermo_moist : public Thermo<TF>
         Background_state bs;
         Background_state bs_stats;
 
+        // Cache of the saturation adjustment at the full levels, valid for one (sub)step.
+        struct Sat_adjust_cache
+        {
+            bool swcache;
+            bool swfloat;    ///< Store the cached fields in single precision.
+            bool is_valid;
+            TF maxmem;       ///< Maximum memory of the cache per process [MB].
+
+            std::vector<TF> pref;           ///< Pressure profile the cache is computed with.
+            std::vector<TF> fld;            ///< ql, qi, T and qs, each of size ncells.
+            std::vector<float> fld_float;   ///< Same as `fld`, in single precision.
+        };
+
+        mutable Sat_adjust_cache satcache;
+
+        void update_satcache(const std::vector<TF>&) const;
+
+        template<typename TC>
+        void get_thermo_field_cached(Field3d<TF>&, const std::string&, const std::vector<TC>&);
+
+        template<typename TC>
+        void get_radiation_fields_cached(
+                Field3d<TF>&, Field3d<TF>&, Field3d<TF>&, TF*, Field3d<TF>&, Field3d<TF>&,
+                const std::vector<TC>&) const;
+
         std::unique_ptr<Timedep<TF>> tdep_pbot;
         const std::string tend_name = "buoy";
         const std::string tend_longname = "Buoyancy";
@@ -33,6 +33,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <utility>
 
 #include "constants.h"
 #include "fast_math.h"
@@ -83,7 +86,7 @@ namespace Thermo_moist_functions
     // Saturation vapor pressure, using Taylor expansion at T=T0 around the Arden Buck (1981) equation:
     // es = 611.21 * exp(17.502 * Tc / (240.97 + Tc)), with Tc=T-T0
     template<typename TF>
-    CUDA_MACRO inline TF esat_liq(const TF T)
+    CUDA_MACRO inline TF esat_liq_analytic(const TF T)
     {
         #ifdef __CUDACC__
         const TF x = fmax(TF(-75.), T-T0<TF>);
@@ -95,16 +98,10 @@ namespace Thermo_moist_functions
         return c00<TF>+x*(c10<TF>+x*(c20<TF>+x*(c30<TF>+x*(c40<TF>+x*(c50<TF>+x*(c60<TF>+x*(c70<TF>+x*(c80<TF>+x*(c90<TF>+x*c100<TF>)))))))));
     }
 
-    template<typename TF>
-    CUDA_MACRO inline TF qsat_liq(const TF p, const TF T)
-    {
-        return ep<TF>*esat_liq(T)/(p-(TF(1.)-ep<TF>)*esat_liq(T));
-    }
-
     // Saturation vapor pressure over ice, Arden Buck (1981) equation:
     // es = 611.15 * exp(22.452 * Tc / (272.55 + Tc)), with Tc=T-T0
     template<typename TF>
-    CUDA_MACRO inline TF esat_ice(const TF T)
+    CUDA_MACRO inline TF esat_ice_analytic(const TF T)
     {
         #ifdef __CUDACC__
         const TF x = fmax(TF(-100.), T-T0<TF>);
@@ -115,6 +112,96 @@ namespace Thermo_moist_functions
         return TF(611.15)*std::exp(TF(22.452)*x / (TF(272.55)+x));
     }
 
+    #ifdef ESAT_TABLE
+    // Lookup tables of the saturation vapor pressure over liquid and ice, filled with the
+    // analytic functions at program start. The tables run from the lower clipping limit of
+    // `esat_ice_analytic()` up to 373.15 K, with a spacing of 0.02 K and linear interpolation.
+    // Temperatures outside of the table are clipped to its range.
+    template<typename TF>
+    struct Esat_table
+    {
+        static constexpr TF T_min = TF(173.15);
+        static constexpr TF T_max = TF(373.15);
+        static constexpr TF dT = TF(0.02);
+        static constexpr int n = 10001;
+
+        std::vector<TF> es_liq;
+        std::vector<TF> es_ice;
+
+        // The tables are always filled in double precision, which avoids the
+        // cancellation errors of the single precision polynomial at low T.
+        Esat_table() : es_liq(n), es_ice(n)
+        {
+            for (int i=0; i<n; ++i)
+            {
+                const double T = double(T_min) + i*double(dT);
+                es_liq[i] = static_cast<TF>(esat_liq_analytic(T));
+                es_ice[i] = static_cast<TF>(esat_ice_analytic(T));
+            }
+        }
+
+        inline TF interpolate(const TF* const restrict es, const TF T) const
+        {
+            const TF x = (std::min(std::max(T, T_min), T_max) - T_min) * (TF(1.)/dT);
+            const int i = std::min(static_cast<int>(x), n-2);
+            const TF f = x - i;
+            return (TF(1.)-f)*es[i] + f*es[i+1];
+        }
+    };
+
+    template<typename TF>
+    inline const Esat_table<TF> esat_table;
+
+    // Maximum relative error of the tables with respect to the analytic functions in double
+    // precision, sampled halfway between the table points where the interpolation error peaks.
+    template<typename TF>
+    inline std::pair<double, double> esat_table_max_error()
+    {
+        const Esat_table<TF>& tab = esat_table<TF>;
+
+        double err_liq = 0.;
+        double err_ice = 0.;
+
+        for (int i=0; i<tab.n-1; ++i)
+        {
+            const double T = double(tab.T_min) + (i + 0.5)*double(tab.dT);
+            const double es_liq = esat_liq_analytic(T);
+            const double es_ice = esat_ice_analytic(T);
+
+            err_liq = std::max(err_liq, std::abs(tab.interpolate(tab.es_liq.data(), TF(T)) - es_liq) / es_liq);
+            err_ice = std::max(err_ice, std::abs(tab.interpolate(tab.es_ice.data(), TF(T)) - es_ice) / es_ice);
+        }
+
+        return std::make_pair(err_liq, err_ice);
+    }
+    #endif
+
+    template<typename TF>
+    CUDA_MACRO inline TF esat_liq(const TF T)
+    {
+        #if defined(ESAT_TABLE) && !defined(__CUDA_ARCH__)
+        return esat_table<TF>.interpolate(esat_table<TF>.es_liq.data(), T);
+        #else
+        return esat_liq_analytic(T);
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF esat_ice(const TF T)
+    {
+        #if defined(ESAT_TABLE) && !defined(__CUDA_ARCH__)
+        return esat_table<TF>.interpolate(esat_table<TF>.es_ice.data(), T);
+        #else
+        return esat_ice_analytic(T);
+        #endif
+    }
+
+    template<typename TF>
+    CUDA_MACRO inline TF qsat_liq(const TF p, const TF T)
+    {
+        return ep<TF>*esat_liq(T)/(p-(TF(1.)-ep<TF>)*esat_liq(T));
+    }
+
     template<typename TF>
     CUDA_MACRO inline TF qsat_ice(const TF p, const TF T)
     {
@@ -290,6 +377,178 @@ namespace Thermo_moist_functions
         return ans;
     }
 
+    // Single Newton step of the saturation adjustment for liquid only (`tl >= T0`).
+    template<typename TF>
+    inline TF sat_adjust_newton_step_liq(const TF tnr, const TF tl, const TF qt, const TF p)
+    {
+        const TF es_w = esat_liq(tnr);
+        const TF den_w = p - (TF(1.) - ep<TF>)*es_w;
+        const TF qs_w = ep<TF>*es_w/den_w;
+        const TF dqsatdT_w = (ep<TF>/den_w + (TF(1.) - ep<TF>)*ep<TF>*es_w/pow2(den_w)) * Lv<TF>*es_w / (Rv<TF>*pow2(tnr));
+
+        const TF f = tnr - tl - Lv<TF>/cp<TF>*(qt - qs_w);
+        const TF f_prime = TF(1.) + Lv<TF>/cp<TF>*dqsatdT_w;
+
+        return tnr - f / f_prime;
+    }
+
+    // Single Newton step of the saturation adjustment, without branches. In the warm
+    // regime (`tl >= T0`) only liquid is formed, as in `sat_adjust()`.
+    template<typename TF>
+    inline TF sat_adjust_newton_step(const TF tnr, const TF tl, const TF qt, const TF p)
+    {
+        const bool is_warm = tl >= T0<TF>;
+        const TF alpha_w = is_warm ? TF(1.) : water_fraction(tnr);
+        const TF alpha_i = TF(1.) - alpha_w;
+        const TF dalphadT = (alpha_w > TF(0.) && alpha_w < TF(1.)) ? TF(0.025) : TF(0.);
+
+        const TF es_w = esat_liq(tnr);
+        const TF es_i = esat_ice(tnr);
+        const TF den_w = p - (TF(1.) - ep<TF>)*es_w;
+        const TF den_i = p - (TF(1.) - ep<TF>)*es_i;
+        const TF qs_w = ep<TF>*es_w/den_w;
+        const TF qs_i = ep<TF>*es_i/den_i;
+        const TF qs = alpha_w*qs_w + alpha_i*qs_i;
+
+        const TF dqsatdT_w = (ep<TF>/den_w + (TF(1.) - ep<TF>)*ep<TF>*es_w/pow2(den_w)) * Lv<TF>*es_w / (Rv<TF>*pow2(tnr));
+        const TF dqsatdT_i = (ep<TF>/den_i + (TF(1.) - ep<TF>)*ep<TF>*es_i/pow2(den_i)) * Ls<TF>*es_i / (Rv<TF>*pow2(tnr));
+
+        const TF L_eff = alpha_w*Lv<TF> + alpha_i*Ls<TF>;
+
+        const TF f = tnr - tl - L_eff/cp<TF>*(qt - qs);
+        const TF f_prime = TF(1.)
+            - dalphadT*(Lv<TF> - Ls<TF>)/cp<TF>*(qt - qs)
+            + alpha_w*Lv<TF>/cp<TF>*dqsatdT_w
+            + alpha_i*Ls<TF>/cp<TF>*dqsatdT_i;
+
+        return tnr - f / f_prime;
+    }
+
+    // Row version of `sat_adjust()` for `n` consecutive cells at the same pressure `p`.
+    // The cells are processed in chunks: the unsaturated solution is computed for all
+    // cells, after which the saturated cells are compacted into an index list and solved
+    // with a fixed number of branchless Newton steps that vectorize. The (rare) cells that
+    // have not converged by then are passed to `sat_adjust()`. Output arrays that are a
+    // nullptr are not written, and they can be of a different precision (TO) than TF.
+    template<typename TF, typename TO>
+    inline void sat_adjust_row(
+            TO* const restrict ql, TO* const restrict qi, TO* const restrict t, TO* const restrict qs,
+            const TF* const restrict thl, const TF* const restrict qt,
+            const TF p, const TF exn, const int n)
+    {
+        constexpr int nchunk = 256;
+        constexpr int niter = 4;
+
+        int idx[nchunk];
+        TF ql_c[nchunk], qi_c[nchunk], t_c[nchunk], qs_c[nchunk];
+        TF tl_s[nchunk], qt_s[nchunk], tnr_s[nchunk], dtnr_s[nchunk];
+
+        for (int i0=0; i0<n; i0+=nchunk)
+        {
+            const int nc = std::min(nchunk, n-i0);
+            int nsat = 0;
+            int ncold = 0;
+
+            #pragma omp simd
+            for (int i=0; i<nc; ++i)
+            {
+                const TF tl = thl[i0+i] * exn;
+                ql_c[i] = TF(0.);
+                qi_c[i] = TF(0.);
+                t_c [i] = tl;
+                qs_c[i] = qsat_liq(p, tl);
+            }
+
+            // Compact the saturated cells, without branches.
+            for (int i=0; i<nc; ++i)
+            {
+                const bool is_sat = qt[i0+i] - qs_c[i] > TF(0.);
+                idx[nsat] = i;
+                nsat += is_sat;
+                ncold += is_sat && (t_c[i] < T0<TF>);
+            }
+
+            if (nsat > 0)
+            {
+                for (int s=0; s<nsat; ++s)
+                {
+                    tl_s[s]  = t_c[idx[s]];
+                    qt_s[s]  = qt[i0+idx[s]];
+                    tnr_s[s] = tl_s[s];
+                }
+
+                // Skip the ice computations if all saturated cells of the chunk are warm.
+                for (int it=0; it<niter; ++it)
+                {
+                    if (ncold == 0)
+                    {
+                        #pragma omp simd
+                        for (int s=0; s<nsat; ++s)
+                        {
+                            const TF tnr_new = sat_adjust_newton_step_liq(tnr_s[s], tl_s[s], qt_s[s], p);
+                            dtnr_s[s] = std::fabs(tnr_new - tnr_s[s]) / tnr_s[s];
+                            tnr_s[s] = tnr_new;
+                        }
+                    }
+                    else
+                    {
+                        #pragma omp simd
+                        for (int s=0; s<nsat; ++s)
+                        {
+                            const TF tnr_new = sat_adjust_newton_step(tnr_s[s], tl_s[s], qt_s[s], p);
+                            dtnr_s[s] = std::fabs(tnr_new - tnr_s[s]) / tnr_s[s];
+                            tnr_s[s] = tnr_new;
+                        }
+                    }
+                }
+
+                #pragma omp simd
+                for (int s=0; s<nsat; ++s)
+                {
+                    const TF tnr = tnr_s[s];
+                    const TF alpha_w = (tl_s[s] >= T0<TF>) ? TF(1.) : water_fraction(tnr);
+                    const TF alpha_i = TF(1.) - alpha_w;
+                    const TF qs_w = qsat_liq(p, tnr);
+                    const TF qs_i = qsat_ice(p, tnr);
+                    const TF qsat_s = alpha_w*qs_w + alpha_i*qs_i;
+                    const TF qlqi = std::max(TF(0.), qt_s[s] - qsat_s);
+
+                    // Scatter, indices are unique.
+                    const int i = idx[s];
+                    ql_c[i] = alpha_w*qlqi;
+                    qi_c[i] = alpha_i*qlqi;
+                    t_c [i] = tnr;
+                    qs_c[i] = qsat_s;
+                }
+
+                // Fall back on the iterative solver for cells that did not converge.
+                for (int s=0; s<nsat; ++s)
+                    if (dtnr_s[s] > TF(1.e-5))
+                    {
+                        const int i = idx[s];
+                        const Struct_sat_adjust<TF> ssa = sat_adjust(thl[i0+i], qt[i0+i], p, exn);
+                        ql_c[i] = ssa.ql;
+                        qi_c[i] = ssa.qi;
+                        t_c [i] = ssa.t;
+                        qs_c[i] = ssa.qs;
+                    }
+            }
+
+            if (ql != nullptr)
+                for (int i=0; i<nc; ++i)
+                    ql[i0+i] = static_cast<TO>(ql_c[i]);
+            if (qi != nullptr)
+                for (int i=0; i<nc; ++i)
+                    qi[i0+i] = static_cast<TO>(qi_c[i]);
+            if (t != nullptr)
+                for (int i=0; i<nc; ++i)
+                    t[i0+i] = static_cast<TO>(t_c[i]);
+            if (qs != nullptr)
+                for (int i=0; i<nc; ++i)
+                    qs[i0+i] = static_cast<TO>(qs_c[i]);
+        }
+    }
+
     template<typename TF>
     void calc_base_state(TF* restrict pref, TF* restrict prefh,
                          TF* restrict rho, TF* restrict rhoh,
@@ -0,0 +1,181 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Accuracy check and throughput benchmark of the vectorizable `Fast_math::exp()`, `log()`,
+ * `pow()`, `cbrt()` and `pow_two_thirds()` against libm, in double and single precision,
+ * including the propagation of NaN. Build and run with (optionally add -ffast-math):
+ *
+ *   g++ -std=c++17 -O3 -march=native -I../../include fast_math.cxx -o fast_math && ./fast_math
+ *
+ * The program returns a non-zero exit code if an error exceeds its tolerance.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "fast_math.h"
+
+namespace
+{
+    // Test on the bits, because -ffast-math removes `std::isnan()`.
+    bool is_nan(const double a)
+    {
+        std::uint64_t i;
+        std::memcpy(&i, &a, sizeof(double));
+        return (i & 0x7fffffffffffffffULL) > 0x7ff0000000000000ULL;
+    }
+
+    template<typename TF, typename F_fast, typename F_ref>
+    bool test(
+            const char* name, F_fast fast, F_ref ref,
+            const double lo, const double hi, const bool log_spaced, const double tol)
+    {
+        const int n = 1 << 20;
+        const int nrep = 10;
+
+        std::mt19937 gen(2);
+        std::uniform_real_distribution<double> dist(0., 1.);
+
+        std::vector<TF> x(n), a_ref(n), a_fast(n);
+        for (int i=0; i<n; ++i)
+        {
+            const double r = dist(gen);
+            x[i] = log_spaced
+                ? TF(std::exp(std::log(lo) + r*(std::log(hi) - std::log(lo))))
+                : TF(lo + r*(hi - lo));
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r=0; r<nrep; ++r)
+            for (int i=0; i<n; ++i)
+                a_ref[i] = ref(x[i]);
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (int r=0; r<nrep; ++r)
+            for (int i=0; i<n; ++i)
+                a_fast[i] = fast(x[i]);
+        auto t2 = std::chrono::steady_clock::now();
+
+        // Compare against the long double libm result, which is also accurate with -ffast-math.
+        double err = 0.;
+        for (int i=0; i<n; ++i)
+        {
+            const long double a = ref((long double)x[i]);
+            err = std::max(err, double(std::abs(a_fast[i] - a) / std::max(std::abs(a), 1e-300L)));
+        }
+
+        // NaN has to propagate, for both signs.
+        const TF nan = std::numeric_limits<TF>::quiet_NaN();
+        const bool nan_ok = is_nan(fast(nan)) && is_nan(fast(-nan));
+
+        const double time_ref  = std::chrono::duration<double, std::nano>(t1-t0).count() / (double(nrep)*n);
+        const double time_fast = std::chrono::duration<double, std::nano>(t2-t1).count() / (double(nrep)*n);
+
+        const bool pass = err <= tol && nan_ok;
+
+        std::printf("%-6s %-15s max rel err %.1e  NaN %-4s  libm %6.2f ns  fast %6.2f ns  speedup %4.1f  %s\n",
+                sizeof(TF) == 8 ? "double" : "float", name, err, nan_ok ? "OK" : "lost",
+                time_ref, time_fast, time_ref/time_fast, pass ? "OK" : "FAILED");
+
+        return pass;
+    }
+
+    template<typename TF>
+    int test_all(const double tol)
+    {
+        int nerror = 0;
+
+        nerror += !test<TF>(
+                "exp", [](TF x) { return Fast_math::exp(x); }, [](auto x) { return std::exp(x); },
+                -80., 80., false, tol);
+
+        nerror += !test<TF>(
+                "log", [](TF x) { return Fast_math::log(x); }, [](auto x) { return std::log(x); },
+                1e-30, 1e30, true, tol);
+
+        // The error of pow() grows with |y*log(x)|, the range covers the use in the microphysics.
+        nerror += !test<TF>(
+                "pow(x,-0.5)",
+                [](TF x) { return Fast_math::pow(x, TF(-0.5)); },
+                [](auto x) { return std::pow(x, decltype(x)(-0.5)); },
+                1e-3, 1e3, true, 4*tol);
+
+        nerror += !test<TF>(
+                "pow(x,0.68)",
+                [](TF x) { return Fast_math::pow(x, TF(0.68)); },
+                [](auto x) { return std::pow(x, decltype(x)(0.68)); },
+                1e-3, 1., true, 4*tol);
+
+        nerror += !test<TF>(
+                "pow(x,1.5)",
+                [](TF x) { return Fast_math::pow(x, TF(1.5)); },
+                [](auto x) { return std::pow(x, decltype(x)(1.5)); },
+                1., 1e3, true, 16*tol);
+
+        // Exponent that varies per call, as in the sedimentation velocities of the microphysics.
+        nerror += !test<TF>(
+                "pow(x,-(4+x))",
+                [](TF x) { return Fast_math::pow(TF(1.)+x, -(TF(4.)+x)); },
+                [](auto x) { return std::pow(decltype(x)(1.)+x, -(decltype(x)(4.)+x)); },
+                1e-2, 2., true, 16*tol);
+
+        nerror += !test<TF>(
+                "cbrt", [](TF x) { return Fast_math::cbrt(x); }, [](auto x) { return std::cbrt(x); },
+                -1e6, 1e6, false, 8*tol);
+
+        nerror += !test<TF>(
+                "pow_two_thirds",
+                [](TF x) { return Fast_math::pow_two_thirds(x); },
+                [](auto x) { return std::pow(x, decltype(x)(2.)/decltype(x)(3.)); },
+                1e-6, 1e3, true, 8*tol);
+
+        // NaN in the exponent of pow() propagates as well.
+        const TF nan = std::numeric_limits<TF>::quiet_NaN();
+        const bool nan_y_ok = is_nan(Fast_math::pow(TF(2.), nan)) && is_nan(Fast_math::pow(TF(-2.), nan));
+        std::printf("%-6s %-15s NaN %s\n", sizeof(TF) == 8 ? "double" : "float", "pow(x,NaN)", nan_y_ok ? "OK" : "lost");
+        nerror += !nan_y_ok;
+
+        return nerror;
+    }
+}
+
+int main()
+{
+    // With -ffast-math the compiler reassociates the range reduction, which costs about one digit.
+    #ifdef __FAST_MATH__
+    const double tol_factor = 10.;
+    #else
+    const double tol_factor = 1.;
+    #endif
+
+    int nerror = 0;
+    nerror += test_all<double>(tol_factor*5e-16);
+    nerror += test_all<float>(tol_factor*2.5e-7);
+
+    return nerror > 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Accuracy check and microbenchmark of the row-wise saturation adjustment `sat_adjust_row()`
+ * against the scalar `sat_adjust()`, for thermodynamic states of the cloud layers of the
+ * BOMEX, RICO and DYCOMS cases, and of a cold mixed-phase layer. Build and run with:
+ *
+ *   g++ -std=c++17 -O3 -march=native -fopenmp-simd -DRESTRICTKEYWORD=__restrict__ \
+ *       -I../../include sat_adjust_row.cxx -o sat_adjust_row && ./sat_adjust_row
+ *
+ * The program returns a non-zero exit code if a deviation exceeds its tolerance.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "defines.h"
+#include "thermo_moist_functions.h"
+
+namespace
+{
+    using namespace Thermo_moist_functions;
+
+    struct Case
+    {
+        const char* name;
+        double thl;     // Lower bound of liquid water potential temperature (K).
+        double dthl;    // Range of liquid water potential temperature (K).
+        double qt;      // Lower bound of total specific humidity (kg kg-1).
+        double dqt;     // Range of total specific humidity (kg kg-1).
+        double p;       // Pressure (Pa).
+    };
+
+    const std::vector<Case> cases =
+    {
+        {"bomex",  298.5,  2.0, 0.0150, 0.0025, 90000.},
+        {"rico",   297.0,  2.0, 0.0135, 0.0040, 85000.},
+        {"dycoms", 288.0,  2.0, 0.0080, 0.0010, 93000.},
+        {"cold",   255.0, 15.0, 0.0010, 0.0040, 50000.},
+    };
+
+    template<typename TF>
+    bool run_case(const Case& c, const double tol_t, const double tol_qs, const double tol_q)
+    {
+        const int itot = 256;
+        const int jtot = 256;
+        const int n = itot*jtot;
+        const int nrep = 20;
+
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> dist(0., 1.);
+
+        std::vector<TF> thl(n), qt(n);
+        for (int i=0; i<n; ++i)
+        {
+            thl[i] = c.thl + c.dthl*dist(gen);
+            qt [i] = c.qt  + c.dqt *dist(gen);
+        }
+
+        const TF p = c.p;
+        const TF exn = exner(p);
+
+        std::vector<TF> ql_ref(n), qi_ref(n), t_ref(n), qs_ref(n);
+        std::vector<TF> ql(n), qi(n), t(n), qs(n);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r=0; r<nrep; ++r)
+            for (int i=0; i<n; ++i)
+            {
+                const Struct_sat_adjust<TF> ssa = sat_adjust(thl[i], qt[i], p, exn);
+                ql_ref[i] = ssa.ql;
+                qi_ref[i] = ssa.qi;
+                t_ref [i] = ssa.t;
+                qs_ref[i] = ssa.qs;
+            }
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (int r=0; r<nrep; ++r)
+            for (int j=0; j<jtot; ++j)
+            {
+                const int ij = j*itot;
+                sat_adjust_row<TF, TF>(&ql[ij], &qi[ij], &t[ij], &qs[ij], &thl[ij], &qt[ij], p, exn, itot);
+            }
+        auto t2 = std::chrono::steady_clock::now();
+
+        int nsat = 0;
+        double err_t = 0., err_qs = 0., err_ql = 0., err_qi = 0.;
+        for (int i=0; i<n; ++i)
+        {
+            if (ql_ref[i] + qi_ref[i] > TF(0.))
+                ++nsat;
+
+            err_t  = std::max(err_t,  std::abs(double(t [i]) - t_ref [i]) / t_ref [i]);
+            err_qs = std::max(err_qs, std::abs(double(qs[i]) - qs_ref[i]) / qs_ref[i]);
+            err_ql = std::max(err_ql, std::abs(double(ql[i]) - ql_ref[i]));
+            err_qi = std::max(err_qi, std::abs(double(qi[i]) - qi_ref[i]));
+        }
+
+        const double time_ref = std::chrono::duration<double, std::milli>(t1-t0).count() / nrep;
+        const double time_row = std::chrono::duration<double, std::milli>(t2-t1).count() / nrep;
+
+        const bool pass = err_t <= tol_t && err_qs <= tol_qs && err_ql <= tol_q && err_qi <= tol_q;
+
+        std::printf("%-6s %-6s sat %5.1f%%  max err T %.1e qs %.1e ql %.1e qi %.1e  "
+                "sat_adjust %6.2f ms  sat_adjust_row %6.2f ms  speedup %.2f  %s\n",
+                sizeof(TF) == 8 ? "double" : "float", c.name, 100.*nsat/n,
+                err_t, err_qs, err_ql, err_qi, time_ref, time_row, time_ref/time_row,
+                pass ? "OK" : "FAILED");
+
+        return pass;
+    }
+}
+
+int main()
+{
+    // The tolerances follow from the 1e-5 relative stopping criterion of `sat_adjust()`.
+    int nerror = 0;
+    for (const Case& c : cases)
+        nerror += !run_case<double>(c, 1e-6, 1e-5, 1e-7);
+    for (const Case& c : cases)
+        nerror += !run_case<float>(c, 1e-6, 1e-5, 1e-7);
+
+    return nerror > 0;
+}
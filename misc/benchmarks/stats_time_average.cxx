@@ -0,0 +1,94 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Check of the time averaging of the multi-dimensional statistics (spectra and histograms)
+ * with masked-out samples. Build and run with:
+ *
+ *   g++ -std=c++17 -O2 -I../../include stats_time_average.cxx -o stats_time_average && ./stats_time_average
+ *
+ * The program returns a non-zero exit code if the check fails.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+#include "stats_functions.h"
+
+namespace
+{
+    using namespace Stats_functions;
+
+    template<typename TF>
+    bool check()
+    {
+        const TF fill = netcdf_fp_fillvalue<TF>();
+
+        std::vector<TF> data;
+        std::vector<double> sum;
+        std::vector<int> nsamples;
+
+        // Three samples of a histogram with three levels of two bins: the second level has
+        // an empty mask in the second sample, and the third level in all samples.
+        const std::vector<std::vector<TF>> samples =
+        {
+            {TF(0.2), TF(0.8), TF(0.5), TF(0.5), fill, fill},
+            {TF(0.4), TF(0.6), fill,    fill,    fill, fill},
+            {TF(0.6), TF(0.4), TF(0.1), TF(0.9), fill, fill},
+        };
+
+        for (auto& s : samples)
+        {
+            data = s;
+            accumulate_samples(sum, nsamples, data);
+        }
+        average_samples(data, sum, nsamples);
+
+        const std::vector<TF> expected = {TF(0.4), TF(0.6), TF(0.3), TF(0.7), fill, fill};
+
+        bool pass = true;
+        for (size_t n=0; n<data.size(); ++n)
+            pass = pass && std::abs(data[n] - expected[n]) <= TF(1e-6)*std::abs(expected[n]);
+
+        // The accumulators are reset, so the next window does not see the previous one.
+        data = samples[1];
+        accumulate_samples(sum, nsamples, data);
+        average_samples(data, sum, nsamples);
+        for (size_t n=0; n<data.size(); ++n)
+            pass = pass && data[n] == samples[1][n];
+
+        std::printf("%-6s time average with masked-out samples: %s\n",
+                sizeof(TF) == 8 ? "double" : "float", pass ? "OK" : "FAILED");
+
+        return pass;
+    }
+}
+
+int main()
+{
+    int nerror = 0;
+    nerror += !check<double>();
+    nerror += !check<float>();
+
+    return nerror > 0;
+}
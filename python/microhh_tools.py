@@ -301,10 +301,41 @@ class Read_binary:
         except BaseException:
             raise Exception('Cannot find file {}'.format(filename))
 
+        # Compressed files are decompressed at once, and read from memory.
+        self.data = None
+        if self.file.read(8) == b'MHHZLIB1':
+            self.data = self._decompress()
+            self.pos = 0
+        else:
+            self.file.seek(0)
+
+    def _decompress(self):
+        import zlib
+
+        precision, itot, jtot, ktot, nchunks, keepbits, error_bound = st.unpack(
+            '{}6id'.format(self.en), self.file.read(32))
+        self.keepbits = keepbits
+        self.error_bound = error_bound
+
+        data = np.empty((ktot, jtot, itot))
+        chunks = [st.unpack('{}3q4i'.format(self.en), self.file.read(40)) for n in range(nchunks)]
+
+        for offset, nbytes, nbytes_raw, istart, jstart, isize, jsize in chunks:
+            self.file.seek(offset)
+            shuffled = np.frombuffer(zlib.decompress(self.file.read(nbytes)), dtype=np.uint8)
+            block = shuffled.reshape(precision, -1).T.copy().view('{}f{}'.format(self.en, precision))
+            data[:, jstart:jstart+jsize, istart:istart+isize] = block.reshape(ktot, jsize, isize)
+
+        return data.flatten()
+
     def close(self):
         self.file.close()
 
     def read(self, n):
+        if self.data is not None:
+            self.pos += n
+            return self.data[self.pos-n:self.pos]
+
         return np.array(
             st.unpack(
                 '{0}{1}{2}'.format(
@@ -379,6 +410,26 @@ def get_cross_indices(variable, mode):
     return indices, halflevel
 
 
+
+def read_aggregated_cross(filename, endian='<'):
+    """ Read a file with aggregated cross-sections ([cross] swaggregate). Returns the
+        slice indices and the data as an array with dimensions (time, slice, z, y, x) """
+    with open(filename, 'rb') as f:
+        if f.read(8) != b'MHHSLCS1':
+            raise Exception('{} is not an aggregated cross-section file'.format(filename))
+
+        precision, nslices, ksize, jsize, isize, _ = st.unpack(
+            '{}6i'.format(endian), f.read(24))
+        indices = list(st.unpack('{}{}i'.format(endian, nslices), f.read(4*nslices)))
+        data = np.fromfile(f, dtype='{}f{}'.format(endian, precision))
+
+    # Records that have not been written yet contain zeros, an incomplete last record is skipped.
+    nrecord = nslices * ksize * jsize * isize
+    nrecords = data.size // nrecord
+    data = data[:nrecords*nrecord].reshape(nrecords, nslices, ksize, jsize, isize)
+
+    return indices, data
+
 _opts = {
     'blue': '\033[94m',
     'green': '\033[92m',
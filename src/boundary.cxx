@@ -284,8 +284,9 @@ void Boundary<TF>::init(Input& input, Thermo<TF>& thermo, const Sim_mode sim_mod
         throw std::runtime_error("Cannot use ustar bc for default boundary");
     }
 
-    // Initialize the boundary cyclic.
+    // Initialize the boundary cyclic and the IO.
     boundary_cyclic.init();
+    field3d_io.init();
     if (sim_mode == Sim_mode::Init)
     {
         input.flag_as_used("boundary", "swtimedep", "");
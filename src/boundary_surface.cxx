@@ -456,8 +456,9 @@ void Boundary_surface<TF>::init(Input& inputin, Thermo<TF>& thermo, const Sim_mo
     // 3. Allocate and initialize the 2D surface fields.
     init_surface(inputin, thermo);
 
-    // 4. Initialize the boundary cyclic.
+    // 4. Initialize the boundary cyclic and the IO.
     boundary_cyclic.init();
+    field3d_io.init();
 
     if (sim_mode == Sim_mode::Init)
     {
@@ -953,8 +953,9 @@ void Boundary_surface_lsm<TF>::init(Input& inputin, Thermo<TF>& thermo, const Si
     init_surface_layer(inputin);
     init_land_surface();
 
-    // Initialize the boundary cyclic.
+    // Initialize the boundary cyclic and the IO.
     boundary_cyclic.init();
+    field3d_io.init();
 
     if (sim_mode == Sim_mode::Init)
     {
@@ -1393,21 +1393,24 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
         auto uw_shear = fields.get_tmp();
         auto vw_shear = fields.get_tmp();
 
-        calc_shear_terms(
-                u2_shear->fld.data(), v2_shear->fld.data(), tke_shear->fld.data(),
-                uw_shear->fld.data(), vw_shear->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                umodel.data(), vmodel.data(), wmodel.data(),
-                wx->fld.data(), wy->fld.data(),
-                gd.dzi.data(), gd.dzhi.data(),
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_shear" , *u2_shear , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_shear" , *v2_shear , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_shear", *tke_shear, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_shear" , *uw_shear , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "vw_shear" , *vw_shear , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_shear", "v2_shear", "tke_shear", "uw_shear", "vw_shear"}))
+        {
+            calc_shear_terms(
+                    u2_shear->fld.data(), v2_shear->fld.data(), tke_shear->fld.data(),
+                    uw_shear->fld.data(), vw_shear->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                    umodel.data(), vmodel.data(), wmodel.data(),
+                    wx->fld.data(), wy->fld.data(),
+                    gd.dzi.data(), gd.dzhi.data(),
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_shear" , *u2_shear , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_shear" , *v2_shear , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_shear", *tke_shear, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_shear" , *uw_shear , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "vw_shear" , *vw_shear , no_offset, no_threshold);
+        }
 
         auto u2_turb = std::move(u2_shear);
         auto v2_turb = std::move(v2_shear);
@@ -1416,23 +1419,26 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
         auto uw_turb = std::move(uw_shear);
         auto vw_turb = std::move(vw_shear);
 
-        calc_turb_terms(
-                u2_turb->fld.data(), v2_turb->fld.data(),
-                w2_turb->fld.data(), tke_turb->fld.data(),
-                uw_turb->fld.data(), vw_turb->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                umodel.data(), vmodel.data(), wmodel.data(),
-                wx->fld.data(), wy->fld.data(),
-                gd.dzi.data(), gd.dzhi.data(),
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_turb" , *u2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_turb" , *v2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_turb" , *w2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_turb", *tke_turb, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_turb" , *uw_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "vw_turb" , *vw_turb , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_turb", "v2_turb", "w2_turb", "tke_turb", "uw_turb", "vw_turb"}))
+        {
+            calc_turb_terms(
+                    u2_turb->fld.data(), v2_turb->fld.data(),
+                    w2_turb->fld.data(), tke_turb->fld.data(),
+                    uw_turb->fld.data(), vw_turb->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                    umodel.data(), vmodel.data(), wmodel.data(),
+                    wx->fld.data(), wy->fld.data(),
+                    gd.dzi.data(), gd.dzhi.data(),
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_turb" , *u2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_turb" , *v2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_turb" , *w2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_turb", *tke_turb, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_turb" , *uw_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "vw_turb" , *vw_turb , no_offset, no_threshold);
+        }
 
         fields.release_tmp(u2_turb);
         fields.release_tmp(v2_turb);
@@ -1454,20 +1460,23 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
 
                 auto wz = fields.get_tmp();
 
-                calc_diffusion_transport_terms_dns(
-                        u2_visc->fld.data(), v2_visc->fld.data(), w2_visc->fld.data(), tke_visc->fld.data(), uw_visc->fld.data(),
-                        fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                        wx->fld.data(), wy->fld.data(), wz->fld.data(),
-                        umodel.data(), vmodel.data(), wmodel.data(),
-                        gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi, fields.visc,
-                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                        gd.icells, gd.ijcells);
-
-                stats.calc_mask_stats(m, "u2_visc" , *u2_visc , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "v2_visc" , *v2_visc , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "w2_visc" , *w2_visc , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "tke_visc", *tke_visc, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "uw_visc" , *uw_visc , no_offset, no_threshold);
+                if (stats.is_any_needed({"u2_visc", "v2_visc", "w2_visc", "tke_visc", "uw_visc"}))
+                {
+                    calc_diffusion_transport_terms_dns(
+                            u2_visc->fld.data(), v2_visc->fld.data(), w2_visc->fld.data(), tke_visc->fld.data(), uw_visc->fld.data(),
+                            fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                            wx->fld.data(), wy->fld.data(), wz->fld.data(),
+                            umodel.data(), vmodel.data(), wmodel.data(),
+                            gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi, fields.visc,
+                            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                            gd.icells, gd.ijcells);
+
+                    stats.calc_mask_stats(m, "u2_visc" , *u2_visc , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "v2_visc" , *v2_visc , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "w2_visc" , *w2_visc , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "tke_visc", *tke_visc, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "uw_visc" , *uw_visc , no_offset, no_threshold);
+                }
 
                 auto u2_diss = std::move(u2_visc);
                 auto v2_diss = std::move(v2_visc);
@@ -1475,19 +1484,22 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
                 auto tke_diss = std::move(tke_visc);
                 auto uw_diss = std::move(uw_visc);
 
-                calc_diffusion_dissipation_terms_dns(
-                        u2_diss->fld.data(), v2_diss->fld.data(), w2_diss->fld.data(), tke_diss->fld.data(), uw_diss->fld.data(),
-                        fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                        umodel.data(), vmodel.data(), wmodel.data(),
-                        gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi, fields.visc,
-                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                        gd.icells, gd.ijcells);
-
-                stats.calc_mask_stats(m, "u2_diss" , *u2_diss , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "v2_diss" , *v2_diss , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "w2_diss" , *w2_diss , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "tke_diss", *tke_diss, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "uw_diss" , *uw_diss , no_offset, no_threshold);
+                if (stats.is_any_needed({"u2_diss", "v2_diss", "w2_diss", "tke_diss", "uw_diss"}))
+                {
+                    calc_diffusion_dissipation_terms_dns(
+                            u2_diss->fld.data(), v2_diss->fld.data(), w2_diss->fld.data(), tke_diss->fld.data(), uw_diss->fld.data(),
+                            fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                            umodel.data(), vmodel.data(), wmodel.data(),
+                            gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi, fields.visc,
+                            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                            gd.icells, gd.ijcells);
+
+                    stats.calc_mask_stats(m, "u2_diss" , *u2_diss , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "v2_diss" , *v2_diss , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "w2_diss" , *w2_diss , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "tke_diss", *tke_diss, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "uw_diss" , *uw_diss , no_offset, no_threshold);
+                }
 
                 fields.release_tmp(u2_diss);
                 fields.release_tmp(v2_diss);
@@ -1509,26 +1521,29 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
                 auto wz = fields.get_tmp();
                 auto evisch = fields.get_tmp();
  
-                calc_diffusion_terms_les(
-                        u2_diff->fld.data(), v2_diff->fld.data(),
-                        w2_diff->fld.data(), tke_diff->fld.data(),
-                        uw_diff->fld.data(), vw_diff->fld.data(),
-                        wz->fld.data(), evisch->fld.data(),
-                        fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                        fields.mp.at("u")->flux_bot.data(), fields.mp.at("v")->flux_bot.data(),
-                        fields.sd.at("evisc")->fld.data(),
-                        umodel.data(), vmodel.data(), wmodel.data(),
-                        gd.dzi.data(), gd.dzhi.data(),
-                        gd.dxi, gd.dyi,
-                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                        gd.icells, gd.jcells, gd.ijcells);
-
-                stats.calc_mask_stats(m, "u2_diff" , *u2_diff , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "v2_diff" , *v2_diff , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "w2_diff" , *w2_diff , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "tke_diff", *tke_diff, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "uw_diff" , *uw_diff , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "vw_diff" , *vw_diff , no_offset, no_threshold);
+                if (stats.is_any_needed({"u2_diff", "v2_diff", "w2_diff", "tke_diff", "uw_diff", "vw_diff"}))
+                {
+                    calc_diffusion_terms_les(
+                            u2_diff->fld.data(), v2_diff->fld.data(),
+                            w2_diff->fld.data(), tke_diff->fld.data(),
+                            uw_diff->fld.data(), vw_diff->fld.data(),
+                            wz->fld.data(), evisch->fld.data(),
+                            fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                            fields.mp.at("u")->flux_bot.data(), fields.mp.at("v")->flux_bot.data(),
+                            fields.sd.at("evisc")->fld.data(),
+                            umodel.data(), vmodel.data(), wmodel.data(),
+                            gd.dzi.data(), gd.dzhi.data(),
+                            gd.dxi, gd.dyi,
+                            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                            gd.icells, gd.jcells, gd.ijcells);
+
+                    stats.calc_mask_stats(m, "u2_diff" , *u2_diff , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "v2_diff" , *v2_diff , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "w2_diff" , *w2_diff , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "tke_diff", *tke_diff, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "uw_diff" , *uw_diff , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "vw_diff" , *vw_diff , no_offset, no_threshold);
+                }
 
                 fields.release_tmp(u2_diff);
                 fields.release_tmp(v2_diff);
@@ -1549,20 +1564,23 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
         auto uw_pres = fields.get_tmp();
         auto vw_pres = fields.get_tmp();
 
-        calc_pressure_transport_terms(
-                w2_pres->fld.data(), tke_pres->fld.data(),
-                uw_pres->fld.data(), vw_pres->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
-                fields.mp.at("w")->fld.data(), fields.sd.at("p")->fld.data(),
-                umodel.data(), vmodel.data(), wmodel.data(),
-                gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "w2_pres" , *w2_pres , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_pres", *tke_pres, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_pres" , *uw_pres , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "vw_pres" , *vw_pres , no_offset, no_threshold);
+        if (stats.is_any_needed({"w2_pres", "tke_pres", "uw_pres", "vw_pres"}))
+        {
+            calc_pressure_transport_terms(
+                    w2_pres->fld.data(), tke_pres->fld.data(),
+                    uw_pres->fld.data(), vw_pres->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
+                    fields.mp.at("w")->fld.data(), fields.sd.at("p")->fld.data(),
+                    umodel.data(), vmodel.data(), wmodel.data(),
+                    gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "w2_pres" , *w2_pres , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_pres", *tke_pres, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_pres" , *uw_pres , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "vw_pres" , *vw_pres , no_offset, no_threshold);
+        }
 
         auto u2_rdstr = fields.get_tmp();
         auto v2_rdstr = std::move(tke_pres);
@@ -1570,21 +1588,24 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
         auto uw_rdstr = std::move(uw_pres);
         auto vw_rdstr = std::move(vw_pres);
 
-        calc_pressure_redistribution_terms(
-                u2_rdstr->fld.data(), v2_rdstr->fld.data(), w2_rdstr->fld.data(),
-                uw_rdstr->fld.data(), vw_rdstr->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
-                fields.mp.at("w")->fld.data(), fields.sd.at("p")->fld.data(),
-                umodel.data(), vmodel.data(), wmodel.data(),
-                gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_rdstr", *u2_rdstr , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_rdstr", *v2_rdstr , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_rdstr", *w2_rdstr , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_rdstr", *uw_rdstr , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "vw_rdstr", *vw_rdstr , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_rdstr", "v2_rdstr", "w2_rdstr", "uw_rdstr", "vw_rdstr"}))
+        {
+            calc_pressure_redistribution_terms(
+                    u2_rdstr->fld.data(), v2_rdstr->fld.data(), w2_rdstr->fld.data(),
+                    uw_rdstr->fld.data(), vw_rdstr->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
+                    fields.mp.at("w")->fld.data(), fields.sd.at("p")->fld.data(),
+                    umodel.data(), vmodel.data(), wmodel.data(),
+                    gd.dzi.data(), gd.dzhi.data(), gd.dxi, gd.dyi,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_rdstr", *u2_rdstr , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_rdstr", *v2_rdstr , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_rdstr", *w2_rdstr , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_rdstr", *uw_rdstr , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "vw_rdstr", *vw_rdstr , no_offset, no_threshold);
+        }
 
         fields.release_tmp(u2_rdstr);
         fields.release_tmp(v2_rdstr);
@@ -1600,18 +1621,21 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
             auto vw_cor = fields.get_tmp();
 
             const TF fc = force.get_coriolis_parameter();
-            calc_coriolis_terms(
-                    u2_cor->fld.data(), v2_cor->fld.data(),
-                    uw_cor->fld.data(), vw_cor->fld.data(),
-                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
-                    umodel.data(), vmodel.data(), wmodel.data(), fc,
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
+            if (stats.is_any_needed({"u2_cor", "v2_cor", "uw_cor", "vw_cor"}))
+            {
+                calc_coriolis_terms(
+                        u2_cor->fld.data(), v2_cor->fld.data(),
+                        uw_cor->fld.data(), vw_cor->fld.data(),
+                        fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), fields.mp.at("w")->fld.data(),
+                        umodel.data(), vmodel.data(), wmodel.data(), fc,
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
 
-            stats.calc_mask_stats(m, "u2_cor", *u2_cor, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "v2_cor", *v2_cor, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "uw_cor", *uw_cor, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "vw_cor", *vw_cor, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "u2_cor", *u2_cor, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "v2_cor", *v2_cor, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "uw_cor", *uw_cor, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "vw_cor", *vw_cor, no_offset, no_threshold);
+            }
 
             fields.release_tmp(u2_cor);
             fields.release_tmp(v2_cor);
@@ -1619,7 +1643,13 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
             fields.release_tmp(vw_cor);
         }
 
-        if (thermo.get_switch() != Thermo_type::Disabled)
+        // Skip the buoyancy terms, including the computation of the buoyancy, if none is requested.
+        const std::vector<std::string> buoyancy_terms = {
+                "w2_buoy", "tke_buoy", "uw_buoy", "vw_buoy", "bw_buoy", "b2_shear",
+                "b2_turb", "bw_shear", "bw_turb", "b2_visc", "b2_diss", "bw_visc",
+                "bw_diss", "bw_pres", "bw_rdstr"};
+
+        if (thermo.get_switch() != Thermo_type::Disabled && stats.is_any_needed(buoyancy_terms))
         {
             // Get the buoyancy diffusivity from the thermo class
             const TF diff_b = thermo.get_buoyancy_diffusivity();
@@ -1638,20 +1668,23 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
             auto vw_buoy = fields.get_tmp();
 
             // Calculate buoyancy terms
-            calc_buoyancy_terms(
-                    w2_buoy->fld.data(), tke_buoy->fld.data(),
-                    uw_buoy->fld.data(), vw_buoy->fld.data(),
-                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
-                    fields.mp.at("w")->fld.data(), b->fld.data(),
-                    umodel.data(), vmodel.data(), wmodel.data(),
-                    b->fld_mean.data(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
+            if (stats.is_any_needed({"w2_buoy", "tke_buoy", "uw_buoy", "vw_buoy"}))
+            {
+                calc_buoyancy_terms(
+                        w2_buoy->fld.data(), tke_buoy->fld.data(),
+                        uw_buoy->fld.data(), vw_buoy->fld.data(),
+                        fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
+                        fields.mp.at("w")->fld.data(), b->fld.data(),
+                        umodel.data(), vmodel.data(), wmodel.data(),
+                        b->fld_mean.data(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
 
-            stats.calc_mask_stats(m, "w2_buoy" , *w2_buoy , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "tke_buoy", *tke_buoy, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "uw_buoy" , *uw_buoy , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "vw_buoy" , *vw_buoy , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "w2_buoy" , *w2_buoy , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "tke_buoy", *tke_buoy, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "uw_buoy" , *uw_buoy , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "vw_buoy" , *vw_buoy , no_offset, no_threshold);
+            }
 
             fields.release_tmp(w2_buoy);
             fields.release_tmp(tke_buoy);
@@ -1659,14 +1692,17 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
             auto bw_buoy = std::move(vw_buoy);
 
             // Buoyancy variance and flux budgets
-            calc_buoyancy_terms_scalar(
-                    bw_buoy->fld.data(),
-                    b->fld.data(), b->fld.data(),
-                    b->fld_mean.data(), b->fld_mean.data(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
+            if (stats.is_needed("bw_buoy"))
+            {
+                calc_buoyancy_terms_scalar(
+                        bw_buoy->fld.data(),
+                        b->fld.data(), b->fld.data(),
+                        b->fld_mean.data(), b->fld_mean.data(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
 
-            stats.calc_mask_stats(m, "bw_buoy", *bw_buoy, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_buoy", *bw_buoy, no_offset, no_threshold);
+            }
             fields.release_tmp(bw_buoy);
 
             if (advec.get_switch() != Advection_type::Disabled)
@@ -1676,19 +1712,22 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
                 auto bw_shear = fields.get_tmp();
                 auto bw_turb = fields.get_tmp();
 
-                calc_advection_terms_scalar(
-                        b2_shear->fld.data(), b2_turb->fld.data(),
-                        bw_shear->fld.data(), bw_turb->fld.data(),
-                        fields.mp.at("w")->fld.data(), b->fld.data(),
-                        b->fld_mean.data(),
-                        gd.dzi.data(), gd.dzhi.data(),
-                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                        gd.icells, gd.ijcells);
-
-                stats.calc_mask_stats(m, "b2_shear", *b2_shear, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "b2_turb" , *b2_turb , no_offset, no_threshold);
-                stats.calc_mask_stats(m, "bw_shear", *bw_shear, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "bw_turb" , *bw_turb , no_offset, no_threshold);
+                if (stats.is_any_needed({"b2_shear", "b2_turb", "bw_shear", "bw_turb"}))
+                {
+                    calc_advection_terms_scalar(
+                            b2_shear->fld.data(), b2_turb->fld.data(),
+                            bw_shear->fld.data(), bw_turb->fld.data(),
+                            fields.mp.at("w")->fld.data(), b->fld.data(),
+                            b->fld_mean.data(),
+                            gd.dzi.data(), gd.dzhi.data(),
+                            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                            gd.icells, gd.ijcells);
+
+                    stats.calc_mask_stats(m, "b2_shear", *b2_shear, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "b2_turb" , *b2_turb , no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "bw_shear", *bw_shear, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "bw_turb" , *bw_turb , no_offset, no_threshold);
+                }
 
                 fields.release_tmp(b2_shear);
                 fields.release_tmp(b2_turb );
@@ -1703,20 +1742,23 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
                 auto bw_visc = fields.get_tmp();
                 auto bw_diss = fields.get_tmp();
 
-                calc_diffusion_terms_scalar_dns(
-                        b2_visc->fld.data(), b2_diss->fld.data(),
-                        bw_visc->fld.data(), bw_diss->fld.data(),
-                        fields.mp.at("w")->fld.data(), b->fld.data(),
-                        b->fld_mean.data(),
-                        gd.dzi.data(), gd.dzhi.data(),
-                        gd.dxi, gd.dyi, fields.visc, diff_b,
-                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                        gd.icells, gd.ijcells);
-
-                stats.calc_mask_stats(m, "b2_visc", *b2_visc, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "b2_diss", *b2_diss, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "bw_visc", *bw_visc, no_offset, no_threshold);
-                stats.calc_mask_stats(m, "bw_diss", *bw_diss, no_offset, no_threshold);
+                if (stats.is_any_needed({"b2_visc", "b2_diss", "bw_visc", "bw_diss"}))
+                {
+                    calc_diffusion_terms_scalar_dns(
+                            b2_visc->fld.data(), b2_diss->fld.data(),
+                            bw_visc->fld.data(), bw_diss->fld.data(),
+                            fields.mp.at("w")->fld.data(), b->fld.data(),
+                            b->fld_mean.data(),
+                            gd.dzi.data(), gd.dzhi.data(),
+                            gd.dxi, gd.dyi, fields.visc, diff_b,
+                            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                            gd.icells, gd.ijcells);
+
+                    stats.calc_mask_stats(m, "b2_visc", *b2_visc, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "b2_diss", *b2_diss, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "bw_visc", *bw_visc, no_offset, no_threshold);
+                    stats.calc_mask_stats(m, "bw_diss", *bw_diss, no_offset, no_threshold);
+                }
 
                 fields.release_tmp(b2_visc);
                 fields.release_tmp(b2_diss);
@@ -1727,16 +1769,19 @@ void Budget_2<TF>::exec_stats(Stats<TF>& stats)
             auto bw_pres = fields.get_tmp();
             auto bw_rdstr = fields.get_tmp();
 
-            calc_pressure_terms_scalar(
-                    bw_pres->fld.data(), bw_rdstr->fld.data(),
-                    b->fld.data(), fields.sd.at("p")->fld.data(),
-                    b->fld_mean.data(), fields.sd.at("p")->fld_mean.data(),
-                    gd.dzi.data(), gd.dzhi.data(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
+            if (stats.is_any_needed({"bw_pres", "bw_rdstr"}))
+            {
+                calc_pressure_terms_scalar(
+                        bw_pres->fld.data(), bw_rdstr->fld.data(),
+                        b->fld.data(), fields.sd.at("p")->fld.data(),
+                        b->fld_mean.data(), fields.sd.at("p")->fld_mean.data(),
+                        gd.dzi.data(), gd.dzhi.data(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
 
-            stats.calc_mask_stats(m, "bw_pres", *bw_pres, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_rdstr", *bw_rdstr, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_pres", *bw_pres, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_rdstr", *bw_rdstr, no_offset, no_threshold);
+            }
 
             fields.release_tmp(bw_pres);
             fields.release_tmp(bw_rdstr);
@@ -2790,19 +2790,22 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
         auto tke_shear = fields.get_tmp();
         auto uw_shear = fields.get_tmp();
 
-        calc_tke_budget_shear(
-                u2_shear->fld.data(), v2_shear->fld.data(), tke_shear->fld.data(), uw_shear->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
-                wx->fld.data(), wy->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_shear" , *u2_shear , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_shear" , *v2_shear , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_shear", *tke_shear, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_shear" , *uw_shear , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_shear", "v2_shear", "tke_shear", "uw_shear"}))
+        {
+            calc_tke_budget_shear(
+                    u2_shear->fld.data(), v2_shear->fld.data(), tke_shear->fld.data(), uw_shear->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
+                    wx->fld.data(), wy->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_shear" , *u2_shear , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_shear" , *v2_shear , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_shear", *tke_shear, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_shear" , *uw_shear , no_offset, no_threshold);
+        }
 
         auto u2_turb = std::move(u2_shear);
         auto v2_turb = std::move(v2_shear);
@@ -2810,38 +2813,44 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
         auto tke_turb = std::move(tke_shear);
         auto uw_turb = std::move(uw_shear);
 
-        calc_tke_budget_turb(
-                u2_turb->fld.data(), v2_turb->fld.data(), w2_turb->fld.data(), tke_turb->fld.data(), uw_turb->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
-                wx->fld.data(), wy->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_turb" , *u2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_turb" , *v2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_turb" , *w2_turb , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_turb", *tke_turb, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_turb" , *uw_turb , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_turb", "v2_turb", "w2_turb", "tke_turb", "uw_turb"}))
+        {
+            calc_tke_budget_turb(
+                    u2_turb->fld.data(), v2_turb->fld.data(), w2_turb->fld.data(), tke_turb->fld.data(), uw_turb->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
+                    wx->fld.data(), wy->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_turb" , *u2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_turb" , *v2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_turb" , *w2_turb , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_turb", *tke_turb, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_turb" , *uw_turb , no_offset, no_threshold);
+        }
 
         auto w2_pres  = std::move(w2_turb);
         auto tke_pres = std::move(tke_turb);
         auto uw_pres  = std::move(uw_turb);
 
-        calc_tke_budget_pres(
-                w2_pres->fld.data(), tke_pres->fld.data(), uw_pres->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
-                w_prime->fld.data(), fields.sd.at("p")->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.dxi, gd.dyi,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
+        if (stats.is_any_needed({"w2_pres", "tke_pres", "uw_pres"}))
+        {
+            calc_tke_budget_pres(
+                    w2_pres->fld.data(), tke_pres->fld.data(), uw_pres->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
+                    w_prime->fld.data(), fields.sd.at("p")->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.dxi, gd.dyi,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
 
-        stats.calc_mask_stats(m, "w2_pres" , *w2_pres , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_pres", *tke_pres, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_pres" , *uw_pres , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_pres" , *w2_pres , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_pres", *tke_pres, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_pres" , *uw_pres , no_offset, no_threshold);
+        }
 
         auto u2_visc  = std::move(u2_turb);
         auto v2_visc  = std::move(v2_turb);
@@ -2852,22 +2861,25 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
         auto wz = std::move(wx);
         auto uz = std::move(wy);
 
-        calc_tke_budget_visc(
-                u2_visc->fld.data(), v2_visc->fld.data(), w2_visc->fld.data(), tke_visc->fld.data(), uw_visc->fld.data(),
-                wz->fld.data(), uz->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
-                fields.visc,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_visc" , *u2_visc , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_visc" , *v2_visc , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_visc" , *w2_visc , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_visc", *tke_visc, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_visc" , *uw_visc , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_visc", "v2_visc", "w2_visc", "tke_visc", "uw_visc"}))
+        {
+            calc_tke_budget_visc(
+                    u2_visc->fld.data(), v2_visc->fld.data(), w2_visc->fld.data(), tke_visc->fld.data(), uw_visc->fld.data(),
+                    wz->fld.data(), uz->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
+                    fields.visc,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_visc" , *u2_visc , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_visc" , *v2_visc , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_visc" , *w2_visc , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_visc", *tke_visc, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_visc" , *uw_visc , no_offset, no_threshold);
+        }
 
         auto u2_diss  = std::move(u2_visc);
         auto v2_diss  = std::move(v2_visc);
@@ -2875,41 +2887,47 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
         auto tke_diss = std::move(tke_visc);
         auto uw_diss  = std::move(uw_visc);
 
-        calc_tke_budget_diss(
-                u2_diss->fld.data(), v2_diss->fld.data(), w2_diss->fld.data(), tke_diss->fld.data(), uw_diss->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
-                fields.visc,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_diss" , *u2_diss , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_diss" , *v2_diss , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_diss" , *w2_diss , no_offset, no_threshold);
-        stats.calc_mask_stats(m, "tke_diss", *tke_diss, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_diss" , *uw_diss , no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_diss", "v2_diss", "w2_diss", "tke_diss", "uw_diss"}))
+        {
+            calc_tke_budget_diss(
+                    u2_diss->fld.data(), v2_diss->fld.data(), w2_diss->fld.data(), tke_diss->fld.data(), uw_diss->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(), w_prime->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
+                    fields.visc,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_diss" , *u2_diss , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_diss" , *v2_diss , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_diss" , *w2_diss , no_offset, no_threshold);
+            stats.calc_mask_stats(m, "tke_diss", *tke_diss, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_diss" , *uw_diss , no_offset, no_threshold);
+        }
 
         auto u2_rdstr = std::move(u2_diss);
         auto v2_rdstr = std::move(v2_diss);
         auto w2_rdstr = std::move(w2_diss);
         auto uw_rdstr = std::move(uw_diss);
 
-        calc_tke_budget_rdstr(
-                u2_rdstr->fld.data(), v2_rdstr->fld.data(), w2_rdstr->fld.data(), uw_rdstr->fld.data(),
-                fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
-                w_prime->fld.data(), fields.sd.at("p")->fld.data(),
-                umodel.data(), vmodel.data(),
-                gd.dzi4.data(), gd.dzhi4.data(),
-                gd.dxi, gd.dyi,
-                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                gd.icells, gd.ijcells);
-
-        stats.calc_mask_stats(m, "u2_rdstr", *u2_rdstr, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "v2_rdstr", *v2_rdstr, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "w2_rdstr", *w2_rdstr, no_offset, no_threshold);
-        stats.calc_mask_stats(m, "uw_rdstr", *uw_rdstr, no_offset, no_threshold);
+        if (stats.is_any_needed({"u2_rdstr", "v2_rdstr", "w2_rdstr", "uw_rdstr"}))
+        {
+            calc_tke_budget_rdstr(
+                    u2_rdstr->fld.data(), v2_rdstr->fld.data(), w2_rdstr->fld.data(), uw_rdstr->fld.data(),
+                    fields.mp.at("u")->fld.data(), fields.mp.at("v")->fld.data(),
+                    w_prime->fld.data(), fields.sd.at("p")->fld.data(),
+                    umodel.data(), vmodel.data(),
+                    gd.dzi4.data(), gd.dzhi4.data(),
+                    gd.dxi, gd.dyi,
+                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                    gd.icells, gd.ijcells);
+
+            stats.calc_mask_stats(m, "u2_rdstr", *u2_rdstr, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "v2_rdstr", *v2_rdstr, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "w2_rdstr", *w2_rdstr, no_offset, no_threshold);
+            stats.calc_mask_stats(m, "uw_rdstr", *uw_rdstr, no_offset, no_threshold);
+        }
 
         // Release the tmp arrays that are still in use.
         fields.release_tmp(uz);
@@ -2921,7 +2939,13 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
         fields.release_tmp(uw_rdstr);
 
         // Calculate the buoyancy term of the TKE budget.
-        if (thermo.get_switch() != Thermo_type::Disabled)
+        // Skip the buoyancy terms, including the computation of the buoyancy, if none is requested.
+        const std::vector<std::string> buoyancy_terms = {
+                "w2_buoy", "tke_buoy", "uw_buoy", "b2_shear", "b2_turb", "b2_visc",
+                "b2_diss", "bw_shear", "bw_turb", "bw_visc", "bw_buoy", "bw_rdstr",
+                "bw_diss", "bw_pres", "b_sort"};
+
+        if (thermo.get_switch() != Thermo_type::Disabled && stats.is_any_needed(buoyancy_terms))
         {
             auto b = fields.get_tmp();
 
@@ -2935,82 +2959,91 @@ void Budget_4<TF>::exec_stats(Stats<TF>& stats)
             auto tke_buoy = fields.get_tmp();
             auto uw_buoy  = fields.get_tmp();
 
-            calc_tke_budget_buoy(
-                    w2_buoy->fld.data(), tke_buoy->fld.data(), uw_buoy->fld.data(),
-                    fields.mp.at("u")->fld.data(), w_prime->fld.data(), b->fld.data(),
-                    umodel.data(), b->fld_mean.data(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
-
-            stats.calc_mask_stats(m, "w2_buoy" , *w2_buoy , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "tke_buoy", *tke_buoy, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "uw_buoy" , *uw_buoy , no_offset, no_threshold);
+            if (stats.is_any_needed({"w2_buoy", "tke_buoy", "uw_buoy"}))
+            {
+                calc_tke_budget_buoy(
+                        w2_buoy->fld.data(), tke_buoy->fld.data(), uw_buoy->fld.data(),
+                        fields.mp.at("u")->fld.data(), w_prime->fld.data(), b->fld.data(),
+                        umodel.data(), b->fld_mean.data(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
+
+                stats.calc_mask_stats(m, "w2_buoy" , *w2_buoy , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "tke_buoy", *tke_buoy, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "uw_buoy" , *uw_buoy , no_offset, no_threshold);
+            }
 
             auto b2_shear = std::move(w2_buoy);
             auto b2_turb = std::move(tke_buoy);
             auto b2_visc = std::move(uw_buoy);
             auto b2_diss = fields.get_tmp();
 
-            calc_b2_budget(
-                    b2_shear->fld.data(), b2_turb->fld.data(), b2_visc->fld.data(), b2_diss->fld.data(),
-                    w_prime->fld.data(), b->fld.data(),
-                    b->fld_mean.data(),
-                    gd.dzi4.data(), gd.dzhi4.data(),
-                    gd.dxi, gd.dyi,
-                    thermo.get_buoyancy_diffusivity(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.ijcells);
-
-            stats.calc_mask_stats(m, "b2_shear", *b2_shear, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "b2_turb" , *b2_turb , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "b2_visc" , *b2_visc , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "b2_diss" , *b2_diss , no_offset, no_threshold);
+            if (stats.is_any_needed({"b2_shear", "b2_turb", "b2_visc", "b2_diss"}))
+            {
+                calc_b2_budget(
+                        b2_shear->fld.data(), b2_turb->fld.data(), b2_visc->fld.data(), b2_diss->fld.data(),
+                        w_prime->fld.data(), b->fld.data(),
+                        b->fld_mean.data(),
+                        gd.dzi4.data(), gd.dzhi4.data(),
+                        gd.dxi, gd.dyi,
+                        thermo.get_buoyancy_diffusivity(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
+
+                stats.calc_mask_stats(m, "b2_shear", *b2_shear, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "b2_turb" , *b2_turb , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "b2_visc" , *b2_visc , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "b2_diss" , *b2_diss , no_offset, no_threshold);
+            }
 
             auto bw_shear = std::move(b2_shear);
             auto bw_turb  = std::move(b2_turb);
             auto bw_visc  = std::move(b2_visc);
             auto bz       = std::move(b2_diss);
 
-            calc_bw_budget_shear_turb_visc(
-                    bw_shear->fld.data(), bw_turb->fld.data(), bw_visc->fld.data(),
-                    bz->fld.data(),
-                    w_prime->fld.data(), fields.sd.at("p")->fld.data(), b->fld.data(),
-                    fields.sd.at("p")->fld_mean.data(), b->fld_mean.data(),
-                    gd.dzi4.data(), gd.dzhi4.data(),
-                    gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
-                    thermo.get_buoyancy_diffusivity(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.jcells, gd.ijcells);
-
-            stats.calc_mask_stats(m, "bw_shear", *bw_shear, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_turb" , *bw_turb , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_visc" , *bw_visc , no_offset, no_threshold);
-
-            auto bw_buoy  = std::move(bw_shear);
-            auto bw_rdstr = std::move(bw_turb);
-            auto bw_diss  = std::move(bw_visc);
-            auto bw_pres  = fields.get_tmp();
-
-            calc_bw_budget_buoy_rdstr_diss_pres(
-                    bw_buoy->fld.data(), bw_rdstr->fld.data(), bw_diss->fld.data(), bw_pres->fld.data(),
-                    bz->fld.data(),
-                    w_prime->fld.data(), fields.sd.at("p")->fld.data(), b->fld.data(),
-                    fields.sd.at("p")->fld_mean.data(), b->fld_mean.data(),
-                    gd.dzi4.data(), gd.dzhi4.data(),
-                    gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
-                    thermo.get_buoyancy_diffusivity(),
-                    gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
-                    gd.icells, gd.jcells, gd.ijcells);
-
-            stats.calc_mask_stats(m, "bw_buoy" , *bw_buoy , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_rdstr", *bw_rdstr, no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_diss" , *bw_diss , no_offset, no_threshold);
-            stats.calc_mask_stats(m, "bw_pres" , *bw_pres , no_offset, no_threshold);
-
-            fields.release_tmp(bw_buoy);
-            fields.release_tmp(bw_rdstr);
-            fields.release_tmp(bw_diss);
-            fields.release_tmp(bw_pres);
+            if (stats.is_any_needed({"bw_shear", "bw_turb", "bw_visc", "bw_buoy", "bw_rdstr", "bw_diss", "bw_pres"}))
+            {
+                calc_bw_budget_shear_turb_visc(
+                        bw_shear->fld.data(), bw_turb->fld.data(), bw_visc->fld.data(),
+                        bz->fld.data(),
+                        w_prime->fld.data(), fields.sd.at("p")->fld.data(), b->fld.data(),
+                        fields.sd.at("p")->fld_mean.data(), b->fld_mean.data(),
+                        gd.dzi4.data(), gd.dzhi4.data(),
+                        gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
+                        thermo.get_buoyancy_diffusivity(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.jcells, gd.ijcells);
+
+                stats.calc_mask_stats(m, "bw_shear", *bw_shear, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_turb" , *bw_turb , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_visc" , *bw_visc , no_offset, no_threshold);
+
+                auto bw_buoy  = std::move(bw_shear);
+                auto bw_rdstr = std::move(bw_turb);
+                auto bw_diss  = std::move(bw_visc);
+                auto bw_pres  = fields.get_tmp();
+
+                calc_bw_budget_buoy_rdstr_diss_pres(
+                        bw_buoy->fld.data(), bw_rdstr->fld.data(), bw_diss->fld.data(), bw_pres->fld.data(),
+                        bz->fld.data(),
+                        w_prime->fld.data(), fields.sd.at("p")->fld.data(), b->fld.data(),
+                        fields.sd.at("p")->fld_mean.data(), b->fld_mean.data(),
+                        gd.dzi4.data(), gd.dzhi4.data(),
+                        gd.dxi, gd.dyi, gd.dzhi4bot, gd.dzhi4top,
+                        thermo.get_buoyancy_diffusivity(),
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.jcells, gd.ijcells);
+
+                stats.calc_mask_stats(m, "bw_buoy" , *bw_buoy , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_rdstr", *bw_rdstr, no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_diss" , *bw_diss , no_offset, no_threshold);
+                stats.calc_mask_stats(m, "bw_pres" , *bw_pres , no_offset, no_threshold);
+
+                fields.release_tmp(bw_buoy);
+                fields.release_tmp(bw_rdstr);
+                fields.release_tmp(bw_diss);
+                fields.release_tmp(bw_pres);
+            }
 
             auto b_sort = std::move(bz);
 
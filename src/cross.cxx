@@ -34,6 +34,8 @@
 #include "defines.h"
 #include "constants.h"
 #include "finite_difference.h"
+#include "lossy_compression.h"
+#include "netcdf_output.h"
 #include "timeloop.h"
 
 namespace
@@ -258,6 +260,8 @@ Cross<TF>::Cross(
     fields(fieldsin), field3d_io(master, grid)
 {
     swcross = inputin.get_item<bool>("cross", "swcross", "", false);
+    swnetcdf = false;
+    swaggregate = false;
 
     if (swcross)
     {
@@ -274,6 +278,16 @@ Cross<TF>::Cross(
             throw std::runtime_error(msg);
         }
 
+        // Optional lossy compression, per variable or for all variables.
+        for (auto& var : crosslist)
+        {
+            keepbits[var] = inputin.get_item<int>("cross", "keepbits", var, 0);
+            error_bound[var] = inputin.get_item<TF>("cross", "errorbound", var, 0);
+
+            if (keepbits.at(var) < 0 || error_bound.at(var) < 0)
+                throw std::runtime_error("Illegal lossy compression settings for cross-section of " + var);
+        }
+
         // Get the list of locations at which to take cross sections
         xy = inputin.get_list<TF>("cross", "xy", "", std::vector<TF>());
         xz = inputin.get_list<TF>("cross", "xz", "", std::vector<TF>());
@@ -281,6 +295,18 @@ Cross<TF>::Cross(
 
         // Get the list of vertical soil locations
         xy_soil = inputin.get_list<TF>("cross", "xy_soil", "", std::vector<TF>());
+
+        // Optional output of the atmospheric cross-sections as NetCDF, with one file per variable and orientation.
+        swnetcdf = inputin.get_item<bool>("cross", "swnetcdf", "", false);
+        if (swnetcdf)
+            netcdf_output = std::make_unique<Netcdf_output<TF>>(master, inputin);
+
+        // Optional output of all slices of a variable and orientation into one file, with a record per output time.
+        swaggregate = inputin.get_item<bool>("cross", "swaggregate", "", false);
+        if (swaggregate && swnetcdf)
+            throw std::runtime_error("swaggregate and swnetcdf cannot be combined in [cross]");
+
+        iotimeprec = inputin.get_item<int>("time", "iotimeprec", "", 0);
     }
     else
     {
@@ -290,6 +316,10 @@ Cross<TF>::Cross(
         inputin.flag_as_used("cross", "xz", "");
         inputin.flag_as_used("cross", "yz", "");
         inputin.flag_as_used("cross", "xy_soil", "");
+        inputin.flag_as_used("cross", "keepbits", "");
+        inputin.flag_as_used("cross", "errorbound", "");
+        inputin.flag_as_used("cross", "swnetcdf", "");
+        inputin.flag_as_used("cross", "swaggregate", "");
     }
 }
 
@@ -311,6 +341,107 @@ int Cross<TF>::check_save(int error, char* filename)
     }
 }
 
+// The record index follows from the output time, such that a restart overwrites the same records.
+template<typename TF>
+int Cross<TF>::get_record(const int iotime)
+{
+    return iotime / iosampletime;
+}
+
+// Copy the data with the lossy transform into the output array, if enabled for the variable.
+template<typename TF>
+bool Cross<TF>::apply_lossy(TF* const restrict out, const TF* const restrict data, const int n, const std::string& name)
+{
+    auto it_keepbits = keepbits.find(name);
+    auto it_error_bound = error_bound.find(name);
+
+    const int nkeepbits = (it_keepbits != keepbits.end()) ? it_keepbits->second : 0;
+    const TF nerror_bound = (it_error_bound != error_bound.end()) ? it_error_bound->second : TF(0);
+
+    if (nkeepbits == 0 && nerror_bound == TF(0))
+        return false;
+
+    std::copy(data, data+n, out);
+    Lossy_compression::apply(out, n, nkeepbits, nerror_bound);
+
+    return true;
+}
+
+// Gather the slices of one orientation on the first process and write them as a record of the NetCDF file.
+template<typename TF>
+void Cross<TF>::save_netcdf(
+        TF* const restrict data, const TF offset, TF* const restrict tmp,
+        const std::string& name, const std::string& mode, const std::vector<int>& slices,
+        const std::array<int,3>& loc, const int kstart, const int kend, const int iotime)
+{
+    if (slices.empty())
+        return;
+
+    auto& gd = grid.get_grid_data();
+
+    const int kmax = kend-kstart;
+    const int nslices = slices.size();
+
+    std::vector<TF> x = Netcdf_output<TF>::get_global_coordinates(gd.itot, gd.dx, loc[0]);
+    std::vector<TF> y = Netcdf_output<TF>::get_global_coordinates(gd.jtot, gd.dy, loc[1]);
+    const std::vector<TF>& z_grid = loc[2] ? gd.zh : gd.z;
+    std::vector<TF> z(z_grid.begin()+kstart, z_grid.begin()+kend);
+
+    // The sliced dimension only holds the positions of the slices, the chunks hold one slice.
+    std::vector<int> chunks;
+    if (mode == "xz")
+    {
+        std::vector<TF> y_slices;
+        for (const int j : slices)
+            y_slices.push_back(y[j]);
+        y = y_slices;
+        chunks = {kmax, 1, gd.itot};
+    }
+    else if (mode == "yz")
+    {
+        std::vector<TF> x_slices;
+        for (const int i : slices)
+            x_slices.push_back(x[i]);
+        x = x_slices;
+        chunks = {kmax, gd.jtot, 1};
+    }
+    else
+    {
+        std::vector<TF> z_slices;
+        for (const int k : slices)
+            z_slices.push_back(z_grid[k+gd.kgc]);
+        z = z_slices;
+        chunks = {1, gd.jtot, gd.itot};
+    }
+
+    auto& output = netcdf_output->get_file(
+            name, mode, iotime,
+            {{loc[2] ? "zh" : "z", z}, {loc[1] ? "yh" : "y", y}, {loc[0] ? "xh" : "x", x}},
+            chunks);
+
+    std::vector<TF> out;
+    for (int n=0; n<nslices; ++n)
+    {
+        if (mode == "xz")
+        {
+            field3d_io.gather_xz_slice(out, data, offset, tmp, slices[n], kstart, kend);
+            output.var->insert(out, {output.record, 0, n, 0}, {1, kmax, 1, gd.itot});
+        }
+        else if (mode == "yz")
+        {
+            field3d_io.gather_yz_slice(out, data, offset, tmp, slices[n], kstart, kend);
+            output.var->insert(out, {output.record, 0, 0, n}, {1, kmax, gd.jtot, 1});
+        }
+        else
+        {
+            field3d_io.gather_xy_slice(out, data, offset, tmp, slices[n]+gd.kgc);
+            output.var->insert(out, {output.record, n, 0, 0}, {1, 1, gd.jtot, gd.itot});
+        }
+    }
+
+    output.file->sync();
+}
+
 template<typename TF>
 void Cross<TF>::init()
 {
@@ -318,6 +449,16 @@ void Cross<TF>::init()
         return;
 
     isampletime = convert_to_itime(sampletime);
+
+    if (swaggregate)
+    {
+        const unsigned long iiotimeprec = convert_to_itime(std::pow(10., iotimeprec));
+        if (isampletime % iiotimeprec != 0)
+            throw std::runtime_error("Aggregated cross-sections require a sampletime that is a multiple of the IO time precision");
+        iosampletime = isampletime / iiotimeprec;
+    }
+
+    field3d_io.init();
 }
 
 template<typename TF>
@@ -581,8 +722,48 @@ int Cross<TF>::cross_simple(
 
     auto tmpfld = fields.get_tmp();
     auto tmp = tmpfld->fld.data();
+
+    auto lossyfld = fields.get_tmp();
+    if (apply_lossy(lossyfld->fld.data(), data, gd.ncells, name))
+        data = lossyfld->fld.data();
+
+    if (swnetcdf)
+    {
+        save_netcdf(data, offset, tmp, name, "xz", (loc == gd.vloc) ? jxzh : jxz, loc, gd.kstart, gd.kend, iotime);
+        save_netcdf(data, offset, tmp, name, "yz", (loc == gd.uloc) ? ixzh : ixz, loc, gd.kstart, gd.kend, iotime);
+        save_netcdf(data, offset, tmp, name, "xy", (loc == gd.wloc) ? kxyh : kxy, loc, gd.kstart, gd.kend, iotime);
+
+        fields.release_tmp(tmpfld);
+        fields.release_tmp(lossyfld);
+
+        return nerror;
+    }
+
     char locstr[4];
     std::sprintf(locstr,"%.1u%.1u%.1u",loc[0],loc[1],loc[2]);
+
+    if (swaggregate)
+    {
+        const int record = get_record(iotime);
+
+        std::sprintf(filename, "%s.%s.%s", name.c_str(), "xz", locstr);
+        nerror += check_save(field3d_io.save_xz_slices(
+                    data, offset, tmp, filename, (loc == gd.vloc) ? jxzh : jxz, gd.kstart, gd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s.%s", name.c_str(), "yz", locstr);
+        nerror += check_save(field3d_io.save_yz_slices(
+                    data, offset, tmp, filename, (loc == gd.uloc) ? ixzh : ixz, gd.kstart, gd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s.%s", name.c_str(), "xy", locstr);
+        nerror += check_save(field3d_io.save_xy_slices(
+                    data, offset, tmp, filename, (loc == gd.wloc) ? kxyh : kxy, gd.kgc, record), filename);
+
+        fields.release_tmp(tmpfld);
+        fields.release_tmp(lossyfld);
+
+        return nerror;
+    }
+
     // Loop over the index arrays to save all xz cross sections.
     if (loc == gd.vloc)
     {
@@ -641,6 +822,7 @@ int Cross<TF>::cross_simple(
         }
     }
     fields.release_tmp(tmpfld);
+    fields.release_tmp(lossyfld);
 
     return nerror;
 }
@@ -648,14 +830,45 @@ int Cross<TF>::cross_simple(
 template<typename TF>
 int Cross<TF>::cross_plane(TF* restrict data, TF restrict offset, std::string name, int iotime)
 {
+    auto& gd = grid.get_grid_data();
+
     int nerror = 0;
     char filename[256];
 
     auto tmpfld = fields.get_tmp();
     auto tmp = tmpfld->fld.data();
-    
-    std::sprintf(filename, "%s.%s.%07d", name.c_str(), "xy.000", iotime);
-    nerror += check_save(field3d_io.save_xy_slice(data, offset, tmp, filename), filename);
+
+    // The plane is stored in the tmp field after the slice, such that it can be rounded in place.
+    if (apply_lossy(tmp + gd.ijcells, data, gd.ijcells, name))
+        data = tmp + gd.ijcells;
+
+    if (swnetcdf)
+    {
+        auto& output = netcdf_output->get_file(
+                name, "xy", iotime,
+                {{"y", Netcdf_output<TF>::get_global_coordinates(gd.jtot, gd.dy, false)},
+                 {"x", Netcdf_output<TF>::get_global_coordinates(gd.itot, gd.dx, false)}},
+                {gd.jtot, gd.itot});
+
+        std::vector<TF> out;
+        field3d_io.gather_xy_slice(out, data, offset, tmp);
+        output.var->insert(out, {output.record, 0, 0}, {1, gd.jtot, gd.itot});
+        output.file->sync();
+
+        fields.release_tmp(tmpfld);
+        return nerror;
+    }
+
+    if (swaggregate)
+    {
+        std::sprintf(filename, "%s.%s", name.c_str(), "xy.000");
+        nerror += check_save(field3d_io.save_xy_slices(data, offset, tmp, filename, {0}, 0, get_record(iotime)), filename);
+    }
+    else
+    {
+        std::sprintf(filename, "%s.%s.%07d", name.c_str(), "xy.000", iotime);
+        nerror += check_save(field3d_io.save_xy_slice(data, offset, tmp, filename), filename);
+    }
     fields.release_tmp(tmpfld);
     return nerror;
 }
@@ -682,8 +895,43 @@ int Cross<TF>::cross_lngrad(TF* restrict a, std::string name, int iotime)
                 a, lngrad, gd.dxi, gd.dyi, gd.dzi4.data(),
                 gd.icells, gd.ijcells, gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend);
 
-    // loop over the index arrays to save all xz cross sections
     TF no_offset = 0;
+    if (swnetcdf)
+    {
+        const std::array<int,3> loc = {0,0,0};
+        save_netcdf(lngrad, no_offset, tmp, name, "xz", jxz, loc, gd.kstart, gd.kend, iotime);
+        save_netcdf(lngrad, no_offset, tmp, name, "yz", ixz, loc, gd.kstart, gd.kend, iotime);
+        save_netcdf(lngrad, no_offset, tmp, name, "xy", kxy, loc, gd.kstart, gd.kend, iotime);
+
+        fields.release_tmp(tmpfld);
+        fields.release_tmp(lngradfld);
+
+        return nerror;
+    }
+
+    if (swaggregate)
+    {
+        const int record = get_record(iotime);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "xz.000");
+        nerror += check_save(
+                field3d_io.save_xz_slices(lngrad, no_offset, tmp, filename, jxz, gd.kstart, gd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "yz.000");
+        nerror += check_save(
+                field3d_io.save_yz_slices(lngrad, no_offset, tmp, filename, ixz, gd.kstart, gd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "xy.000");
+        nerror += check_save(
+                field3d_io.save_xy_slices(lngrad, no_offset, tmp, filename, kxy, gd.kgc, record), filename);
+
+        fields.release_tmp(tmpfld);
+        fields.release_tmp(lngradfld);
+
+        return nerror;
+    }
+
+    // loop over the index arrays to save all xz cross sections
     for (auto& it: jxz)
     {
         std::sprintf(filename, "%s.%s.%05d.%07d", name.c_str(), "xz.000", it, iotime);
@@ -782,6 +1030,27 @@ int Cross<TF>::cross_soil(
     auto tmpfld = fields.get_tmp();
     auto tmp = tmpfld->fld.data();
 
+    if (swaggregate)
+    {
+        const int record = get_record(iotime);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "xz.000");
+        nerror += check_save(
+                field3d_io.save_xz_slices(data, no_offset, tmp, filename, jxz, sgd.kstart, sgd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "yz.000");
+        nerror += check_save(
+                field3d_io.save_yz_slices(data, no_offset, tmp, filename, ixz, sgd.kstart, sgd.kend, record), filename);
+
+        std::sprintf(filename, "%s.%s", name.c_str(), "xy.000");
+        nerror += check_save(
+                field3d_io.save_xy_slices(data, no_offset, tmp, filename, kxy_soil, sgd.kgc, record), filename);
+
+        fields.release_tmp(tmpfld);
+
+        return nerror;
+    }
+
     for (auto& it: jxz)
     {
         std::sprintf(filename, "%s.%s.%05d.%07d", name.c_str(), "xz.000", it, iotime);
@@ -21,6 +21,8 @@
  */
 
 #include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include "master.h"
@@ -30,6 +32,8 @@
 #include "timeloop.h"
 #include "constants.h"
 #include "defines.h"
+#include "lossy_compression.h"
+#include "netcdf_output.h"
 
 template<typename TF>
 Dump<TF>::Dump(Master& masterin, Grid<TF>& gridin, Fields<TF>& fieldsin, Input& inputin):
@@ -37,6 +41,7 @@ Dump<TF>::Dump(Master& masterin, Grid<TF>& gridin, Fields<TF>& fieldsin, Input&
     field3d_io(master, grid)
 {
     swdump = inputin.get_item<bool>("dump", "swdump", "", false);
+    swnetcdf = false;
 
     if (swdump)
     {
@@ -60,11 +65,72 @@ Dump<TF>::Dump(Master& masterin, Grid<TF>& gridin, Fields<TF>& fieldsin, Input&
             std::string msg = "Empty Dump list";
             throw std::runtime_error(msg);
         }
+
+        // Optional lossy compression, per variable or for all variables.
+        for (auto& var : dumplist)
+        {
+            keepbits[var] = inputin.get_item<int>("dump", "keepbits", var, 0);
+            error_bound[var] = inputin.get_item<TF>("dump", "errorbound", var, 0);
+
+            if (keepbits.at(var) < 0 || error_bound.at(var) < 0)
+                throw std::runtime_error("Illegal lossy compression settings for dump of " + var);
+        }
+
+        // Optional block averaging before writing, per variable or for all variables.
+        for (auto& var : dumplist)
+        {
+            const std::vector<int> factors = inputin.get_list<int>("dump", "coarsen", var, std::vector<int>{1, 1, 1});
+            if (factors.size() != 3 || *std::min_element(factors.begin(), factors.end()) < 1)
+                throw std::runtime_error("[dump][coarsen] of " + var + " needs three factors larger than zero");
+
+            if (factors != std::vector<int>{1, 1, 1})
+            {
+                coarsen[var] = {factors[0], factors[1], factors[2]};
+
+                if (keepbits.at(var) > 0 || error_bound.at(var) > 0)
+                    throw std::runtime_error("Block-averaged dump of " + var + " cannot be lossy");
+            }
+        }
+
+        // Optional output as NetCDF, with one file per variable and all output times as records.
+        swnetcdf = inputin.get_item<bool>("dump", "swnetcdf", "", false);
+        if (swnetcdf)
+            netcdf_output = std::make_unique<Netcdf_output<TF>>(master, inputin);
+
+        if (swnetcdf && !coarsen.empty())
+            throw std::runtime_error("Block-averaged dumps cannot be combined with swnetcdf");
+
+        // Optional region and strides, per variable or for all variables. A stride without region covers the full domain.
+        for (auto& var : dumplist)
+        {
+            const std::vector<TF> bounds = inputin.get_list<TF>("dump", "region", var, std::vector<TF>());
+            const std::vector<int> strides = inputin.get_list<int>("dump", "stride", var, std::vector<int>{1, 1, 1});
+
+            if (!bounds.empty() && bounds.size() != 6)
+                throw std::runtime_error("[dump][region] of " + var + " needs the bounds x0,x1,y0,y1,z0,z1");
+            if (strides.size() != 3 || *std::min_element(strides.begin(), strides.end()) < 1)
+                throw std::runtime_error("[dump][stride] of " + var + " needs three strides larger than zero");
+
+            if (!bounds.empty() || strides != std::vector<int>{1, 1, 1})
+            {
+                region[var] = bounds;
+                stride[var] = {strides[0], strides[1], strides[2]};
+
+                if (swnetcdf || coarsen.count(var) || keepbits.at(var) > 0 || error_bound.at(var) > 0)
+                    throw std::runtime_error("Region dump of " + var + " cannot be combined with swnetcdf, coarsen, or lossy output");
+            }
+        }
     }
     else
     {
         inputin.flag_as_used("dump", "dumplist", "");
         inputin.flag_as_used("dump", "sampletime", "");
+        inputin.flag_as_used("dump", "keepbits", "");
+        inputin.flag_as_used("dump", "errorbound", "");
+        inputin.flag_as_used("dump", "swnetcdf", "");
+        inputin.flag_as_used("dump", "coarsen", "");
+        inputin.flag_as_used("dump", "region", "");
+        inputin.flag_as_used("dump", "stride", "");
     }
 
 }
@@ -81,6 +147,19 @@ void Dump<TF>::init()
         return;
 
     isampletime = convert_to_itime(sampletime);
+
+    // Blocks span at most two processes per direction, which requires factors up to the subdomain size.
+    auto& gd = grid.get_grid_data();
+    for (auto& it : coarsen)
+    {
+        const std::array<int,3>& factors = it.second;
+        if (gd.itot % factors[0] != 0 || gd.jtot % factors[1] != 0 || gd.ktot % factors[2] != 0)
+            throw std::runtime_error("[dump][coarsen] of " + it.first + " does not divide itot, jtot, and ktot");
+        if (factors[0] > gd.imax || factors[1] > gd.jmax)
+            throw std::runtime_error("[dump][coarsen] of " + it.first + " exceeds imax or jmax");
+    }
+
+    field3d_io.init();
 }
 
 template<typename TF>
@@ -130,8 +209,27 @@ std::vector<std::string>& Dump<TF>::get_dumplist()
 }
 
 template<typename TF>
-void Dump<TF>::save_dump(TF* data, const std::string& varname, int iotime)
+void Dump<TF>::save_dump(TF* data, const std::string& varname, int iotime, const std::array<int,3>& loc)
 {
+    if (swnetcdf)
+    {
+        save_dump_netcdf(data, varname, iotime, loc);
+        return;
+    }
+
+    if (region.count(varname))
+    {
+        save_dump_region(data, varname, iotime, loc);
+        return;
+    }
+
+    auto it_coarsen = coarsen.find(varname);
+    if (it_coarsen != coarsen.end())
+    {
+        save_dump_coarse(data, varname, iotime, loc, it_coarsen->second);
+        return;
+    }
+
     auto& gd = grid.get_grid_data();
     const double no_offset = 0.;
     char filename[256];
@@ -149,21 +247,179 @@ void Dump<TF>::save_dump(TF* data, const std::string& varname, int iotime)
         auto tmp1 = fields.get_tmp();
         auto tmp2 = fields.get_tmp();
 
-        if (field3d_io.save_field3d(
+        const double wall_clock_start = master.get_wall_clock_time();
+
+        // Lossy dumps are written with a lossless compression stage; the header stores the error bounds.
+        const int nkeepbits = (keepbits.count(varname) > 0) ? keepbits.at(varname) : 0;
+        const TF nerror_bound = (error_bound.count(varname) > 0) ? error_bound.at(varname) : TF(0);
+        const bool swlossy = nkeepbits > 0 || nerror_bound > 0;
+        const int compress_level = 1;
+
+        const int error = swlossy ?
+            field3d_io.save_field3d_compressed(
+                    data, tmp1->fld.data(),
+                    filename, gd.kstart, gd.kend, compress_level,
+                    nkeepbits, nerror_bound) :
+            field3d_io.save_field3d(
                     data,
                     tmp1->fld.data(), tmp2->fld.data(),
                     filename, no_offset,
-                    gd.kstart, gd.kend))
+                    gd.kstart, gd.kend);
+
+        if (error)
         {
             master.print_message("Saving \"%s\" ... FAILED\n", filename);
             throw std::runtime_error("Writing error in dump");
         }
+        else
+            master.print_message("Saving \"%s\" ... OK (%.3f s)\n", filename, master.get_wall_clock_time() - wall_clock_start);
 
         fields.release_tmp(tmp1);
         fields.release_tmp(tmp2);
     }
 }
 
+// Write the block averages of the dump, with the factors in the file name. The vertical
+// average is weighted with the layer thickness, which differs between full and half levels.
+template<typename TF>
+void Dump<TF>::save_dump_coarse(
+        TF* data, const std::string& varname, int iotime,
+        const std::array<int,3>& loc, const std::array<int,3>& factors)
+{
+    auto& gd = grid.get_grid_data();
+    char filename[256];
+
+    std::sprintf(filename, "%s.%dx%dx%d.%07d", varname.c_str(), factors[0], factors[1], factors[2], iotime);
+    std::ifstream infile(filename);
+
+    if (infile.good())
+    {
+        master.print_message("%s already exists\n", filename);
+        return;
+    }
+
+    const double wall_clock_start = master.get_wall_clock_time();
+
+    const TF* weights = loc[2] ? gd.dzh.data() : gd.dz.data();
+    if (field3d_io.save_field3d_coarse(data, weights, filename, gd.kstart, gd.kend, factors))
+    {
+        master.print_message("Saving \"%s\" ... FAILED\n", filename);
+        throw std::runtime_error("Writing error in dump");
+    }
+    else
+        master.print_message("Saving \"%s\" ... OK (%.3f s)\n", filename, master.get_wall_clock_time() - wall_clock_start);
+}
+
+// Write every n-th point of a box of the dump. The bounds select the grid points
+// at the location of the variable, which is for staggered variables the half level.
+template<typename TF>
+void Dump<TF>::save_dump_region(TF* data, const std::string& varname, int iotime, const std::array<int,3>& loc)
+{
+    auto& gd = grid.get_grid_data();
+    char filename[256];
+
+    std::sprintf(filename, "%s.region.%07d", varname.c_str(), iotime);
+    std::ifstream infile(filename);
+
+    if (infile.good())
+    {
+        master.print_message("%s already exists\n", filename);
+        return;
+    }
+
+    const std::vector<TF>& bounds = region.at(varname);
+    const std::vector<TF>& z = loc[2] ? gd.zh : gd.z;
+
+    auto find_range = [](const TF lo, const TF hi, const TF d, const int n, const bool is_half, int& start, int& end)
+    {
+        const TF offset = is_half ? TF(0) : TF(0.5);
+        start = std::max(0, static_cast<int>(std::ceil(lo/d - offset)));
+        end   = std::min(n, static_cast<int>(std::floor(hi/d - offset)) + 1);
+    };
+
+    std::array<int,6> range = {0, gd.itot, 0, gd.jtot, gd.kstart, gd.kend};
+    if (!bounds.empty())
+    {
+        find_range(bounds[0], bounds[1], gd.dx, gd.itot, loc[0], range[0], range[1]);
+        find_range(bounds[2], bounds[3], gd.dy, gd.jtot, loc[1], range[2], range[3]);
+
+        range[4] = gd.kend;
+        range[5] = gd.kstart;
+        for (int k=gd.kstart; k<gd.kend; ++k)
+            if (z[k] >= bounds[4] && z[k] <= bounds[5])
+            {
+                range[4] = std::min(range[4], k);
+                range[5] = k+1;
+            }
+    }
+
+    if (range[1] <= range[0] || range[3] <= range[2] || range[5] <= range[4])
+        throw std::runtime_error("Region of dump of " + varname + " does not contain grid points");
+
+    const double wall_clock_start = master.get_wall_clock_time();
+
+    auto tmp = fields.get_tmp();
+    int error = field3d_io.save_field3d_region(data, tmp->fld.data(), filename, range, stride.at(varname));
+    fields.release_tmp(tmp);
+
+    // The errors are only summed over the processes in the region, so all processes have to agree on them before throwing.
+    master.sum(&error, 1);
+
+    if (error)
+    {
+        master.print_message("Saving \"%s\" ... FAILED\n", filename);
+        throw std::runtime_error("Writing error in dump");
+    }
+    else
+        master.print_message("Saving \"%s\" (i=%d:%d, j=%d:%d, k=%d:%d) ... OK (%.3f s)\n",
+                filename, range[0], range[1], range[2], range[3], range[4]-gd.kgc, range[5]-gd.kgc,
+                master.get_wall_clock_time() - wall_clock_start);
+}
+
+// Write the dump level by level through the first process, each level is a chunk of the NetCDF variable.
+template<typename TF>
+void Dump<TF>::save_dump_netcdf(TF* data, const std::string& varname, int iotime, const std::array<int,3>& loc)
+{
+    auto& gd = grid.get_grid_data();
+
+    const std::vector<TF>& z_grid = loc[2] ? gd.zh : gd.z;
+    const std::vector<TF> z(z_grid.begin()+gd.kstart, z_grid.begin()+gd.kend);
+
+    const int nkeepbits = (keepbits.count(varname) > 0) ? keepbits.at(varname) : 0;
+    const TF nerror_bound = (error_bound.count(varname) > 0) ? error_bound.at(varname) : TF(0);
+    const bool swlossy = nkeepbits > 0 || nerror_bound > 0;
+
+    // Rounded data only pays off with compression, so lossy dumps are deflated.
+    const int deflate_level = swlossy ? 1 : 0;
+
+    const double wall_clock_start = master.get_wall_clock_time();
+
+    auto& output = netcdf_output->get_file(
+            varname, "", iotime,
+            {{loc[2] ? "zh" : "z", z},
+             {loc[1] ? "yh" : "y", Netcdf_output<TF>::get_global_coordinates(gd.jtot, gd.dy, loc[1])},
+             {loc[0] ? "xh" : "x", Netcdf_output<TF>::get_global_coordinates(gd.itot, gd.dx, loc[0])}},
+            {1, gd.jtot, gd.itot}, deflate_level);
+
+    auto tmp = fields.get_tmp();
+    std::vector<TF> out;
+
+    for (int k=gd.kstart; k<gd.kend; ++k)
+    {
+        field3d_io.gather_xy_slice(out, data, TF(0), tmp->fld.data(), k);
+        if (swlossy)
+            Lossy_compression::apply(out.data(), out.size(), nkeepbits, nerror_bound);
+
+        output.var->insert(out, {output.record, k-gd.kstart, 0, 0}, {1, 1, gd.jtot, gd.itot});
+    }
+
+    output.file->sync();
+    fields.release_tmp(tmp);
+
+    master.print_message("Saving \"%s\" at time %d ... OK (%.3f s)\n",
+            varname.c_str(), iotime, master.get_wall_clock_time() - wall_clock_start);
+}
+
 
 #ifdef FLOAT_SINGLE
 template class Dump<float>;
@@ -21,24 +21,523 @@
  */
 
 #include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <iostream>
 #include <cmath>
+#include <type_traits>
+#include <zlib.h>
 #include "master.h"
 #include "grid.h"
 #include "field3d.h"
 #include "fields.h"
 #include "defines.h"
 #include "field3d_io.h"
+#include "lossy_compression.h"
+
+namespace
+{
+    // The checkpoint file starts with a header and an index entry per field, padded to the
+    // alignment. The fields follow at aligned offsets, each stored as a global (k,j,i) array.
+    constexpr char checkpoint_magic[8] = {'M', 'H', 'H', 'C', 'K', 'P', 'T', '1'};
+    constexpr int checkpoint_name_length = 64;
+
+    struct Checkpoint_header
+    {
+        char magic[8];
+        int32_t version;
+        int32_t precision;
+        int32_t itot;
+        int32_t jtot;
+        int32_t ktot;
+        int32_t nfields;
+        int64_t header_size;
+    };
+
+    struct Checkpoint_entry
+    {
+        char name[checkpoint_name_length];
+        int64_t offset;
+        int64_t nbytes;
+        uint64_t checksum;
+    };
+
+    int64_t align_up(const int64_t n, const int64_t alignment)
+    {
+        return ((n + alignment - 1) / alignment) * alignment;
+    }
+
+    // Checksum that weighs the bit pattern of each value with its global index, such that
+    // it is independent of the domain decomposition and can be summed over the processes.
+    template<typename TF>
+    uint64_t calc_checksum(
+            const TF* const restrict data,
+            const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
+            const int ioffset, const int joffset, const int itot, const int jtot,
+            const int icells, const int ijcells)
+    {
+        using Bits = typename std::conditional<sizeof(TF) == 8, uint64_t, uint32_t>::type;
+
+        uint64_t checksum = 0;
+        for (int k=kstart; k<kend; ++k)
+            for (int j=jstart; j<jend; ++j)
+                for (int i=istart; i<iend; ++i)
+                {
+                    const int ijk = i + j*icells + k*ijcells;
+                    const uint64_t index =
+                            uint64_t(i-istart+ioffset) + uint64_t(j-jstart+joffset)*itot + uint64_t(k-kstart)*itot*jtot;
+
+                    Bits bits;
+                    std::memcpy(&bits, &data[ijk], sizeof(TF));
+                    checksum += static_cast<uint64_t>(bits) * (2*index + 1);
+                }
+
+        return checksum;
+    }
+
+    // Fill the header and index of a new checkpoint. Returns false if a field name does not fit.
+    template<typename TF>
+    bool create_checkpoint_index(
+            Checkpoint_header& header, std::vector<Checkpoint_entry>& entries,
+            const std::vector<std::pair<std::string, TF*>>& fields,
+            const int itot, const int jtot, const int ktot, const int64_t alignment)
+    {
+        std::memcpy(header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+        header.version = 1;
+        header.precision = sizeof(TF);
+        header.itot = itot;
+        header.jtot = jtot;
+        header.ktot = ktot;
+        header.nfields = fields.size();
+        header.header_size = align_up(sizeof(Checkpoint_header) + fields.size()*sizeof(Checkpoint_entry), alignment);
+
+        const int64_t nbytes = int64_t(itot)*jtot*ktot*sizeof(TF);
+
+        entries.resize(fields.size());
+        for (size_t n=0; n<fields.size(); ++n)
+        {
+            if (fields[n].first.size() >= checkpoint_name_length)
+                return false;
+
+            std::memset(entries[n].name, 0, checkpoint_name_length);
+            std::strncpy(entries[n].name, fields[n].first.c_str(), checkpoint_name_length-1);
+            entries[n].offset = header.header_size + n*align_up(nbytes, alignment);
+            entries[n].nbytes = nbytes;
+            entries[n].checksum = 0;
+        }
+
+        return true;
+    }
+
+    std::vector<char> pack_checkpoint_index(const Checkpoint_header& header, const std::vector<Checkpoint_entry>& entries)
+    {
+        std::vector<char> buffer(sizeof(Checkpoint_header) + entries.size()*sizeof(Checkpoint_entry));
+        std::memcpy(buffer.data(), &header, sizeof(Checkpoint_header));
+        std::memcpy(buffer.data() + sizeof(Checkpoint_header), entries.data(), entries.size()*sizeof(Checkpoint_entry));
+        return buffer;
+    }
+
+    // Check whether the header matches the grid and precision of the run.
+    template<typename TF>
+    bool is_valid_checkpoint(const Checkpoint_header& header, const int itot, const int jtot, const int ktot)
+    {
+        return std::memcmp(header.magic, checkpoint_magic, sizeof(checkpoint_magic)) == 0
+            && header.precision == sizeof(TF)
+            && header.itot == itot && header.jtot == jtot && header.ktot == ktot;
+    }
+
+    const Checkpoint_entry* find_checkpoint_entry(const std::vector<Checkpoint_entry>& entries, const std::string& name)
+    {
+        for (auto& entry : entries)
+            if (name == entry.name)
+                return &entry;
+        return nullptr;
+    }
+
+    // Write the staged subdomains of all fields into an existing checkpoint file. This function runs in a
+    // background thread, and therefore uses plain POSIX IO on disjoint file regions instead of MPI-IO.
+    template<typename TF>
+    int write_checkpoint_blocks(
+            const std::string filename, const std::vector<Checkpoint_entry> entries, const TF* const buffer,
+            const int imax, const int jmax, const int kmax,
+            const int itot, const int jtot, const int ioffset, const int joffset)
+    {
+        const int fd = open(filename.c_str(), O_WRONLY);
+        if (fd < 0)
+            return 1;
+
+        // Without decomposition in x, the rows of one level are contiguous in the file.
+        const bool full_rows = (imax == itot);
+        const int nrows = full_rows ? 1 : jmax;
+        const size_t nbytes = (full_rows ? size_t(imax)*jmax : size_t(imax))*sizeof(TF);
+        const size_t nblock = size_t(imax)*jmax*kmax;
+
+        int nerror = 0;
+        for (size_t n=0; n<entries.size(); ++n)
+            for (int k=0; k<kmax; ++k)
+                for (int j=0; j<nrows; ++j)
+                {
+                    const char* data = reinterpret_cast<const char*>(&buffer[n*nblock + j*imax + k*imax*jmax]);
+                    off_t offset = entries[n].offset
+                        + ((int64_t(k)*jtot + j+joffset)*itot + ioffset)*int64_t(sizeof(TF));
+
+                    // Continue on partial writes.
+                    size_t nleft = nbytes;
+                    while (nleft > 0)
+                    {
+                        const ssize_t nwritten = pwrite(fd, data, nleft, offset);
+                        if (nwritten <= 0)
+                        {
+                            close(fd);
+                            return 1;
+                        }
+                        data   += nwritten;
+                        offset += nwritten;
+                        nleft  -= nwritten;
+                    }
+                }
+
+        if (close(fd))
+            ++nerror;
+
+        return nerror;
+    }
+
+    // A compressed field file consists of a header, one index entry per chunk and the compressed chunks.
+    // Each chunk holds the (k,j,i) block of one process, byte-shuffled and deflated with zlib.
+    constexpr char compressed_magic[8] = {'M', 'H', 'H', 'Z', 'L', 'I', 'B', '1'};
+
+    struct Compressed_header
+    {
+        char magic[8];
+        int32_t precision;
+        int32_t itot;
+        int32_t jtot;
+        int32_t ktot;
+        int32_t nchunks;
+        int32_t keepbits;     // Number of kept mantissa bits of lossy output, zero if lossless.
+        double error_bound;   // Absolute error bound of lossy output, zero if not bounded.
+    };
+
+    struct Compressed_chunk
+    {
+        int64_t offset;
+        int64_t nbytes;
+        int64_t nbytes_raw;
+        int32_t istart;
+        int32_t jstart;
+        int32_t isize;
+        int32_t jsize;
+    };
+
+    // Byte-shuffle the values (first all first bytes, then all second bytes, etc.) and compress them.
+    // Shuffling groups the slowly varying sign and exponent bytes, which makes them compress much better.
+    template<typename TF>
+    bool compress_chunk(std::vector<unsigned char>& out, const TF* const data, const size_t n, const int level)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        std::vector<unsigned char> shuffled(n*sizeof(TF));
+
+        for (size_t b=0; b<sizeof(TF); ++b)
+            for (size_t i=0; i<n; ++i)
+                shuffled[b*n + i] = bytes[i*sizeof(TF) + b];
+
+        uLongf nbytes = compressBound(shuffled.size());
+        out.resize(nbytes);
+
+        if (compress2(out.data(), &nbytes, shuffled.data(), shuffled.size(), level) != Z_OK)
+            return false;
+
+        out.resize(nbytes);
+        return true;
+    }
+
+    template<typename TF>
+    bool decompress_chunk(TF* const data, const std::vector<unsigned char>& in, const size_t n)
+    {
+        std::vector<unsigned char> shuffled(n*sizeof(TF));
+
+        uLongf nbytes = shuffled.size();
+        if (uncompress(shuffled.data(), &nbytes, in.data(), in.size()) != Z_OK || nbytes != shuffled.size())
+            return false;
+
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(data);
+        for (size_t b=0; b<sizeof(TF); ++b)
+            for (size_t i=0; i<n; ++i)
+                bytes[i*sizeof(TF) + b] = shuffled[b*n + i];
+
+        return true;
+    }
+
+    // Copy the part of a chunk that overlaps with the subdomain of this process into the field.
+    // This allows restarting with a different domain decomposition than the one that saved the file.
+    template<typename TF>
+    void copy_chunk_overlap(
+            TF* const restrict data, const TF* const restrict chunk, const Compressed_chunk& entry,
+            const int ioffset, const int joffset, const int imax, const int jmax,
+            const int igc, const int jgc, const int kstart, const int kmax,
+            const int icells, const int ijcells)
+    {
+        const int i0 = std::max(entry.istart, ioffset);
+        const int i1 = std::min(entry.istart + entry.isize, ioffset + imax);
+        const int j0 = std::max(entry.jstart, joffset);
+        const int j1 = std::min(entry.jstart + entry.jsize, joffset + jmax);
+
+        for (int k=0; k<kmax; ++k)
+            for (int j=j0; j<j1; ++j)
+                #pragma ivdep
+                for (int i=i0; i<i1; ++i)
+                {
+                    const int ijk  = (i-ioffset+igc) + (j-joffset+jgc)*icells + (k+kstart)*ijcells;
+                    const int ijkc = (i-entry.istart) + (j-entry.jstart)*entry.isize + k*entry.isize*entry.jsize;
+                    data[ijk] = chunk[ijkc];
+                }
+    }
+
+    bool overlaps(const Compressed_chunk& entry, const int ioffset, const int joffset, const int imax, const int jmax)
+    {
+        return entry.istart < ioffset + imax && entry.istart + entry.isize > ioffset
+            && entry.jstart < joffset + jmax && entry.jstart + entry.jsize > joffset;
+    }
+
+    // Fill the header and the index entry of the local chunk.
+    template<typename TF>
+    void create_compressed_header(
+            Compressed_header& header, const int itot, const int jtot, const int ktot, const int nchunks,
+            const int keepbits, const TF error_bound)
+    {
+        std::memcpy(header.magic, compressed_magic, sizeof(compressed_magic));
+        header.precision = sizeof(TF);
+        header.itot = itot;
+        header.jtot = jtot;
+        header.ktot = ktot;
+        header.nchunks = nchunks;
+        header.keepbits = keepbits;
+        header.error_bound = error_bound;
+    }
+
+    template<typename TF>
+    bool is_valid_compressed(const Compressed_header& header, const int itot, const int jtot, const int ktot)
+    {
+        return std::memcmp(header.magic, compressed_magic, sizeof(compressed_magic)) == 0
+            && header.precision == sizeof(TF)
+            && header.itot == itot && header.jtot == jtot && header.ktot == ktot
+            && header.nchunks > 0;
+    }
+
+    // A file with aggregated slices starts with a header and the slice indices, followed by one
+    // record per output time. Each record holds all slices as a global (slice,k,j,i) array.
+    constexpr char slices_magic[8] = {'M', 'H', 'H', 'S', 'L', 'C', 'S', '1'};
+
+    struct Slices_header
+    {
+        char magic[8];
+        int32_t precision;
+        int32_t nslices;
+        int32_t ksize;
+        int32_t jsize;
+        int32_t isize;
+        int32_t padding;
+    };
+
+    template<typename TF>
+    Slices_header create_slices_header(const int nslices, const int ksize, const int jsize, const int isize)
+    {
+        Slices_header header;
+        std::memcpy(header.magic, slices_magic, sizeof(slices_magic));
+        header.precision = sizeof(TF);
+        header.nslices = nslices;
+        header.ksize = ksize;
+        header.jsize = jsize;
+        header.isize = isize;
+        header.padding = 0;
+        return header;
+    }
+
+    bool matches_slices_header(
+            const Slices_header& header, const std::vector<int32_t>& indices,
+            const Slices_header& header_file, const std::vector<int32_t>& indices_file)
+    {
+        return std::memcmp(&header, &header_file, sizeof(Slices_header)) == 0 && indices == indices_file;
+    }
+
+    // Write one record into a new or existing file. Records of earlier output times are kept,
+    // unless the existing file holds a different set of slices.
+    template<typename TF>
+    int write_slices_record(
+            const char* filename, const Slices_header& header, const std::vector<int32_t>& indices,
+            const std::vector<TF>& record_data, const int record)
+    {
+        const long header_size = sizeof(Slices_header) + indices.size()*sizeof(int32_t);
+        const long record_size = record_data.size()*sizeof(TF);
+
+        FILE* pFile = std::fopen(filename, "r+b");
+        if (pFile != NULL)
+        {
+            Slices_header header_file;
+            std::vector<int32_t> indices_file(indices.size());
+            if (std::fread(&header_file, sizeof(Slices_header), 1, pFile) != 1
+                    || std::fread(indices_file.data(), sizeof(int32_t), indices.size(), pFile) != indices.size()
+                    || !matches_slices_header(header, indices, header_file, indices_file))
+            {
+                std::fclose(pFile);
+                return 1;
+            }
+        }
+        else
+        {
+            pFile = std::fopen(filename, "w+b");
+            if (pFile == NULL)
+                return 1;
+
+            if (std::fwrite(&header, sizeof(Slices_header), 1, pFile) != 1
+                    || std::fwrite(indices.data(), sizeof(int32_t), indices.size(), pFile) != indices.size())
+            {
+                std::fclose(pFile);
+                return 1;
+            }
+        }
+
+        int nerror = 0;
+        if (std::fseek(pFile, header_size + record*record_size, SEEK_SET))
+            ++nerror;
+        else if (std::fwrite(record_data.data(), sizeof(TF), record_data.size(), pFile) != record_data.size())
+            ++nerror;
+
+        std::fclose(pFile);
+        return nerror;
+    }
+
+    // Sum the weighted values of the subdomain per coarse block. The blocks are counted from the first
+    // block that overlaps the subdomain, blocks that straddle processes hold the partial sum of this process.
+    template<typename TF>
+    void calc_block_sums(
+            TF* const restrict sums, const TF* const restrict data, const TF* const restrict weights,
+            const int ioffset, const int joffset, const int imax, const int jmax, const int kmax,
+            const int igc, const int jgc, const int kstart, const int icells, const int ijcells,
+            const int ci, const int cj, const int ck, const int ni, const int nj)
+    {
+        const int i0 = ioffset/ci;
+        const int j0 = joffset/cj;
+
+        std::fill(sums, sums + ni*nj*(kmax/ck), TF(0));
+
+        for (int k=0; k<kmax; ++k)
+        {
+            const int kc = k/ck;
+            const TF w = weights[k+kstart];
+
+            for (int j=0; j<jmax; ++j)
+            {
+                const int jc = (j+joffset)/cj - j0;
+                for (int i=0; i<imax; ++i)
+                {
+                    const int ic = (i+ioffset)/ci - i0;
+                    const int ijk = i+igc + (j+jgc)*icells + (k+kstart)*ijcells;
+                    sums[ic + jc*ni + kc*ni*nj] += w*data[ijk];
+                }
+            }
+        }
+    }
+
+    // Divide the sums of the blocks that start in this subdomain by their total weight, and store them contiguously.
+    template<typename TF>
+    void normalize_block_sums(
+            TF* const restrict out, const TF* const restrict sums, const TF* const restrict weights,
+            const int ioffset, const int joffset, const int ni, const int nj, const int ni_own, const int nj_own,
+            const int kstart, const int kmax, const int ci, const int cj, const int ck)
+    {
+        // The first block does not start in this subdomain if the offset is not a multiple of the factor.
+        const int ishift = (ioffset % ci == 0) ? 0 : 1;
+        const int jshift = (joffset % cj == 0) ? 0 : 1;
+
+        for (int kc=0; kc<kmax/ck; ++kc)
+        {
+            TF wsum = 0;
+            for (int k=kc*ck; k<(kc+1)*ck; ++k)
+                wsum += weights[k+kstart];
+            const TF norm = TF(1) / (wsum*ci*cj);
+
+            for (int jc=0; jc<nj_own; ++jc)
+                for (int ic=0; ic<ni_own; ++ic)
+                    out[ic + jc*ni_own + kc*ni_own*nj_own] = norm * sums[(ic+ishift) + (jc+jshift)*ni + kc*ni*nj];
+        }
+    }
+
+    // Find the first and the number of the strided indices start + n*stride (n < ntot) that fall
+    // in the subdomain [offset, offset+size). The number is zero if the subdomain holds none.
+    void find_strided_range(
+            int& nfirst, int& nlocal,
+            const int start, const int stride, const int ntot, const int offset, const int size)
+    {
+        nfirst = std::max(0, (offset - start + stride - 1) / stride);
+        const int nlast = std::min(ntot-1, (offset + size - 1 - start) / stride);
+        nlocal = (offset + size - 1 < start) ? 0 : std::max(0, nlast - nfirst + 1);
+    }
+
+    // Copy the strided points of a region of the subdomain into a contiguous block.
+    template<typename TF>
+    void extract_strided_block(
+            TF* const restrict block, const TF* const restrict data,
+            const int istart, const int jstart, const int kstart,
+            const int ni, const int nj, const int nk,
+            const int si, const int sj, const int sk,
+            const int icells, const int ijcells)
+    {
+        for (int k=0; k<nk; ++k)
+            for (int j=0; j<nj; ++j)
+                for (int i=0; i<ni; ++i)
+                {
+                    const int ijk  = (istart + i*si) + (jstart + j*sj)*icells + (kstart + k*sk)*ijcells;
+                    const int ijkb = i + j*ni + k*ni*nj;
+                    block[ijkb] = data[ijk];
+                }
+    }
+
+    // Strip the ghost cells of a field into a contiguous block.
+    template<typename TF>
+    void extract_block(
+            TF* const restrict block, const TF* const restrict data,
+            const int imax, const int jmax, const int igc, const int jgc,
+            const int kstart, const int kmax, const int icells, const int ijcells)
+    {
+        for (int k=0; k<kmax; ++k)
+            for (int j=0; j<jmax; ++j)
+                #pragma ivdep
+                for (int i=0; i<imax; ++i)
+                {
+                    const int ijk  = i+igc + (j+jgc)*icells + (k+kstart)*ijcells;
+                    const int ijkb = i + j*imax + k*imax*jmax;
+                    block[ijkb] = data[ijk];
+                }
+    }
+}
 
 template<typename TF>
 Field3d_io<TF>::Field3d_io(Master& masterin, Grid<TF>& gridin) :
-    master(masterin), grid(gridin)
+    master(masterin), grid(gridin), transpose(masterin, gridin),
+    mpi_types_allocated(false)
 {
 }
 
 template<typename TF>
 Field3d_io<TF>::~Field3d_io()
 {
+    exit_mpi();
+}
+
+template<typename TF>
+void Field3d_io<TF>::init()
+{
+    // Calling init more than once is allowed, the datatypes are created only once.
+    if (mpi_types_allocated)
+        return;
+
+    transpose.init();
+    init_mpi();
 }
 
 #ifdef USEMPI
@@ -48,6 +547,154 @@ namespace
     template<typename TF> MPI_Datatype mpi_fp_type();
     template<> MPI_Datatype mpi_fp_type<double>() { return MPI_DOUBLE; }
     template<> MPI_Datatype mpi_fp_type<float>() { return MPI_FLOAT; }
+
+    template<typename TF>
+    MPI_Datatype create_subarray(const int ndims, int* totsize, int* subsize, int* substart)
+    {
+        MPI_Datatype subarray;
+        MPI_Type_create_subarray(ndims, totsize, subsize, substart, MPI_ORDER_C, mpi_fp_type<TF>(), &subarray);
+        MPI_Type_commit(&subarray);
+        return subarray;
+    }
+
+    // Sum the errors over the processes that took part in a partial write. The first process of the
+    // communicator reports a failure, because the first process of the run might not have taken part.
+    int reduce_sub_comm_errors(int nerror, MPI_Comm comm, const int mpiid, const char* filename)
+    {
+        MPI_Allreduce(MPI_IN_PLACE, &nerror, 1, MPI_INT, MPI_SUM, comm);
+
+        int comm_rank;
+        MPI_Comm_rank(comm, &comm_rank);
+        if (nerror && comm_rank == 0 && mpiid != 0)
+            std::fprintf(stderr, "Saving \"%s\" ... FAILED\n", filename);
+
+        return nerror;
+    }
+}
+
+template<typename TF>
+void Field3d_io<TF>::init_mpi()
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    // File view of a full 3d field in transposed order.
+    int totsize [3] = {gd.kmax,   gd.jtot, gd.itot};
+    int subsize [3] = {gd.kblock, gd.jmax, gd.itot};
+    int substart[3] = {md.mpicoordx*gd.kblock, md.mpicoordy*gd.jmax, 0};
+    subarray_transposed = create_subarray<TF>(3, totsize, subsize, substart);
+
+    // File view of an xy-slice.
+    int totxysize [2] = {gd.jtot, gd.itot};
+    int subxysize [2] = {gd.jmax, gd.imax};
+    int subxystart[2] = {md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
+    subarray_xy = create_subarray<TF>(2, totxysize, subxysize, subxystart);
+
+    mpi_types_allocated = true;
+
+    // Create the views with the default number of levels in advance,
+    // views with other numbers of levels are created on first use.
+    get_subarray_xz(gd.kmax);
+    get_subarray_yz(gd.kmax);
+}
+
+template<typename TF>
+void Field3d_io<TF>::exit_mpi()
+{
+    if (mpi_types_allocated)
+    {
+        MPI_Type_free(&subarray_transposed);
+        MPI_Type_free(&subarray_xy);
+
+        for (auto& it : subarrays_3d)
+            MPI_Type_free(&it.second);
+        for (auto& it : subarrays_xz)
+            MPI_Type_free(&it.second);
+        for (auto& it : subarrays_yz)
+            MPI_Type_free(&it.second);
+
+        for (auto& it : sub_comms)
+            if (it.second != MPI_COMM_NULL)
+                MPI_Comm_free(&it.second);
+        sub_comms.clear();
+
+        mpi_types_allocated = false;
+    }
+}
+
+template<typename TF>
+MPI_Datatype Field3d_io<TF>::get_subarray_3d(const int kmax)
+{
+    auto it = subarrays_3d.find(kmax);
+    if (it != subarrays_3d.end())
+        return it->second;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    int totsize [3] = {kmax, gd.jtot, gd.itot};
+    int subsize [3] = {kmax, gd.jmax, gd.imax};
+    int substart[3] = {0, md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
+    MPI_Datatype subarray = create_subarray<TF>(3, totsize, subsize, substart);
+    subarrays_3d.emplace(kmax, subarray);
+
+    return subarray;
+}
+
+template<typename TF>
+MPI_Datatype Field3d_io<TF>::get_subarray_xz(const int kmax)
+{
+    auto it = subarrays_xz.find(kmax);
+    if (it != subarrays_xz.end())
+        return it->second;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    int totxzsize [2] = {kmax, gd.itot};
+    int subxzsize [2] = {kmax, gd.imax};
+    int subxzstart[2] = {0, md.mpicoordx*gd.imax};
+    MPI_Datatype subarray = create_subarray<TF>(2, totxzsize, subxzsize, subxzstart);
+    subarrays_xz.emplace(kmax, subarray);
+
+    return subarray;
+}
+
+template<typename TF>
+MPI_Datatype Field3d_io<TF>::get_subarray_yz(const int kmax)
+{
+    auto it = subarrays_yz.find(kmax);
+    if (it != subarrays_yz.end())
+        return it->second;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    int totyzsize [2] = {kmax, gd.jtot};
+    int subyzsize [2] = {kmax, gd.jmax};
+    int subyzstart[2] = {0, md.mpicoordy*gd.jmax};
+    MPI_Datatype subarray = create_subarray<TF>(2, totyzsize, subyzsize, subyzstart);
+    subarrays_yz.emplace(kmax, subarray);
+
+    return subarray;
+}
+
+// Creating the communicator is collective over all processes, so the first call with a new
+// key has to be done by all processes. Processes without data get MPI_COMM_NULL.
+template<typename TF>
+MPI_Comm Field3d_io<TF>::get_sub_comm(const std::vector<int>& key, const bool has_data)
+{
+    auto it = sub_comms.find(key);
+    if (it != sub_comms.end())
+        return it->second;
+
+    auto& md = master.get_MPI_data();
+
+    MPI_Comm comm;
+    MPI_Comm_split(md.commxy, has_data ? 0 : MPI_UNDEFINED, md.mpiid, &comm);
+    sub_comms.emplace(key, comm);
+
+    return comm;
 }
 
 template<typename TF>
@@ -61,8 +708,6 @@ int Field3d_io<TF>::save_field3d(
     // MPI-IO is not stable on Juqueen and Supermuc otherwise
     auto& gd = grid.get_grid_data();
     auto& md = master.get_MPI_data();
-    auto tp = Transpose<TF>(master, grid);
-    tp.init();
 
     // Extract the data from the 3d field without the ghost cells
     const int jj    = gd.icells;
@@ -72,11 +717,12 @@ int Field3d_io<TF>::save_field3d(
     const int kmax  = kend-kstart;
     const int count = gd.imax*gd.jmax*kmax;
 
-    MPI_Datatype subarray;   // MPI datatype containing the dimensions of the total array that is contained in one process.
-
     // For full 3D fields, use the transposed save to increase IO performance
     bool sw_transpose = (kmax == gd.kmax) ? true : false;
 
+    // MPI datatype containing the dimensions of the total array that is contained in one process.
+    MPI_Datatype subarray = sw_transpose ? subarray_transposed : get_subarray_3d(kmax);
+
     for (int k=0; k<kmax; ++k)
         for (int j=0; j<gd.jmax; ++j)
             #pragma ivdep
@@ -87,27 +733,9 @@ int Field3d_io<TF>::save_field3d(
                 tmp1[ijkb] = data[ijk] + offset;
             }
 
+    // Transpose the 3D field
     if (sw_transpose)
-    {
-        // Transpose the 3D field
-        tp.exec_zx(tmp2, tmp1);
-
-        // Create MPI datatype for writing transposed field
-        int totsize [3] = {gd.kmax,   gd.jtot, gd.itot};
-        int subsize [3] = {gd.kblock, gd.jmax, gd.itot};
-        int substart[3] = {md.mpicoordx*gd.kblock, md.mpicoordy*gd.jmax, 0};
-        MPI_Type_create_subarray(3, totsize, subsize, substart, MPI_ORDER_C, mpi_fp_type<TF>(), &subarray);
-        MPI_Type_commit(&subarray);
-    }
-    else
-    {
-        // Create MPI datatype for writing non-transposed field
-        int totsize [3] = {kmax, gd.jtot, gd.itot};
-        int subsize [3] = {kmax, gd.jmax, gd.imax};
-        int substart[3] = {0, md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
-        MPI_Type_create_subarray(3, totsize, subsize, substart, MPI_ORDER_C, mpi_fp_type<TF>(), &subarray);
-        MPI_Type_commit(&subarray);
-    }
+        transpose.exec_zx(tmp2, tmp1);
 
     MPI_File fh;
     if (MPI_File_open(md.commxy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
@@ -134,9 +762,175 @@ int Field3d_io<TF>::save_field3d(
     if (MPI_File_close(&fh))
         return 1;
 
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_field3d_coarse(
+        TF* const restrict data, const TF* const restrict weights,
+        const char* filename, const int kstart, const int kend,
+        const std::array<int,3>& factors)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int ci = factors[0];
+    const int cj = factors[1];
+    const int ck = factors[2];
+
+    const int kmax = kend-kstart;
+    const int nk = kmax/ck;
+    const int ioffset = md.mpicoordx*gd.imax;
+    const int joffset = md.mpicoordy*gd.jmax;
+
+    // Number of coarse blocks that overlap the subdomain, and the number of blocks that start in it.
+    const int ni = (ioffset+gd.imax-1)/ci - ioffset/ci + 1;
+    const int nj = (joffset+gd.jmax-1)/cj - joffset/cj + 1;
+    const int ni_own = (ioffset+gd.imax-1)/ci - (ioffset+ci-1)/ci + 1;
+    const int nj_own = (joffset+gd.jmax-1)/cj - (joffset+cj-1)/cj + 1;
+
+    std::vector<TF> sums(ni*nj*nk);
+    calc_block_sums(
+            sums.data(), data, weights,
+            ioffset, joffset, gd.imax, gd.jmax, kmax,
+            gd.igc, gd.jgc, kstart, gd.icells, gd.ijcells,
+            ci, cj, ck, ni, nj);
+
+    // Blocks that straddle processes are completed by the process that holds their start. The partial
+    // sums are first sent west, then south, such that blocks that straddle four processes are completed too.
+    auto exchange = [&](const bool send, const bool recv, const int nsend, const int nrecv, const int nlines,
+                        auto&& index_send, auto&& index_recv)
+    {
+        std::vector<TF> send_buffer(send ? nlines*nk : 0);
+        std::vector<TF> recv_buffer(recv ? nlines*nk : 0);
+        MPI_Request reqs[2];
+        int nreqs = 0;
+
+        if (send)
+        {
+            for (int kc=0; kc<nk; ++kc)
+                for (int n=0; n<nlines; ++n)
+                    send_buffer[n + kc*nlines] = sums[index_send(n, kc)];
+            MPI_Isend(send_buffer.data(), send_buffer.size(), mpi_fp_type<TF>(), nsend, 1, md.commxy, &reqs[nreqs++]);
+        }
+
+        if (recv)
+            MPI_Irecv(recv_buffer.data(), recv_buffer.size(), mpi_fp_type<TF>(), nrecv, 1, md.commxy, &reqs[nreqs++]);
+
+        MPI_Waitall(nreqs, reqs, MPI_STATUSES_IGNORE);
+
+        if (recv)
+            for (int kc=0; kc<nk; ++kc)
+                for (int n=0; n<nlines; ++n)
+                    sums[index_recv(n, kc)] += recv_buffer[n + kc*nlines];
+    };
+
+    exchange(
+            ioffset % ci != 0, (ioffset+gd.imax) % ci != 0, md.nwest, md.neast, nj,
+            [&](const int jc, const int kc) { return 0      + jc*ni + kc*ni*nj; },
+            [&](const int jc, const int kc) { return (ni-1) + jc*ni + kc*ni*nj; });
+
+    exchange(
+            joffset % cj != 0, (joffset+gd.jmax) % cj != 0, md.nsouth, md.nnorth, ni,
+            [&](const int ic, const int kc) { return ic + 0     *ni + kc*ni*nj; },
+            [&](const int ic, const int kc) { return ic + (nj-1)*ni + kc*ni*nj; });
+
+    std::vector<TF> out(ni_own*nj_own*nk);
+    normalize_block_sums(
+            out.data(), sums.data(), weights, ioffset, joffset,
+            ni, nj, ni_own, nj_own, kstart, kmax, ci, cj, ck);
+
+    int totsize [3] = {nk, gd.jtot/cj, gd.itot/ci};
+    int subsize [3] = {nk, nj_own, ni_own};
+    int substart[3] = {0, (joffset+cj-1)/cj, (ioffset+ci-1)/ci};
+    MPI_Datatype subarray = create_subarray<TF>(3, totsize, subsize, substart);
+
+    int nerror = 0;
+
+    MPI_File fh;
+    if (MPI_File_open(md.commxy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
+        ++nerror;
+
+    char name[] = "native";
+    if (!nerror)
+        if (MPI_File_set_view(fh, 0, mpi_fp_type<TF>(), subarray, name, MPI_INFO_NULL))
+            ++nerror;
+
+    if (!nerror)
+        if (MPI_File_write_all(fh, out.data(), out.size(), mpi_fp_type<TF>(), MPI_STATUS_IGNORE))
+            ++nerror;
+
+    if (!nerror)
+        if (MPI_File_close(&fh))
+            ++nerror;
+
     MPI_Type_free(&subarray);
 
-    return 0;
+    master.sum(&nerror, 1);
+
+    return nerror;
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_field3d_region(
+        TF* const restrict data, TF* const restrict tmp, const char* filename,
+        const std::array<int,6>& range, const std::array<int,3>& strides)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int ni = (range[1]-range[0] + strides[0]-1) / strides[0];
+    const int nj = (range[3]-range[2] + strides[1]-1) / strides[1];
+    const int nk = (range[5]-range[4] + strides[2]-1) / strides[2];
+
+    int ni_first, ni_local, nj_first, nj_local;
+    find_strided_range(ni_first, ni_local, range[0], strides[0], ni, md.mpicoordx*gd.imax, gd.imax);
+    find_strided_range(nj_first, nj_local, range[2], strides[1], nj, md.mpicoordy*gd.jmax, gd.jmax);
+
+    // Only the processes that intersect the region take part in the write, the communicator is cached per region.
+    std::vector<int> key = {-1};
+    key.insert(key.end(), range.begin(), range.end());
+    key.insert(key.end(), strides.begin(), strides.end());
+
+    MPI_Comm comm = get_sub_comm(key, ni_local > 0 && nj_local > 0 && nk > 0);
+    if (comm == MPI_COMM_NULL)
+        return 0;
+
+    extract_strided_block(
+            tmp, data,
+            range[0] + ni_first*strides[0] - md.mpicoordx*gd.imax + gd.igc,
+            range[2] + nj_first*strides[1] - md.mpicoordy*gd.jmax + gd.jgc,
+            range[4],
+            ni_local, nj_local, nk, strides[0], strides[1], strides[2],
+            gd.icells, gd.ijcells);
+
+    int totsize [3] = {nk, nj, ni};
+    int subsize [3] = {nk, nj_local, ni_local};
+    int substart[3] = {0, nj_first, ni_first};
+    MPI_Datatype subarray = create_subarray<TF>(3, totsize, subsize, substart);
+
+    int nerror = 0;
+
+    MPI_File fh;
+    if (MPI_File_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
+        ++nerror;
+
+    char name[] = "native";
+    if (!nerror)
+        if (MPI_File_set_view(fh, 0, mpi_fp_type<TF>(), subarray, name, MPI_INFO_NULL))
+            ++nerror;
+
+    if (!nerror)
+        if (MPI_File_write_all(fh, tmp, ni_local*nj_local*nk, mpi_fp_type<TF>(), MPI_STATUS_IGNORE))
+            ++nerror;
+
+    if (!nerror)
+        if (MPI_File_close(&fh))
+            ++nerror;
+
+    MPI_Type_free(&subarray);
+
+    return reduce_sub_comm_errors(nerror, comm, md.mpiid, filename);
 }
 
 template<typename TF>
@@ -150,40 +944,29 @@ int Field3d_io<TF>::load_field3d(
     // MPI-IO is not stable on Juqueen and supermuc otherwise.
     auto& gd = grid.get_grid_data();
     auto& md = master.get_MPI_data();
-    auto tp = Transpose<TF>(master, grid);
-    tp.init();
-
-    MPI_Datatype subarray;   // MPI datatype containing the dimensions of the total array that is contained in one process.
 
     const int kmax = kend-kstart;
 
     // For full 3D fields, use the transposed read to increase IO performance
     bool sw_transpose = (kmax == gd.kmax) ? true : false;
 
-    if (sw_transpose)
-    {
-        // Create MPI datatype for reading transposed field
-        int totsize [3] = {gd.kmax  , gd.jtot, gd.itot};
-        int subsize [3] = {gd.kblock, gd.jmax, gd.itot};
-        int substart[3] = {md.mpicoordx*gd.kblock, md.mpicoordy*gd.jmax, 0};
-        MPI_Type_create_subarray(3, totsize, subsize, substart, MPI_ORDER_C, mpi_fp_type<TF>(), &subarray);
-        MPI_Type_commit(&subarray);
-    }
-    else
-    {
-        // Create MPI datatype for reading non-transposed field
-        int totsize [3] = {kmax, gd.jtot, gd.itot};
-        int subsize [3] = {kmax, gd.jmax, gd.imax};
-        int substart[3] = {0, md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
-        MPI_Type_create_subarray(3, totsize, subsize, substart, MPI_ORDER_C, mpi_fp_type<TF>(), &subarray);
-        MPI_Type_commit(&subarray);
-    }
+    // MPI datatype containing the dimensions of the total array that is contained in one process.
+    MPI_Datatype subarray = sw_transpose ? subarray_transposed : get_subarray_3d(kmax);
 
     // Read the file
     MPI_File fh;
     if (MPI_File_open(md.commxy, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh))
         return 1;
 
+    // A raw field has no header, so check at least that the file holds exactly one field.
+    MPI_Offset filesize;
+    if (MPI_File_get_size(fh, &filesize)
+            || filesize != MPI_Offset(gd.itot)*gd.jtot*kmax*MPI_Offset(sizeof(TF)))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
     // select noncontiguous part of 3d array to store the selected data
     MPI_Offset fileoff = 0; // the offset within the file (header size)
     char name[] = "native";
@@ -195,12 +978,18 @@ int Field3d_io<TF>::load_field3d(
     if (sw_transpose)
     {
         if (MPI_File_read_all(fh, tmp1, count, mpi_fp_type<TF>(), MPI_STATUS_IGNORE))
+        {
+            MPI_File_close(&fh);
             return 1;
+        }
     }
     else
     {
         if (MPI_File_read_all(fh, tmp2, count, mpi_fp_type<TF>(), MPI_STATUS_IGNORE))
+        {
+            MPI_File_close(&fh);
             return 1;
+        }
     }
 
     if (MPI_File_close(&fh))
@@ -208,7 +997,7 @@ int Field3d_io<TF>::load_field3d(
 
     // Transpose the 3D field
     if (sw_transpose)
-        tp.exec_xz(tmp2, tmp1);
+        transpose.exec_xz(tmp2, tmp1);
 
     const int jj  = gd.icells;
     const int kk  = gd.icells*gd.jcells;
@@ -225,9 +1014,360 @@ int Field3d_io<TF>::load_field3d(
                 data[ijk] = tmp2[ijkb] - offset;
             }
 
-    MPI_Type_free(&subarray);
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_field3d_compressed(
+        TF* const restrict data, TF* const restrict tmp,
+        const char* filename, const int kstart, const int kend, const int level,
+        const int keepbits, const TF error_bound)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+    const size_t count = size_t(gd.imax)*gd.jmax*kmax;
+
+    extract_block(tmp, data, gd.imax, gd.jmax, gd.igc, gd.jgc, kstart, kmax, gd.icells, gd.ijcells);
+    Lossy_compression::apply(tmp, count, keepbits, error_bound);
+
+    int nerror = 0;
+
+    // Every process compresses its own block.
+    std::vector<unsigned char> zbuf;
+    if (!compress_chunk(zbuf, tmp, count, level))
+        ++nerror;
+
+    master.sum(&nerror, 1);
+    if (nerror)
+        return nerror;
+
+    Compressed_chunk chunk;
+    chunk.nbytes = zbuf.size();
+    chunk.nbytes_raw = count*sizeof(TF);
+    chunk.istart = md.mpicoordx*gd.imax;
+    chunk.jstart = md.mpicoordy*gd.jmax;
+    chunk.isize = gd.imax;
+    chunk.jsize = gd.jmax;
+
+    // Gather the index and compute the offsets of the chunks.
+    std::vector<Compressed_chunk> chunks(md.nprocs);
+    MPI_Allgather(
+            &chunk, sizeof(Compressed_chunk), MPI_BYTE,
+            chunks.data(), sizeof(Compressed_chunk), MPI_BYTE, md.commxy);
+
+    int64_t offset = sizeof(Compressed_header) + md.nprocs*sizeof(Compressed_chunk);
+    for (auto& c : chunks)
+    {
+        c.offset = offset;
+        offset += c.nbytes;
+    }
+
+    Compressed_header header;
+    create_compressed_header<TF>(header, gd.itot, gd.jtot, kmax, md.nprocs, keepbits, error_bound);
+
+    MPI_File fh;
+    if (MPI_File_open(md.commxy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
+        return 1;
+
+    if (md.mpiid == 0)
+    {
+        if (MPI_File_write_at(fh, 0, &header, sizeof(Compressed_header), MPI_BYTE, MPI_STATUS_IGNORE))
+            ++nerror;
+        if (MPI_File_write_at(
+                    fh, sizeof(Compressed_header), chunks.data(),
+                    md.nprocs*sizeof(Compressed_chunk), MPI_BYTE, MPI_STATUS_IGNORE))
+            ++nerror;
+    }
+
+    if (MPI_File_write_at_all(
+                fh, chunks[md.mpiid].offset, zbuf.data(), zbuf.size(), MPI_BYTE, MPI_STATUS_IGNORE))
+        ++nerror;
+
+    if (MPI_File_close(&fh))
+        ++nerror;
+
+    master.sum(&nerror, 1);
+
+    return nerror;
+}
+
+template<typename TF>
+int Field3d_io<TF>::load_field3d_compressed(
+        TF* const restrict data, const char* filename, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+    const int ioffset = md.mpicoordx*gd.imax;
+    const int joffset = md.mpicoordy*gd.jmax;
+
+    MPI_File fh;
+    if (MPI_File_open(md.commxy, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh))
+        return 1;
+
+    Compressed_header header;
+    if (MPI_File_read_at_all(fh, 0, &header, sizeof(Compressed_header), MPI_BYTE, MPI_STATUS_IGNORE))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    if (!is_valid_compressed<TF>(header, gd.itot, gd.jtot, kmax))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    std::vector<Compressed_chunk> chunks(header.nchunks);
+    if (MPI_File_read_at_all(
+                fh, sizeof(Compressed_header), chunks.data(),
+                header.nchunks*sizeof(Compressed_chunk), MPI_BYTE, MPI_STATUS_IGNORE))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    // Every process reads and decompresses the chunks that overlap with its own subdomain.
+    int nerror = 0;
+    std::vector<unsigned char> zbuf;
+    std::vector<TF> block;
+
+    for (auto& c : chunks)
+    {
+        if (!overlaps(c, ioffset, joffset, gd.imax, gd.jmax))
+            continue;
+
+        zbuf.resize(c.nbytes);
+        block.resize(c.nbytes_raw/sizeof(TF));
+
+        if (MPI_File_read_at(fh, c.offset, zbuf.data(), c.nbytes, MPI_BYTE, MPI_STATUS_IGNORE)
+                || !decompress_chunk(block.data(), zbuf, block.size()))
+        {
+            ++nerror;
+            break;
+        }
+
+        copy_chunk_overlap(
+                data, block.data(), c, ioffset, joffset, gd.imax, gd.jmax,
+                gd.igc, gd.jgc, kstart, kmax, gd.icells, gd.ijcells);
+    }
+
+    if (MPI_File_close(&fh))
+        ++nerror;
+
+    master.sum(&nerror, 1);
+
+    return nerror;
+}
+
+template<typename TF>
+bool Field3d_io<TF>::is_compressed_field3d(const char* filename)
+{
+    auto& md = master.get_MPI_data();
+
+    MPI_File fh;
+    if (MPI_File_open(md.commxy, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh))
+        return false;
+
+    char magic[sizeof(compressed_magic)];
+    const bool has_magic =
+            !MPI_File_read_at_all(fh, 0, magic, sizeof(magic), MPI_BYTE, MPI_STATUS_IGNORE)
+            && std::memcmp(magic, compressed_magic, sizeof(compressed_magic)) == 0;
+
+    MPI_File_close(&fh);
+
+    return has_magic;
+}
+
+template<typename TF>
+void Field3d_io<TF>::gather_block(
+        std::vector<TF>& out, const TF* const restrict block,
+        const int istart, const int isize, const int jstart, const int jsize, const int ksize,
+        const int itot, const int jtot)
+{
+    auto& md = master.get_MPI_data();
+
+    // Gather the extent of the blocks, processes without data have an empty block.
+    int extent[5] = {istart, isize, jstart, jsize, ksize};
+    std::vector<int> extents(5*md.nprocs);
+    MPI_Gather(extent, 5, MPI_INT, extents.data(), 5, MPI_INT, 0, md.commxy);
+
+    std::vector<int> counts(md.nprocs);
+    std::vector<int> offsets(md.nprocs);
+    int ntot = 0;
+    int ktot = 0;
+    for (int n=0; n<md.nprocs; ++n)
+    {
+        counts[n] = extents[5*n+1]*extents[5*n+3]*extents[5*n+4];
+        offsets[n] = ntot;
+        ntot += counts[n];
+        ktot = std::max(ktot, extents[5*n+4]);
+    }
+
+    std::vector<TF> recv;
+    if (md.mpiid == 0)
+        recv.resize(ntot);
+
+    MPI_Gatherv(
+            block, isize*jsize*ksize, mpi_fp_type<TF>(),
+            recv.data(), counts.data(), offsets.data(), mpi_fp_type<TF>(), 0, md.commxy);
+
+    if (md.mpiid != 0)
+        return;
+
+    out.resize(size_t(itot)*jtot*ktot);
+
+    for (int n=0; n<md.nprocs; ++n)
+    {
+        const int i0 = extents[5*n];
+        const int ni = extents[5*n+1];
+        const int j0 = extents[5*n+2];
+        const int nj = extents[5*n+3];
+        const int nk = extents[5*n+4];
+
+        for (int k=0; k<nk; ++k)
+            for (int j=0; j<nj; ++j)
+                #pragma ivdep
+                for (int i=0; i<ni; ++i)
+                    out[(i0+i) + (j0+j)*itot + k*itot*jtot] = recv[offsets[n] + i + j*ni + k*ni*nj];
+    }
+}
+
+template<typename TF>
+int Field3d_io<TF>::write_slices(
+        const TF* const restrict buffer, const std::vector<int>& block_offsets, const int block_size,
+        const char* filename, const std::vector<int>& slices,
+        const int ksize, const int jsize, const int isize, const int record)
+{
+    auto& md = master.get_MPI_data();
+
+    const Slices_header header = create_slices_header<TF>(slices.size(), ksize, jsize, isize);
+    const std::vector<int32_t> indices(slices.begin(), slices.end());
+    const int nblocks = block_offsets.size();
+    const int nrecord = slices.size()*ksize*jsize*isize;
+
+    // Only the processes that hold a part of the slices take part in the write, the others continue.
+    // The communicator is cached per set of slices, such that it is created only at the first output.
+    std::vector<int> key = {ksize, jsize, isize};
+    key.insert(key.end(), slices.begin(), slices.end());
+
+    MPI_Comm comm = get_sub_comm(key, nblocks > 0);
+    if (comm == MPI_COMM_NULL)
+        return 0;
+
+    int comm_rank;
+    int comm_size;
+    MPI_Comm_rank(comm, &comm_rank);
+    MPI_Comm_size(comm, &comm_size);
+
+    int nerror = 0;
+
+#ifdef DISABLE_2D_MPIIO
+    // Gather the blocks with their offsets in the record on the first participating process, which writes the record.
+    std::vector<int> nblocks_all(comm_size);
+    MPI_Gather(&nblocks, 1, MPI_INT, nblocks_all.data(), 1, MPI_INT, 0, comm);
+
+    std::vector<int> block_displs(comm_size);
+    std::vector<int> counts(comm_size);
+    std::vector<int> displs(comm_size);
+    int nblocks_tot = 0;
+    for (int n=0; n<comm_size; ++n)
+    {
+        block_displs[n] = nblocks_tot;
+        counts[n] = nblocks_all[n]*block_size;
+        displs[n] = nblocks_tot*block_size;
+        nblocks_tot += nblocks_all[n];
+    }
+
+    std::vector<int> block_offsets_all;
+    std::vector<TF> recv;
+    if (comm_rank == 0)
+    {
+        block_offsets_all.resize(nblocks_tot);
+        recv.resize(nblocks_tot*block_size);
+    }
+
+    MPI_Gatherv(
+            block_offsets.data(), nblocks, MPI_INT,
+            block_offsets_all.data(), nblocks_all.data(), block_displs.data(), MPI_INT, 0, comm);
+    MPI_Gatherv(
+            buffer, nblocks*block_size, mpi_fp_type<TF>(),
+            recv.data(), counts.data(), displs.data(), mpi_fp_type<TF>(), 0, comm);
+
+    if (comm_rank == 0)
+    {
+        std::vector<TF> record_data(nrecord);
+        for (int b=0; b<nblocks_tot; ++b)
+            std::copy(recv.begin() + b*block_size, recv.begin() + (b+1)*block_size, record_data.begin() + block_offsets_all[b]);
+
+        nerror += write_slices_record(filename, header, indices, record_data, record);
+    }
+#else
+    MPI_File fh;
+    if (MPI_File_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &fh))
+        return 1;
+
+    const MPI_Offset header_size = sizeof(Slices_header) + indices.size()*sizeof(int32_t);
+    const MPI_Offset record_size = MPI_Offset(nrecord)*sizeof(TF);
+
+    // The first participating process writes the header of a new file, or checks that an existing file holds the same slices.
+    if (comm_rank == 0)
+    {
+        MPI_Offset file_size;
+        MPI_File_get_size(fh, &file_size);
+
+        if (file_size == 0)
+        {
+            if (MPI_File_write_at(fh, 0, &header, sizeof(Slices_header), MPI_BYTE, MPI_STATUS_IGNORE)
+                    || MPI_File_write_at(fh, sizeof(Slices_header), indices.data(), indices.size()*sizeof(int32_t), MPI_BYTE, MPI_STATUS_IGNORE))
+                ++nerror;
+        }
+        else
+        {
+            Slices_header header_file;
+            std::vector<int32_t> indices_file(indices.size());
+            if (file_size < header_size
+                    || MPI_File_read_at(fh, 0, &header_file, sizeof(Slices_header), MPI_BYTE, MPI_STATUS_IGNORE)
+                    || MPI_File_read_at(fh, sizeof(Slices_header), indices_file.data(), indices.size()*sizeof(int32_t), MPI_BYTE, MPI_STATUS_IGNORE)
+                    || !matches_slices_header(header, indices, header_file, indices_file))
+                ++nerror;
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &nerror, 1, MPI_INT, MPI_SUM, comm);
+    if (nerror)
+    {
+        MPI_File_close(&fh);
+        return nerror;
+    }
+
+    // Each row of a slice that this process holds is a block of the record.
+    std::vector<int> block_sizes(nblocks, block_size);
+    MPI_Datatype filetype;
+    MPI_Type_indexed(nblocks, block_sizes.data(), block_offsets.data(), mpi_fp_type<TF>(), &filetype);
+    MPI_Type_commit(&filetype);
+
+    char name[] = "native";
+    if (MPI_File_set_view(fh, header_size + record*record_size, mpi_fp_type<TF>(), filetype, name, MPI_INFO_NULL))
+        ++nerror;
+
+    // All slices of the record are written in a single collective call.
+    if (!nerror)
+        if (MPI_File_write_all(fh, buffer, nblocks*block_size, mpi_fp_type<TF>(), MPI_STATUS_IGNORE))
+            ++nerror;
+
+    if (MPI_File_close(&fh))
+        ++nerror;
+
+    MPI_Type_free(&filetype);
+#endif
+
+    nerror = reduce_sub_comm_errors(nerror, comm, md.mpiid, filename);
 
-    return 0;
+    return nerror;
 }
 
 template<typename TF>
@@ -308,22 +1448,19 @@ int Field3d_io<TF>::save_xz_slice(
             FILE *pFile;
             pFile = fopen(filename, "wbx");
             if (pFile == NULL)
-                return 1;
-
-            fwrite(recv.data(), sizeof(TF), gd.itot*kmax, pFile);
-            fclose(pFile);
+                ++nerror;
+            else
+            {
+                fwrite(recv.data(), sizeof(TF), gd.itot*kmax, pFile);
+                fclose(pFile);
+            }
         }
 #else
 //
 // Use MPI-IO to write the data from different MPI tasks into a single file
 //
-        // Create MPI datatype for XZ-slice
-        MPI_Datatype subxzslice;
-        int totxzsize [2] = {kmax, gd.itot};
-        int subxzsize [2] = {kmax, gd.imax};
-        int subxzstart[2] = {0, md.mpicoordx*gd.imax};
-        MPI_Type_create_subarray(2, totxzsize, subxzsize, subxzstart, MPI_ORDER_C, mpi_fp_type<TF>(), &subxzslice);
-        MPI_Type_commit(&subxzslice);
+        // MPI datatype for XZ-slice
+        MPI_Datatype subxzslice = get_subarray_xz(kmax);
 
         MPI_File fh;
         if (MPI_File_open(md.commx, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
@@ -348,14 +1485,11 @@ int Field3d_io<TF>::save_xz_slice(
         if (!nerror)
             if (MPI_File_close(&fh))
                 ++nerror;
-
-        MPI_Type_free(&subxzslice);
 #endif
-    }
 
-    // Gather errors from other processes
-    master.sum(&nerror,1);
-    MPI_Barrier(md.commxy);
+        // Only the processes that hold the slice take part, the others continue without waiting.
+        nerror = reduce_sub_comm_errors(nerror, md.commx, md.mpiid, filename);
+    }
 
     return nerror;
 }
@@ -438,22 +1572,19 @@ int Field3d_io<TF>::save_yz_slice(
             FILE *pFile;
             pFile = fopen(filename, "wbx");
             if (pFile == NULL)
-                return 1;
-
-            fwrite(recv.data(), sizeof(TF), gd.jtot*kmax, pFile);
-            fclose(pFile);
+                ++nerror;
+            else
+            {
+                fwrite(recv.data(), sizeof(TF), gd.jtot*kmax, pFile);
+                fclose(pFile);
+            }
         }
 #else
 //
 // Use MPI-IO to write the data from different MPI tasks into a single file
 //
-        // Create MPI datatype for YZ-slice
-        MPI_Datatype subyzslice;
-        int totyzsize [2] = {kmax, gd.jtot};
-        int subyzsize [2] = {kmax, gd.jmax};
-        int subyzstart[2] = {0, md.mpicoordy*gd.jmax};
-        MPI_Type_create_subarray(2, totyzsize, subyzsize, subyzstart, MPI_ORDER_C, mpi_fp_type<TF>(), &subyzslice);
-        MPI_Type_commit(&subyzslice);
+        // MPI datatype for YZ-slice
+        MPI_Datatype subyzslice = get_subarray_yz(kmax);
 
         MPI_File fh;
         if (MPI_File_open(md.commy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
@@ -478,14 +1609,11 @@ int Field3d_io<TF>::save_yz_slice(
         if (!nerror)
             if (MPI_File_close(&fh))
                 ++nerror;
-
-        MPI_Type_free(&subyzslice);
 #endif
-    }
 
-    // Gather errors from other processes
-    master.sum(&nerror,1);
-    MPI_Barrier(md.commxy);
+        // Only the processes that hold the slice take part, the others continue without waiting.
+        nerror = reduce_sub_comm_errors(nerror, md.commy, md.mpiid, filename);
+    }
 
     return nerror;
 }
@@ -568,13 +1696,8 @@ int Field3d_io<TF>::save_xy_slice(
 //
 // Use MPI-IO to write the data from different MPI tasks into a single file
 //
-    // Define MPI datatype for XY-slice
-    MPI_Datatype subxyslice;
-    int totxysize [2] = {gd.jtot, gd.itot};
-    int subxysize [2] = {gd.jmax, gd.imax};
-    int subxystart[2] = {md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
-    MPI_Type_create_subarray(2, totxysize, subxysize, subxystart, MPI_ORDER_C, mpi_fp_type<TF>(), &subxyslice);
-    MPI_Type_commit(&subxyslice);
+    // MPI datatype for XY-slice
+    MPI_Datatype subxyslice = subarray_xy;
 
     MPI_File fh;
     if (MPI_File_open(md.commxy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh))
@@ -596,9 +1719,6 @@ int Field3d_io<TF>::save_xy_slice(
     if (MPI_File_close(&fh))
         return 1;
 
-    MPI_Type_free(&subxyslice);
-
-    MPI_Barrier(md.commxy);
 #endif
 
     return 0;
@@ -623,13 +1743,8 @@ int Field3d_io<TF>::load_xy_slice(
 
     int count = gd.imax*gd.jmax;
 
-    // Create MPI datatype for XY-slice read
-    MPI_Datatype subxyslice;
-    int totxysize [2] = {gd.jtot, gd.itot};
-    int subxysize [2] = {gd.jmax, gd.imax};
-    int subxystart[2] = {md.mpicoordy*gd.jmax, md.mpicoordx*gd.imax};
-    MPI_Type_create_subarray(2, totxysize, subxysize, subxystart, MPI_ORDER_C, mpi_fp_type<TF>(), &subxyslice);
-    MPI_Type_commit(&subxyslice);
+    // MPI datatype for XY-slice read
+    MPI_Datatype subxyslice = subarray_xy;
 
     MPI_File fh;
     if (MPI_File_open(md.commxy, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh))
@@ -649,8 +1764,6 @@ int Field3d_io<TF>::load_xy_slice(
     if (MPI_File_close(&fh))
         return 1;
 
-    MPI_Type_free(&subxyslice);
-
     MPI_Barrier(md.commxy);
 
     for (int j=0; j<gd.jmax; j++)
@@ -666,8 +1779,233 @@ int Field3d_io<TF>::load_xy_slice(
     return 0;
 }
 
+template<typename TF>
+int Field3d_io<TF>::save_checkpoint(
+        const std::vector<std::pair<std::string, TF*>>& fields,
+        const char* filename, const int kstart, const int kend, const long alignment)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+    const int nfields = fields.size();
+
+    Checkpoint_header header;
+    std::vector<Checkpoint_entry> entries;
+    if (!create_checkpoint_index(header, entries, fields, gd.itot, gd.jtot, kmax, alignment))
+        return 1;
+
+    std::vector<uint64_t> checksums(nfields);
+    for (int n=0; n<nfields; ++n)
+        checksums[n] = calc_checksum(
+                fields[n].second, gd.istart, gd.iend, gd.jstart, gd.jend, kstart, kend,
+                md.mpicoordx*gd.imax, md.mpicoordy*gd.jmax, gd.itot, gd.jtot,
+                gd.icells, gd.ijcells);
+
+    MPI_Allreduce(MPI_IN_PLACE, checksums.data(), nfields, MPI_UINT64_T, MPI_SUM, md.commxy);
+
+    for (int n=0; n<nfields; ++n)
+        entries[n].checksum = checksums[n];
+
+    // Describe all fields in memory and in the file with a single datatype, to write all of them
+    // directly from the fields with ghost cells in one collective operation.
+    MPI_Datatype mem_subarray;
+    int memsize  [3] = {gd.kcells, gd.jcells, gd.icells};
+    int memsub   [3] = {kmax, gd.jmax, gd.imax};
+    int memstart [3] = {kstart, gd.jgc, gd.igc};
+    MPI_Type_create_subarray(3, memsize, memsub, memstart, MPI_ORDER_C, mpi_fp_type<TF>(), &mem_subarray);
+
+    MPI_Datatype file_subarray = get_subarray_3d(kmax);
+
+    std::vector<int> blocklengths(nfields, 1);
+    std::vector<MPI_Aint> mem_displs(nfields);
+    std::vector<MPI_Aint> file_displs(nfields);
+    std::vector<MPI_Datatype> mem_types(nfields, mem_subarray);
+    std::vector<MPI_Datatype> file_types(nfields, file_subarray);
+
+    for (int n=0; n<nfields; ++n)
+    {
+        MPI_Get_address(fields[n].second, &mem_displs[n]);
+        file_displs[n] = entries[n].offset;
+    }
+
+    MPI_Datatype memtype;
+    MPI_Datatype filetype;
+    MPI_Type_create_struct(nfields, blocklengths.data(), mem_displs.data(), mem_types.data(), &memtype);
+    MPI_Type_create_struct(nfields, blocklengths.data(), file_displs.data(), file_types.data(), &filetype);
+    MPI_Type_commit(&memtype);
+    MPI_Type_commit(&filetype);
+
+    int nerror = 0;
+
+    MPI_File fh;
+    const bool is_open = !MPI_File_open(
+            md.commxy, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY | MPI_MODE_EXCL, MPI_INFO_NULL, &fh);
+    if (!is_open)
+        ++nerror;
+
+    // The header and index are written by the first process.
+    if (!nerror && md.mpiid == 0)
+    {
+        std::vector<char> index = pack_checkpoint_index(header, entries);
+        if (MPI_File_write_at(fh, 0, index.data(), index.size(), MPI_BYTE, MPI_STATUS_IGNORE))
+            ++nerror;
+    }
+
+    char name[] = "native";
+    if (!nerror)
+        if (MPI_File_set_view(fh, 0, mpi_fp_type<TF>(), filetype, name, MPI_INFO_NULL))
+            ++nerror;
+
+    if (!nerror)
+        if (MPI_File_write_all(fh, MPI_BOTTOM, 1, memtype, MPI_STATUS_IGNORE))
+            ++nerror;
+
+    // Close the file also after a failed write, to not leak the handle.
+    if (is_open)
+        if (MPI_File_close(&fh))
+            ++nerror;
+
+    MPI_Type_free(&memtype);
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&mem_subarray);
+
+    master.sum(&nerror, 1);
+
+    return nerror;
+}
+
+template<typename TF>
+int Field3d_io<TF>::load_checkpoint(
+        const std::vector<std::pair<std::string, TF*>>& fields, std::vector<bool>& found,
+        const char* filename, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+
+    found.assign(fields.size(), false);
+
+    MPI_File fh;
+    if (MPI_File_open(md.commxy, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh))
+        return 1;
+
+    Checkpoint_header header;
+    if (MPI_File_read_at_all(fh, 0, &header, sizeof(Checkpoint_header), MPI_BYTE, MPI_STATUS_IGNORE))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    if (!is_valid_checkpoint<TF>(header, gd.itot, gd.jtot, kmax))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    std::vector<Checkpoint_entry> entries(header.nfields);
+    if (MPI_File_read_at_all(
+                fh, sizeof(Checkpoint_header), entries.data(),
+                header.nfields*sizeof(Checkpoint_entry), MPI_BYTE, MPI_STATUS_IGNORE))
+    {
+        MPI_File_close(&fh);
+        return 1;
+    }
+
+    // Select the requested fields that are available, in the order of the file.
+    std::vector<std::pair<const Checkpoint_entry*, int>> selection;
+    for (size_t n=0; n<fields.size(); ++n)
+    {
+        const Checkpoint_entry* entry = find_checkpoint_entry(entries, fields[n].first);
+        if (entry != nullptr)
+        {
+            selection.emplace_back(entry, n);
+            found[n] = true;
+        }
+    }
+
+    std::sort(selection.begin(), selection.end(),
+            [](const std::pair<const Checkpoint_entry*, int>& a, const std::pair<const Checkpoint_entry*, int>& b)
+            { return a.first->offset < b.first->offset; });
+
+    const int nread = selection.size();
+
+    MPI_Datatype mem_subarray;
+    int memsize  [3] = {gd.kcells, gd.jcells, gd.icells};
+    int memsub   [3] = {kmax, gd.jmax, gd.imax};
+    int memstart [3] = {kstart, gd.jgc, gd.igc};
+    MPI_Type_create_subarray(3, memsize, memsub, memstart, MPI_ORDER_C, mpi_fp_type<TF>(), &mem_subarray);
+
+    MPI_Datatype file_subarray = get_subarray_3d(kmax);
+
+    std::vector<int> blocklengths(nread, 1);
+    std::vector<MPI_Aint> mem_displs(nread);
+    std::vector<MPI_Aint> file_displs(nread);
+    std::vector<MPI_Datatype> mem_types(nread, mem_subarray);
+    std::vector<MPI_Datatype> file_types(nread, file_subarray);
+
+    for (int n=0; n<nread; ++n)
+    {
+        MPI_Get_address(fields[selection[n].second].second, &mem_displs[n]);
+        file_displs[n] = selection[n].first->offset;
+    }
+
+    MPI_Datatype memtype;
+    MPI_Datatype filetype;
+    MPI_Type_create_struct(nread, blocklengths.data(), mem_displs.data(), mem_types.data(), &memtype);
+    MPI_Type_create_struct(nread, blocklengths.data(), file_displs.data(), file_types.data(), &filetype);
+    MPI_Type_commit(&memtype);
+    MPI_Type_commit(&filetype);
+
+    int nerror = 0;
+
+    char name[] = "native";
+    if (MPI_File_set_view(fh, 0, mpi_fp_type<TF>(), filetype, name, MPI_INFO_NULL))
+        ++nerror;
+
+    if (!nerror)
+        if (MPI_File_read_all(fh, MPI_BOTTOM, 1, memtype, MPI_STATUS_IGNORE))
+            ++nerror;
+
+    if (MPI_File_close(&fh))
+        ++nerror;
+
+    MPI_Type_free(&memtype);
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&mem_subarray);
+
+    // Verify the checksums of the loaded fields.
+    std::vector<uint64_t> checksums(nread);
+    for (int n=0; n<nread; ++n)
+        checksums[n] = calc_checksum(
+                fields[selection[n].second].second, gd.istart, gd.iend, gd.jstart, gd.jend, kstart, kend,
+                md.mpicoordx*gd.imax, md.mpicoordy*gd.jmax, gd.itot, gd.jtot,
+                gd.icells, gd.ijcells);
+
+    MPI_Allreduce(MPI_IN_PLACE, checksums.data(), nread, MPI_UINT64_T, MPI_SUM, md.commxy);
+
+    for (int n=0; n<nread; ++n)
+        if (checksums[n] != selection[n].first->checksum)
+            ++nerror;
+
+    master.sum(&nerror, 1);
+
+    return nerror;
+}
+
 #else
 
+template<typename TF>
+void Field3d_io<TF>::init_mpi()
+{
+}
+
+template<typename TF>
+void Field3d_io<TF>::exit_mpi()
+{
+}
+
 template<typename TF>
 int Field3d_io<TF>::save_field3d(
         TF* const restrict data,
@@ -709,6 +2047,73 @@ int Field3d_io<TF>::save_field3d(
     return 0;
 }
 
+template<typename TF>
+int Field3d_io<TF>::save_field3d_coarse(
+        TF* const restrict data, const TF* const restrict weights,
+        const char* filename, const int kstart, const int kend,
+        const std::array<int,3>& factors)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int ci = factors[0];
+    const int cj = factors[1];
+    const int ck = factors[2];
+
+    const int kmax = kend-kstart;
+    const int ni = gd.itot/ci;
+    const int nj = gd.jtot/cj;
+
+    std::vector<TF> sums(ni*nj*(kmax/ck));
+    calc_block_sums(
+            sums.data(), data, weights,
+            0, 0, gd.imax, gd.jmax, kmax,
+            gd.igc, gd.jgc, kstart, gd.icells, gd.ijcells,
+            ci, cj, ck, ni, nj);
+
+    std::vector<TF> out(sums.size());
+    normalize_block_sums(
+            out.data(), sums.data(), weights, 0, 0,
+            ni, nj, ni, nj, kstart, kmax, ci, cj, ck);
+
+    FILE *pFile;
+    pFile = fopen(filename, "wbx");
+    if (pFile == NULL)
+        return 1;
+
+    fwrite(out.data(), sizeof(TF), out.size(), pFile);
+    fclose(pFile);
+
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_field3d_region(
+        TF* const restrict data, TF* const restrict tmp, const char* filename,
+        const std::array<int,6>& range, const std::array<int,3>& strides)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int ni = (range[1]-range[0] + strides[0]-1) / strides[0];
+    const int nj = (range[3]-range[2] + strides[1]-1) / strides[1];
+    const int nk = (range[5]-range[4] + strides[2]-1) / strides[2];
+
+    extract_strided_block(
+            tmp, data,
+            range[0] + gd.igc, range[2] + gd.jgc, range[4],
+            ni, nj, nk, strides[0], strides[1], strides[2],
+            gd.icells, gd.ijcells);
+
+    FILE *pFile;
+    pFile = fopen(filename, "wbx");
+    if (pFile == NULL)
+        return 1;
+
+    fwrite(tmp, sizeof(TF), ni*nj*nk, pFile);
+    fclose(pFile);
+
+    return 0;
+}
+
 template<typename TF>
 int Field3d_io<TF>::load_field3d(
         TF* const restrict data,
@@ -724,6 +2129,14 @@ int Field3d_io<TF>::load_field3d(
     if (pFile == NULL)
         return 1;
 
+    // A raw field has no header, so check at least that the file holds exactly one field.
+    const long filesize = long(gd.itot)*gd.jtot*(kend-kstart)*long(sizeof(TF));
+    if (fseek(pFile, 0, SEEK_END) || ftell(pFile) != filesize || fseek(pFile, 0, SEEK_SET))
+    {
+        fclose(pFile);
+        return 1;
+    }
+
     const int jj = gd.icells;
     const int kk = gd.icells*gd.jcells;
 
@@ -733,21 +2146,180 @@ int Field3d_io<TF>::load_field3d(
         {
             const int ijk = gd.istart + j*jj + k*kk;
             if( fread(&tmp1[ijk], sizeof(TF), gd.imax, pFile) != (unsigned)gd.imax )
+            {
+                fclose(pFile);
                 return 1;
+            }
+        }
+
+    fclose(pFile);
+
+    // Second, remove the offset
+    for (int k=kstart; k<kend; k++)
+        for (int j=gd.jstart; j<gd.jend; j++)
+            for (int i=gd.istart; i<gd.iend; i++)
+            {
+                const int ijk = i + j*jj + k*kk;
+                data[ijk] = tmp1[ijk] - offset;
+            }
+
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_field3d_compressed(
+        TF* const restrict data, TF* const restrict tmp,
+        const char* filename, const int kstart, const int kend, const int level,
+        const int keepbits, const TF error_bound)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int kmax = kend-kstart;
+    const size_t count = size_t(gd.imax)*gd.jmax*kmax;
+
+    extract_block(tmp, data, gd.imax, gd.jmax, gd.igc, gd.jgc, kstart, kmax, gd.icells, gd.ijcells);
+    Lossy_compression::apply(tmp, count, keepbits, error_bound);
+
+    std::vector<unsigned char> zbuf;
+    if (!compress_chunk(zbuf, tmp, count, level))
+        return 1;
+
+    Compressed_header header;
+    create_compressed_header<TF>(header, gd.itot, gd.jtot, kmax, 1, keepbits, error_bound);
+
+    Compressed_chunk chunk;
+    chunk.offset = sizeof(Compressed_header) + sizeof(Compressed_chunk);
+    chunk.nbytes = zbuf.size();
+    chunk.nbytes_raw = count*sizeof(TF);
+    chunk.istart = 0;
+    chunk.jstart = 0;
+    chunk.isize = gd.imax;
+    chunk.jsize = gd.jmax;
+
+    FILE *pFile;
+    pFile = fopen(filename, "wbx");
+
+    if (pFile == NULL)
+        return 1;
+
+    int nerror = 0;
+    if (fwrite(&header, sizeof(Compressed_header), 1, pFile) != 1)
+        ++nerror;
+    if (fwrite(&chunk, sizeof(Compressed_chunk), 1, pFile) != 1)
+        ++nerror;
+    if (fwrite(zbuf.data(), 1, zbuf.size(), pFile) != zbuf.size())
+        ++nerror;
+
+    fclose(pFile);
+
+    return nerror;
+}
+
+template<typename TF>
+int Field3d_io<TF>::load_field3d_compressed(
+        TF* const restrict data, const char* filename, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int kmax = kend-kstart;
+
+    FILE *pFile;
+    pFile = fopen(filename, "rb");
+
+    if (pFile == NULL)
+        return 1;
+
+    Compressed_header header;
+    if (fread(&header, sizeof(Compressed_header), 1, pFile) != 1
+            || !is_valid_compressed<TF>(header, gd.itot, gd.jtot, kmax))
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    std::vector<Compressed_chunk> chunks(header.nchunks);
+    if (fread(chunks.data(), sizeof(Compressed_chunk), header.nchunks, pFile) != (unsigned)header.nchunks)
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    // A file that was saved by a parallel run consists of multiple chunks.
+    int nerror = 0;
+    std::vector<unsigned char> zbuf;
+    std::vector<TF> block;
+
+    for (auto& c : chunks)
+    {
+        zbuf.resize(c.nbytes);
+        block.resize(c.nbytes_raw/sizeof(TF));
+
+        if (fseek(pFile, c.offset, SEEK_SET)
+                || fread(zbuf.data(), 1, c.nbytes, pFile) != (size_t)c.nbytes
+                || !decompress_chunk(block.data(), zbuf, block.size()))
+        {
+            ++nerror;
+            break;
         }
 
+        copy_chunk_overlap(
+                data, block.data(), c, 0, 0, gd.imax, gd.jmax,
+                gd.igc, gd.jgc, kstart, kmax, gd.icells, gd.ijcells);
+    }
+
+    fclose(pFile);
+
+    return nerror;
+}
+
+template<typename TF>
+bool Field3d_io<TF>::is_compressed_field3d(const char* filename)
+{
+    FILE *pFile;
+    pFile = fopen(filename, "rb");
+
+    if (pFile == NULL)
+        return false;
+
+    char magic[sizeof(compressed_magic)];
+    const bool has_magic =
+            fread(magic, sizeof(magic), 1, pFile) == 1
+            && std::memcmp(magic, compressed_magic, sizeof(compressed_magic)) == 0;
+
     fclose(pFile);
 
-    // Second, remove the offset
-    for (int k=kstart; k<kend; k++)
-        for (int j=gd.jstart; j<gd.jend; j++)
-            for (int i=gd.istart; i<gd.iend; i++)
-            {
-                const int ijk = i + j*jj + k*kk;
-                data[ijk] = tmp1[ijk] - offset;
-            }
+    return has_magic;
+}
 
-    return 0;
+template<typename TF>
+void Field3d_io<TF>::gather_block(
+        std::vector<TF>& out, const TF* const restrict block,
+        const int istart, const int isize, const int jstart, const int jsize, const int ksize,
+        const int itot, const int jtot)
+{
+    out.resize(size_t(itot)*jtot*ksize);
+
+    for (int k=0; k<ksize; ++k)
+        for (int j=0; j<jsize; ++j)
+            #pragma ivdep
+            for (int i=0; i<isize; ++i)
+                out[(istart+i) + (jstart+j)*itot + k*itot*jtot] = block[i + j*isize + k*isize*jsize];
+}
+
+template<typename TF>
+int Field3d_io<TF>::write_slices(
+        const TF* const restrict buffer, const std::vector<int>& block_offsets, const int block_size,
+        const char* filename, const std::vector<int>& slices,
+        const int ksize, const int jsize, const int isize, const int record)
+{
+    const Slices_header header = create_slices_header<TF>(slices.size(), ksize, jsize, isize);
+    const std::vector<int32_t> indices(slices.begin(), slices.end());
+
+    std::vector<TF> record_data(slices.size()*ksize*jsize*isize);
+    for (size_t b=0; b<block_offsets.size(); ++b)
+        std::copy(buffer + b*block_size, buffer + (b+1)*block_size, record_data.begin() + block_offsets[b]);
+
+    return write_slices_record(filename, header, indices, record_data, record);
 }
 
 template<typename TF>
@@ -898,8 +2470,427 @@ int Field3d_io<TF>::load_xy_slice(
 
     return 0;
 }
+
+template<typename TF>
+int Field3d_io<TF>::save_checkpoint(
+        const std::vector<std::pair<std::string, TF*>>& fields,
+        const char* filename, const int kstart, const int kend, const long alignment)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int kmax = kend-kstart;
+
+    Checkpoint_header header;
+    std::vector<Checkpoint_entry> entries;
+    if (!create_checkpoint_index(header, entries, fields, gd.itot, gd.jtot, kmax, alignment))
+        return 1;
+
+    for (size_t n=0; n<fields.size(); ++n)
+        entries[n].checksum = calc_checksum(
+                fields[n].second, gd.istart, gd.iend, gd.jstart, gd.jend, kstart, kend,
+                0, 0, gd.itot, gd.jtot, gd.icells, gd.ijcells);
+
+    FILE *pFile;
+    pFile = fopen(filename, "wbx");
+
+    if (pFile == NULL)
+        return 1;
+
+    std::vector<char> index = pack_checkpoint_index(header, entries);
+    if (fwrite(index.data(), 1, index.size(), pFile) != index.size())
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    const int jj = gd.icells;
+    const int kk = gd.icells*gd.jcells;
+
+    for (size_t n=0; n<fields.size(); ++n)
+    {
+        if (fseek(pFile, entries[n].offset, SEEK_SET))
+        {
+            fclose(pFile);
+            return 1;
+        }
+
+        for (int k=kstart; k<kend; ++k)
+            for (int j=gd.jstart; j<gd.jend; ++j)
+            {
+                const int ijk = gd.istart + j*jj + k*kk;
+                if (fwrite(&fields[n].second[ijk], sizeof(TF), gd.imax, pFile) != (unsigned)gd.imax)
+                {
+                    fclose(pFile);
+                    return 1;
+                }
+            }
+    }
+
+    fclose(pFile);
+
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::load_checkpoint(
+        const std::vector<std::pair<std::string, TF*>>& fields, std::vector<bool>& found,
+        const char* filename, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+
+    const int kmax = kend-kstart;
+
+    found.assign(fields.size(), false);
+
+    FILE *pFile;
+    pFile = fopen(filename, "rb");
+
+    if (pFile == NULL)
+        return 1;
+
+    Checkpoint_header header;
+    if (fread(&header, sizeof(Checkpoint_header), 1, pFile) != 1)
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    if (!is_valid_checkpoint<TF>(header, gd.itot, gd.jtot, kmax))
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    std::vector<Checkpoint_entry> entries(header.nfields);
+    if (fread(entries.data(), sizeof(Checkpoint_entry), header.nfields, pFile) != (unsigned)header.nfields)
+    {
+        fclose(pFile);
+        return 1;
+    }
+
+    const int jj = gd.icells;
+    const int kk = gd.icells*gd.jcells;
+
+    int nerror = 0;
+
+    for (size_t n=0; n<fields.size(); ++n)
+    {
+        const Checkpoint_entry* entry = find_checkpoint_entry(entries, fields[n].first);
+        if (entry == nullptr)
+            continue;
+
+        found[n] = true;
+
+        if (fseek(pFile, entry->offset, SEEK_SET))
+        {
+            fclose(pFile);
+            return 1;
+        }
+
+        for (int k=kstart; k<kend; ++k)
+            for (int j=gd.jstart; j<gd.jend; ++j)
+            {
+                const int ijk = gd.istart + j*jj + k*kk;
+                if (fread(&fields[n].second[ijk], sizeof(TF), gd.imax, pFile) != (unsigned)gd.imax)
+                {
+                    fclose(pFile);
+                    return 1;
+                }
+            }
+
+        const uint64_t checksum = calc_checksum(
+                fields[n].second, gd.istart, gd.iend, gd.jstart, gd.jend, kstart, kend,
+                0, 0, gd.itot, gd.jtot, gd.icells, gd.ijcells);
+
+        if (checksum != entry->checksum)
+            ++nerror;
+    }
+
+    fclose(pFile);
+
+    return nerror;
+}
 #endif
 
+template<typename TF>
+int Field3d_io<TF>::save_xz_slices(
+        TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const char* filename, const std::vector<int>& jslices,
+        const int kstart, const int kend, const int record)
+{
+    if (jslices.empty())
+        return 0;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+
+    // Pack the slices that this process holds, with the offset of each row in the record.
+    std::vector<int> block_offsets;
+    for (size_t n=0; n<jslices.size(); ++n)
+    {
+        if (md.mpicoordy != jslices[n]/gd.jmax)
+            continue;
+
+        const int j = jslices[n]%gd.jmax + gd.jgc;
+        for (int k=kstart; k<kend; ++k)
+        {
+            const int ijb = block_offsets.size()*gd.imax;
+            #pragma ivdep
+            for (int i=0; i<gd.imax; ++i)
+                tmp[ijb+i] = data[i+gd.igc + j*gd.icells + k*gd.ijcells] + data0;
+
+            block_offsets.push_back(md.mpicoordx*gd.imax + (k-kstart)*gd.itot + n*kmax*gd.itot);
+        }
+    }
+
+    return write_slices(tmp, block_offsets, gd.imax, filename, jslices, kmax, 1, gd.itot, record);
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_yz_slices(
+        TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const char* filename, const std::vector<int>& islices,
+        const int kstart, const int kend, const int record)
+{
+    if (islices.empty())
+        return 0;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+
+    std::vector<int> block_offsets;
+    for (size_t n=0; n<islices.size(); ++n)
+    {
+        if (md.mpicoordx != islices[n]/gd.imax)
+            continue;
+
+        const int i = islices[n]%gd.imax + gd.igc;
+        for (int k=kstart; k<kend; ++k)
+        {
+            const int ijb = block_offsets.size()*gd.jmax;
+            for (int j=0; j<gd.jmax; ++j)
+                tmp[ijb+j] = data[i + (j+gd.jgc)*gd.icells + k*gd.ijcells] + data0;
+
+            block_offsets.push_back(md.mpicoordy*gd.jmax + (k-kstart)*gd.jtot + n*kmax*gd.jtot);
+        }
+    }
+
+    return write_slices(tmp, block_offsets, gd.jmax, filename, islices, kmax, gd.jtot, 1, record);
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_xy_slices(
+        TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const char* filename, const std::vector<int>& kslices,
+        const int kstart, const int record)
+{
+    if (kslices.empty())
+        return 0;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    // Every process holds a part of each xy-slice.
+    std::vector<int> block_offsets;
+    for (size_t n=0; n<kslices.size(); ++n)
+    {
+        const int k = kslices[n] + kstart;
+        for (int j=0; j<gd.jmax; ++j)
+        {
+            const int ijb = block_offsets.size()*gd.imax;
+            #pragma ivdep
+            for (int i=0; i<gd.imax; ++i)
+                tmp[ijb+i] = data[i+gd.igc + (j+gd.jgc)*gd.icells + k*gd.ijcells] + data0;
+
+            block_offsets.push_back(md.mpicoordx*gd.imax + (md.mpicoordy*gd.jmax+j)*gd.itot + n*gd.jtot*gd.itot);
+        }
+    }
+
+    return write_slices(tmp, block_offsets, gd.imax, filename, kslices, 1, gd.jtot, gd.itot, record);
+}
+
+template<typename TF>
+void Field3d_io<TF>::gather_xz_slice(
+        std::vector<TF>& out, TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const int jslice, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+    const bool has_slice = (md.mpicoordy == jslice/gd.jmax);
+
+    if (has_slice)
+        for (int k=kstart; k<kend; ++k)
+            #pragma ivdep
+            for (int i=0; i<gd.imax; ++i)
+            {
+                const int ijk  = i+gd.igc + ((jslice%gd.jmax)+gd.jgc)*gd.icells + k*gd.ijcells;
+                const int ijkb = i + (k-kstart)*gd.imax;
+                tmp[ijkb] = data[ijk] + data0;
+            }
+
+    // Processes without the slice contribute an empty block.
+    gather_block(
+            out, tmp, md.mpicoordx*gd.imax, has_slice ? gd.imax : 0,
+            0, has_slice ? 1 : 0, has_slice ? kmax : 0, gd.itot, 1);
+}
+
+template<typename TF>
+void Field3d_io<TF>::gather_yz_slice(
+        std::vector<TF>& out, TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const int islice, const int kstart, const int kend)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    const int kmax = kend-kstart;
+    const bool has_slice = (md.mpicoordx == islice/gd.imax);
+
+    if (has_slice)
+        for (int k=kstart; k<kend; ++k)
+            #pragma ivdep
+            for (int j=0; j<gd.jmax; ++j)
+            {
+                const int ijk  = (islice%gd.imax)+gd.igc + (j+gd.jgc)*gd.icells + k*gd.ijcells;
+                const int ijkb = j + (k-kstart)*gd.jmax;
+                tmp[ijkb] = data[ijk] + data0;
+            }
+
+    // The yz-slice is gathered as a block with unit width in x.
+    gather_block(
+            out, tmp, 0, has_slice ? 1 : 0,
+            md.mpicoordy*gd.jmax, has_slice ? gd.jmax : 0, has_slice ? kmax : 0, 1, gd.jtot);
+}
+
+template<typename TF>
+void Field3d_io<TF>::gather_xy_slice(
+        std::vector<TF>& out, TF* const restrict data, const TF data0, TF* const restrict tmp,
+        const int kslice)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    for (int j=0; j<gd.jmax; ++j)
+        #pragma ivdep
+        for (int i=0; i<gd.imax; ++i)
+        {
+            const int ijk  = i+gd.igc + (j+gd.jgc)*gd.icells + kslice*gd.ijcells;
+            const int ijkb = i + j*gd.imax;
+            tmp[ijkb] = data[ijk] + data0;
+        }
+
+    gather_block(
+            out, tmp, md.mpicoordx*gd.imax, gd.imax,
+            md.mpicoordy*gd.jmax, gd.jmax, 1, gd.itot, gd.jtot);
+}
+
+template<typename TF>
+int Field3d_io<TF>::save_checkpoint_async(
+        const std::vector<std::pair<std::string, TF*>>& fields,
+        const char* filename, const int kstart, const int kend, const long alignment)
+{
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    // Only one checkpoint can be in flight, because the staging buffer is reused.
+    int nerror = finish_checkpoint_async();
+    if (nerror)
+        return nerror;
+
+    const int kmax = kend-kstart;
+    const int nfields = fields.size();
+    const int ioffset = md.mpicoordx*gd.imax;
+    const int joffset = md.mpicoordy*gd.jmax;
+
+    Checkpoint_header header;
+    std::vector<Checkpoint_entry> entries;
+    if (!create_checkpoint_index(header, entries, fields, gd.itot, gd.jtot, kmax, alignment))
+        return 1;
+
+    // Copy the fields without ghost cells into the staging buffer, so that the model can continue.
+    const int jj  = gd.icells;
+    const int kk  = gd.ijcells;
+    const int jjb = gd.imax;
+    const int kkb = gd.imax*gd.jmax;
+    const size_t nblock = size_t(gd.imax)*gd.jmax*kmax;
+
+    checkpoint_buffer.resize(nfields*nblock);
+
+    std::vector<uint64_t> checksums(nfields);
+    for (int n=0; n<nfields; ++n)
+    {
+        const TF* const restrict data = fields[n].second;
+        TF* const restrict buffer = &checkpoint_buffer[n*nblock];
+
+        for (int k=0; k<kmax; ++k)
+            for (int j=0; j<gd.jmax; ++j)
+                #pragma ivdep
+                for (int i=0; i<gd.imax; ++i)
+                {
+                    const int ijk  = i+gd.igc + (j+gd.jgc)*jj + (k+kstart)*kk;
+                    const int ijkb = i + j*jjb + k*kkb;
+                    buffer[ijkb] = data[ijk];
+                }
+
+        checksums[n] = calc_checksum(
+                fields[n].second, gd.istart, gd.iend, gd.jstart, gd.jend, kstart, kend,
+                ioffset, joffset, gd.itot, gd.jtot, gd.icells, gd.ijcells);
+    }
+
+    #ifdef USEMPI
+    MPI_Allreduce(MPI_IN_PLACE, checksums.data(), nfields, MPI_UINT64_T, MPI_SUM, md.commxy);
+    #endif
+
+    for (int n=0; n<nfields; ++n)
+        entries[n].checksum = checksums[n];
+
+    // The first process creates the file and writes the index, before any process writes data.
+    if (md.mpiid == 0)
+    {
+        FILE *pFile;
+        pFile = fopen(filename, "wbx");
+
+        if (pFile == NULL)
+            ++nerror;
+        else
+        {
+            std::vector<char> index = pack_checkpoint_index(header, entries);
+            if (fwrite(index.data(), 1, index.size(), pFile) != index.size())
+                ++nerror;
+            fclose(pFile);
+        }
+    }
+
+    master.sum(&nerror, 1);
+    if (nerror)
+        return nerror;
+
+    checkpoint_writer = std::async(
+            std::launch::async, write_checkpoint_blocks<TF>,
+            std::string(filename), entries, checkpoint_buffer.data(),
+            gd.imax, gd.jmax, kmax, gd.itot, gd.jtot, ioffset, joffset);
+
+    return 0;
+}
+
+template<typename TF>
+int Field3d_io<TF>::finish_checkpoint_async()
+{
+    int nerror = 0;
+
+    if (checkpoint_writer.valid())
+    {
+        nerror = checkpoint_writer.get();
+        master.sum(&nerror, 1);
+    }
+
+    return nerror;
+}
 
 #ifdef FLOAT_SINGLE
 template class Field3d_io<float>;
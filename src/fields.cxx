@@ -392,6 +392,24 @@ Fields<TF>::Fields(Master& masterin, Grid<TF>& gridin, Soil_grid<TF>& soilgridin
     // obligatory parameters
     visc = input.get_item<TF>("fields", "visc", "");
 
+    // Optional single-file checkpoints for the restart fields.
+    swcheckpoint = input.get_item<bool>("fields", "swcheckpoint", "", false);
+    checkpoint_align = input.get_item<int>("fields", "checkpointalign", "", 1048576);
+    if (checkpoint_align < 1)
+        throw std::runtime_error("Checkpoint alignment should be at least one byte");
+
+    swcheckpointasync = input.get_item<bool>("fields", "swcheckpointasync", "", false);
+    if (swcheckpointasync && !swcheckpoint)
+        throw std::runtime_error("Asynchronous checkpoints require swcheckpoint=1");
+
+    // Optional lossless compression of the restart files.
+    swcompress = input.get_item<bool>("fields", "swcompress", "", false);
+    compress_level = input.get_item<int>("fields", "compresslevel", "", 1);
+    if (swcompress && swcheckpoint)
+        throw std::runtime_error("Compressed restart files cannot be combined with swcheckpoint=1");
+    if (compress_level < 1 || compress_level > 9)
+        throw std::runtime_error("Compression level should be between 1 and 9");
+
     const std::string group_name = "default";
 
     // Initialize the passive scalars
@@ -437,6 +455,7 @@ void Fields<TF>::init(Input& input, Dump<TF>& dump, Cross<TF>& cross, const Sim_
     auto& gd = grid.get_grid_data();
 
     boundary_cyclic.init();
+    field3d_io.init();
 
     int nerror = 0;
     // ALLOCATE ALL THE FIELDS
@@ -1232,6 +1251,47 @@ void Fields<TF>::save(int n)
     auto& gd = grid.get_grid_data();
     const TF no_offset = 0.;
 
+    const double wall_clock_start = master.get_wall_clock_time();
+
+    if (swcheckpoint)
+    {
+        std::vector<std::pair<std::string, TF*>> fields;
+        for (auto& f : ap)
+            fields.emplace_back(f.second->name, f.second->fld.data());
+
+        char filename[256];
+        std::sprintf(filename, "%s.%07d", "fields", n);
+
+        // The fields are stored without offset, to keep the restarts bitwise identical.
+        if (swcheckpointasync)
+        {
+            // Complete the previous checkpoint first, such that its errors are reported.
+            flush_checkpoint();
+
+            master.print_message("Staging \"%s\" ... ", filename);
+            if (field3d_io.save_checkpoint_async(fields, filename, gd.kstart, gd.kend, checkpoint_align))
+            {
+                master.print_message("FAILED\n");
+                throw std::runtime_error("Error saving 3D fields");
+            }
+            else
+                master.print_message("OK (%.3f s)\n", master.get_wall_clock_time() - wall_clock_start);
+        }
+        else
+        {
+            master.print_message("Saving \"%s\" ... ", filename);
+            if (field3d_io.save_checkpoint(fields, filename, gd.kstart, gd.kend, checkpoint_align))
+            {
+                master.print_message("FAILED\n");
+                throw std::runtime_error("Error saving 3D fields");
+            }
+            else
+                master.print_message("OK (%.3f s)\n", master.get_wall_clock_time() - wall_clock_start);
+        }
+
+        return;
+    }
+
     auto tmp1 = get_tmp();
     auto tmp2 = get_tmp();
 
@@ -1243,11 +1303,17 @@ void Fields<TF>::save(int n)
         master.print_message("Saving \"%s\" ... ", filename);
 
         // The offset is kept at zero, because otherwise bitwise identical restarts are not possible.
-        if (field3d_io.save_field3d(
+        const int error = swcompress ?
+            field3d_io.save_field3d_compressed(
+                    f.second->fld.data(), tmp1->fld.data(),
+                    filename, gd.kstart, gd.kend, compress_level) :
+            field3d_io.save_field3d(
                     f.second->fld.data(),
                     tmp1->fld.data(), tmp2->fld.data(),
                     filename, no_offset,
-                    gd.kstart, gd.kend))
+                    gd.kstart, gd.kend);
+
+        if (error)
         {
             master.print_message("FAILED\n");
             ++nerror;
@@ -1265,6 +1331,23 @@ void Fields<TF>::save(int n)
 
     if (nerror)
         throw std::runtime_error("Error saving 3D fields");
+
+    master.print_message("Saved 3D fields in %.3f s\n", master.get_wall_clock_time() - wall_clock_start);
+}
+
+template<typename TF>
+void Fields<TF>::flush_checkpoint()
+{
+    // All processes start and finish their writes together, so they agree on whether one is in flight.
+    if (!swcheckpointasync || !field3d_io.checkpoint_in_flight())
+        return;
+
+    const double wall_clock_start = master.get_wall_clock_time();
+
+    if (field3d_io.finish_checkpoint_async())
+        throw std::runtime_error("Error writing asynchronous checkpoint");
+
+    master.print_message("Waited %.3f s for checkpoint writer\n", master.get_wall_clock_time() - wall_clock_start);
 }
 
 template<typename TF>
@@ -1273,23 +1356,60 @@ void Fields<TF>::load(int n)
     auto& gd = grid.get_grid_data();
     const TF no_offset = 0.;
 
+    const double wall_clock_start = master.get_wall_clock_time();
+
     auto tmp1 = get_tmp();
     auto tmp2 = get_tmp();
 
     int nerror = 0;
 
+    // Load the fields from the checkpoint file if present. Fields that are not in
+    // the checkpoint are read from the individual field files.
+    std::vector<bool> in_checkpoint(ap.size(), false);
+    if (swcheckpoint)
+    {
+        std::vector<std::pair<std::string, TF*>> fields;
+        for (auto& f : ap)
+            fields.emplace_back(f.second->name, f.second->fld.data());
+
+        char filename[256];
+        std::sprintf(filename, "%s.%07d", "fields", n);
+        master.print_message("Loading \"%s\" ... ", filename);
+
+        if (field3d_io.load_checkpoint(fields, in_checkpoint, filename, gd.kstart, gd.kend))
+        {
+            master.print_message("FAILED, falling back to field files\n");
+            in_checkpoint.assign(ap.size(), false);
+        }
+        else
+            master.print_message("OK\n");
+    }
+
+    int nfield = 0;
     for (auto& f : ap)
     {
+        if (in_checkpoint[nfield++])
+            continue;
+
         // The offset is kept at zero, otherwise bitwise identical restarts is not possible.
         char filename[256];
         std::sprintf(filename, "%s.%07d", f.second->name.c_str(), n);
         master.print_message("Loading \"%s\" ... ", filename);
 
-        if (field3d_io.load_field3d(
+        // Compressed files are recognized by their header, independent of swcompress, such that
+        // runs can restart from either format. A corrupt compressed file is an error.
+        int load_error = 0;
+        if (field3d_io.is_compressed_field3d(filename))
+            load_error = field3d_io.load_field3d_compressed(
+                    f.second->fld.data(), filename, gd.kstart, gd.kend);
+        else
+            load_error = field3d_io.load_field3d(
                     f.second->fld.data(),
                     tmp1->fld.data(), tmp2->fld.data(),
                     filename, no_offset,
-                    gd.kstart, gd.kend))
+                    gd.kstart, gd.kend);
+
+        if (load_error)
         {
             master.print_message("FAILED\n");
             ++nerror;
@@ -1324,6 +1444,8 @@ void Fields<TF>::load(int n)
 
     if (nerror)
         throw std::runtime_error("Error loading fields");
+
+    master.print_message("Loaded 3D fields in %.3f s\n", master.get_wall_clock_time() - wall_clock_start);
 }
 
 #ifndef USECUDA
@@ -1430,7 +1552,7 @@ template<typename TF>
 void Fields<TF>::exec_dump(Dump<TF>& dump, unsigned long iotime)
 {
     for (auto& it : dumplist)
-        dump.save_dump(a.at(it)->fld.data(), a.at(it)->name, iotime);
+        dump.save_dump(a.at(it)->fld.data(), a.at(it)->name, iotime, a.at(it)->loc);
 }
 
 #ifndef USECUDA
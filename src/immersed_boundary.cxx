@@ -709,6 +709,8 @@ void Immersed_boundary<TF>::init(Input& inputin, Cross<TF>& cross)
         k_dem.resize(gd.ijcells);
     }
 
+    field3d_io.init();
+
     // Process the boundary conditions for scalars
     if (fields.sp.size() > 0)
     {
@@ -50,6 +50,27 @@ Microphys_type Microphys<TF>::get_switch()
     return swmicrophys;
 }
 
+template<typename TF>
+Sedimentation_type Microphys<TF>::read_sedimentation_type(Input& inputin)
+{
+    const std::string swsedimentation = inputin.get_item<std::string>("micro", "swsedimentation", "", "ss08");
+
+    if (swsedimentation == "ss08")
+        return Sedimentation_type::SS08;
+    else if (swsedimentation == "remap")
+    {
+        #ifdef USECUDA
+        throw std::runtime_error("swsedimentation=remap is not supported on the GPU");
+        #endif
+        return Sedimentation_type::Remap;
+    }
+    else
+    {
+        std::string msg = swsedimentation + " is an illegal value for swsedimentation";
+        throw std::runtime_error(msg);
+    }
+}
+
 template<typename TF>
 std::shared_ptr<Microphys<TF>> Microphys<TF>::factory(Master& masterin, Grid<TF>& gridin, Fields<TF>& fieldsin, Input& inputin)
 {
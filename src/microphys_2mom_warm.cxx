@@ -39,6 +39,7 @@
 #include "constants.h"
 #include "microphys.h"
 #include "microphys_2mom_warm.h"
+#include "microphys_sedi_remap.h"
 
 namespace
 {
@@ -85,6 +86,89 @@ namespace
 
 }
 
+// Process rates of a single grid point, shared by the kernels of the
+// individual processes and the fused kernel.
+namespace mp_rates
+{
+    namespace fm = Fast_math;
+
+    template<typename TF> constexpr TF x_star      = 2.6e-10;  // SB06, list of symbols, same as UCLA-LES
+    template<typename TF> constexpr TF lambda_evap = 1.;       // 1.0 in UCLA, 0.7 in DALES
+
+    // Autoconversion: formation of rain drop by coagulating cloud droplets
+    template<typename TF>
+    inline TF autoconversion(const TF ql, const TF qr, const TF rho, const TF nc)
+    {
+        const TF k_cc   = 9.44e9;        // UCLA-LES (Long, 1974), 4.44e9 in SB06, p48
+        const TF nu_c   = 1;             // SB06, Table 1., same as UCLA-LES
+        const TF kccxs  = k_cc / (TF(20.) * x_star<TF>) * (nu_c+2)*(nu_c+4) / fm::pow2(nu_c+1);
+
+        const TF xc      = rho * ql / nc;    // Mean mass of cloud drops [kg]
+        const TF tau     = TF(1.) - ql / (ql + qr + dsmall);    // SB06, Eq 5
+        const TF phi_au  = TF(600.) * fm::pow(tau, TF(0.68)) * fm::pow3(TF(1.) - fm::pow(tau, TF(0.68)));    // UCLA-LES
+
+        return rho_0<TF> * kccxs * fm::pow2(ql) * fm::pow2(xc) *
+                   (TF(1.) + phi_au / fm::pow2(TF(1.)-tau)); // SB06, eq 4
+    }
+
+    // Accretion: growth of raindrops collecting cloud droplets
+    template<typename TF>
+    inline TF accretion(const TF ql, const TF qr, const TF rho)
+    {
+        const TF k_cr = 5.25; // SB06, p49
+
+        const TF tau     = TF(1.) - ql / (ql + qr); // SB06, Eq 5
+        const TF phi_ac  = fm::pow4(tau / (tau + TF(5e-5))); // SB06, Eq 8
+
+        return k_cr * ql *  qr * phi_ac * sqrt(rho_0<TF> / rho); // SB06, Eq 7
+    }
+
+    // Evaporation: evaporation of rain drops in unsaturated environment
+    template<typename TF>
+    inline TF evaporation(const TF nr, const TF ql, const TF qt, const TF thl,
+                          const TF rho, const TF exner, const TF p, const TF dr)
+    {
+        const TF T   = thl * exner + (Lv<TF> * ql) / (cp<TF> * exner); // Absolute temperature [K]
+        const TF Glv = TF(1.) / (Rv<TF> * T / (esat_liq(T) * D_v<TF>) +
+                           (Lv<TF> / (K_t<TF> * T)) * (Lv<TF> / (Rv<TF> * T) - TF(1.))); // Cond/evap rate (kg m-1 s-1)?
+
+        const TF S   = (qt - ql) / qsat_liq(p, T) - TF(1.); // Saturation
+        const TF F   = 1.; // Evaporation excludes ventilation term from SB06 (like UCLA, unimportant term? TODO: test)
+
+        return TF(2.) * pi<TF> * dr * Glv * S * F * nr / rho;
+    }
+
+    // Selfcollection: growth of raindrops by mutual (rain-rain) coagulation
+    template<typename TF>
+    inline TF selfcollection(const TF qr, const TF nr, const TF rho, const TF lambdar)
+    {
+        const TF k_rr     = 7.12;   // SB06, p49
+        const TF kappa_rr = 60.7;   // SB06, p49
+
+        return -k_rr * nr * qr*rho / fm::pow9(TF(1.) + kappa_rr /
+               lambdar * pow(pirhow<TF>, TF(1.)/TF(3.))) * sqrt(rho_0<TF> / rho);
+    }
+
+    // Breakup: ratio of breakup and (minus) selfcollection rate, valid for Dr > 0.35e-3
+    template<typename TF>
+    inline TF breakup_factor(const TF dr)
+    {
+        const TF D_eq     = 0.9e-3; // SB06, list of symbols
+        const TF k_br1    = 1.0e3;  // SB06, p50, for 0.35e-3 <= Dr <= D_eq
+        const TF k_br2    = 2.3e3;  // SB06, p50, for Dr > D_eq
+
+        const TF dDr = dr - D_eq;
+
+        TF phi_br;
+        if (dr <= D_eq)
+            phi_br = k_br1 * dDr;
+        else
+            phi_br = TF(2.) * fm::exp(k_br2 * dDr) - TF(1.);
+
+        return phi_br + TF(1.);
+    }
+}
+
 // Microphysics calculated over entire 3D field
 namespace mp3d
 {
@@ -96,31 +180,23 @@ namespace mp3d
                         TF* const restrict qtt, TF* const restrict thlt,
                         const TF* const restrict qr,  const TF* const restrict ql,
                         const TF* const restrict rho, const TF* const restrict exner, const TF nc,
-                        const int istart, const int jstart, const int kstart,
-                        const int iend,   const int jend,   const int kend,
-                        const int jj, const int kk)
+                        const Microphys_active_columns& cloud_columns, const int kk)
     {
-        const TF x_star = 2.6e-10;       // SB06, list of symbols, same as UCLA-LES
-        const TF k_cc   = 9.44e9;        // UCLA-LES (Long, 1974), 4.44e9 in SB06, p48
-        const TF nu_c   = 1;             // SB06, Table 1., same as UCLA-LES
-        const TF kccxs  = k_cc / (TF(20.) * x_star) * (nu_c+2)*(nu_c+4) / fm::pow2(nu_c+1);
+        using mp_rates::x_star;
 
-        for (int k=kstart; k<kend; k++)
-            for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
+        const Microphys_active_columns& c = cloud_columns;
+
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=0; n<c.size(); n++)
+                if (k >= c.kbot[n] && k < c.ktop[n])
                 {
-                    const int ijk = i + j*jj + k*kk;
+                    const int ijk = c.ij[n] + k*kk;
                     if (ql[ijk] > ql_min<TF>)
                     {
-                        const TF xc      = rho[k] * ql[ijk] / nc;    // Mean mass of cloud drops [kg]
-                        const TF tau     = TF(1.) - ql[ijk] / (ql[ijk] + qr[ijk] + dsmall);    // SB06, Eq 5
-                        const TF phi_au  = TF(600.) * pow(tau, TF(0.68)) * fm::pow3(TF(1.) - pow(tau, TF(0.68)));    // UCLA-LES
-                        const TF au_tend = rho_0<TF> * kccxs * fm::pow2(ql[ijk]) * fm::pow2(xc) *
-                                               (TF(1.) + phi_au / fm::pow2(TF(1.)-tau)); // SB06, eq 4
+                        const TF au_tend = mp_rates::autoconversion(ql[ijk], qr[ijk], rho[k], nc);
 
                         qrt[ijk]  += au_tend;
-                        nrt[ijk]  += au_tend * rho[k] / x_star;
+                        nrt[ijk]  += au_tend * rho[k] / x_star<TF>;
                         qtt[ijk]  -= au_tend;
                         thlt[ijk] += Lv<TF> / (cp<TF> * exner[k]) * au_tend;
                     }
@@ -132,23 +208,19 @@ namespace mp3d
     void accretion(TF* const restrict qrt, TF* const restrict qtt, TF* const restrict thlt,
                    const TF* const restrict qr,  const TF* const restrict ql,
                    const TF* const restrict rho, const TF* const restrict exner,
-                   const int istart, const int jstart, const int kstart,
-                   const int iend,   const int jend,   const int kend,
-                   const int jj, const int kk)
+                   const Microphys_active_columns& cloud_columns, const int kk)
     {
-        const TF k_cr = 5.25; // SB06, p49
+        // Accretion requires both cloud and rain, so the cloud columns suffice.
+        const Microphys_active_columns& c = cloud_columns;
 
-        for (int k=kstart; k<kend; k++)
-            for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=0; n<c.size(); n++)
+                if (k >= c.kbot[n] && k < c.ktop[n])
                 {
-                    const int ijk = i + j*jj + k*kk;
+                    const int ijk = c.ij[n] + k*kk;
                     if (ql[ijk] > ql_min<TF> && qr[ijk] > qr_min<TF>)
                     {
-                        const TF tau     = TF(1.) - ql[ijk] / (ql[ijk] + qr[ijk]); // SB06, Eq 5
-                        const TF phi_ac  = fm::pow4(tau / (tau + TF(5e-5))); // SB06, Eq 8
-                        const TF ac_tend = k_cr * ql[ijk] *  qr[ijk] * phi_ac * sqrt(rho_0<TF> / rho[k]); // SB06, Eq 7
+                        const TF ac_tend = mp_rates::accretion(ql[ijk], qr[ijk], rho[k]);
 
                         qrt[ijk]  += ac_tend;
                         qtt[ijk]  -= ac_tend;
@@ -190,7 +262,7 @@ namespace mp3d
                         const TF mur     = calc_mu_r(dr);
                         const TF lambdar = calc_lambda_r(mur, dr);
 
-                        w_qr[ijk] = std::min(w_max, std::max(TF(0.1), a_R - b_R * TF(pow(TF(1.) + c_R/lambdar, TF(-1.)*(mur+TF(4.))))));
+                        w_qr[ijk] = std::min(w_max, std::max(TF(0.1), a_R - b_R * fm::pow(TF(1.) + c_R/lambdar, TF(-1.)*(mur+TF(4.)))));
                     }
                     else
                     {
@@ -239,23 +311,35 @@ namespace mp2d
 {
     namespace fm = Fast_math;
 
+    // Set the surface rain rate of a slice without rain
+    template<typename TF>
+    void zero_rain_rate_slice(TF* const restrict rr_bot,
+                              const int istart, const int iend,
+                              const int icells, const int j)
+    {
+        for (int i=istart; i<iend; i++)
+            rr_bot[i + j*icells] = TF(0.);
+    }
+
     // Calculate microphysics properties which are used in multiple routines
     template<typename TF>
     void prepare_microphysics_slice(TF* const restrict rain_mass, TF* const restrict rain_diameter,
                                     TF* const restrict mu_r, TF* const restrict lambda_r,
                                     const TF* const restrict qr, const TF* const restrict nr,
                                     const TF* const restrict rho,
-                                    const int istart, const int iend,
-                                    const int kstart, const int kend,
+                                    const Microphys_active_columns& rain_columns,
                                     const int icells, const int ijcells, const int j)
     {
+        const Microphys_active_columns& c = rain_columns;
 
-        for (int k=kstart; k<kend; k++)
-            #pragma ivdep
-            for (int i=istart; i<iend; i++)
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=c.jbeg[j]; n<c.jbeg[j+1]; n++)
             {
-                const int ijk = i + j*icells + k*ijcells;
-                const int ik  = i + k*icells;
+                if (k < c.kbot[n] || k >= c.ktop[n])
+                    continue;
+
+                const int ijk = c.ij[n] + k*ijcells;
+                const int ik  = c.ij[n] - j*icells + k*icells;
 
                 if (qr[ijk] > qr_min<TF>)
                 {
@@ -282,35 +366,32 @@ namespace mp2d
                      const TF* const restrict ql, const TF* const restrict qt, const TF* const restrict thl,
                      const TF* const restrict rho, const TF* const restrict exner, const TF* const restrict p,
                      const TF* const restrict rain_mass, const TF* const restrict rain_diameter,
-                     const int istart, const int jstart, const int kstart,
-                     const int iend,   const int jend,   const int kend,
+                     const Microphys_active_columns& rain_columns,
                      const int jj, const int kk, const int j)
     {
-        const TF lambda_evap = 1.; // 1.0 in UCLA, 0.7 in DALES
+        using mp_rates::lambda_evap;
 
-        for (int k=kstart; k<kend; k++)
-            #pragma ivdep
-            for (int i=istart; i<iend; i++)
+        const Microphys_active_columns& c = rain_columns;
+
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=c.jbeg[j]; n<c.jbeg[j+1]; n++)
             {
-                const int ik  = i + k*jj;
-                const int ijk = i + j*jj + k*kk;
+                if (k < c.kbot[n] || k >= c.ktop[n])
+                    continue;
+
+                const int ik  = c.ij[n] - j*jj + k*jj;
+                const int ijk = c.ij[n] + k*kk;
 
                 if (qr[ijk] > qr_min<TF>)
                 {
                     const TF mr  = rain_mass[ik];
                     const TF dr  = rain_diameter[ik];
 
-                    const TF T   = thl[ijk] * exner[k] + (Lv<TF> * ql[ijk]) / (cp<TF> * exner[k]); // Absolute temperature [K]
-                    const TF Glv = TF(1.) / (Rv<TF> * T / (esat_liq(T) * D_v<TF>) +
-                                       (Lv<TF> / (K_t<TF> * T)) * (Lv<TF> / (Rv<TF> * T) - TF(1.))); // Cond/evap rate (kg m-1 s-1)?
-
-                    const TF S   = (qt[ijk] - ql[ijk]) / qsat_liq(p[k], T) - TF(1.); // Saturation
-                    const TF F   = 1.; // Evaporation excludes ventilation term from SB06 (like UCLA, unimportant term? TODO: test)
-
-                    const TF ev_tend = TF(2.) * pi<TF> * dr * Glv * S * F * nr[ijk] / rho[k];
+                    const TF ev_tend = mp_rates::evaporation(
+                            nr[ijk], ql[ijk], qt[ijk], thl[ijk], rho[k], exner[k], p[k], dr);
 
                     qrt[ijk]  += ev_tend;
-                    nrt[ijk]  += lambda_evap * ev_tend * rho[k] / mr;
+                    nrt[ijk]  += lambda_evap<TF> * ev_tend * rho[k] / mr;
                     qtt[ijk]  -= ev_tend;
                     thlt[ijk] += Lv<TF> / (cp<TF> * exner[k]) * ev_tend;
                 }
@@ -322,22 +403,19 @@ namespace mp2d
     void selfcollection_breakup(TF* const restrict nrt, const TF* const restrict qr, const TF* const restrict nr, const TF* const restrict rho,
                                 const TF* const restrict rain_mass, const TF* const restrict rain_diameter,
                                 const TF* const restrict lambda_r,
-                                const int istart, const int jstart, const int kstart,
-                                const int iend,   const int jend,   const int kend,
+                                const Microphys_active_columns& rain_columns,
                                 const int jj, const int kk, const int j)
     {
-        const TF k_rr     = 7.12;   // SB06, p49
-        const TF kappa_rr = 60.7;   // SB06, p49
-        const TF D_eq     = 0.9e-3; // SB06, list of symbols
-        const TF k_br1    = 1.0e3;  // SB06, p50, for 0.35e-3 <= Dr <= D_eq
-        const TF k_br2    = 2.3e3;  // SB06, p50, for Dr > D_eq
+        const Microphys_active_columns& c = rain_columns;
 
-        for (int k=kstart; k<kend; k++)
-            #pragma ivdep
-            for (int i=istart; i<iend; i++)
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=c.jbeg[j]; n<c.jbeg[j+1]; n++)
             {
-                const int ik  = i + k*jj;
-                const int ijk = i + j*jj + k*kk;
+                if (k < c.kbot[n] || k >= c.ktop[n])
+                    continue;
+
+                const int ik  = c.ij[n] - j*jj + k*jj;
+                const int ijk = c.ij[n] + k*kk;
 
                 if (qr[ijk] > qr_min<TF>)
                 {
@@ -346,44 +424,121 @@ namespace mp2d
                     const TF lambdar = lambda_r[ik];
 
                     // Selfcollection
-                    const TF sc_tend =
-                        -k_rr * nr[ijk] * qr[ijk]*rho[k] / fm::pow9(TF(1.) + kappa_rr /
-                        lambdar * pow(pirhow<TF>, TF(1.)/TF(3.))) * sqrt(rho_0<TF> / rho[k]);
-
+                    const TF sc_tend = mp_rates::selfcollection(qr[ijk], nr[ijk], rho[k], lambdar);
                     nrt[ijk] += sc_tend;
 
                     // Breakup
-                    const TF dDr = dr - D_eq;
                     if (dr > TF(0.35e-3))
                     {
-                        TF phi_br;
-                        if (dr <= D_eq)
-                            phi_br = k_br1 * dDr;
-                        else
-                            phi_br = TF(2.) * exp(k_br2 * dDr) - TF(1.);
-
-                        const TF br_tend = -(phi_br + TF(1.)) * sc_tend;
+                        const TF br_tend = -mp_rates::breakup_factor(dr) * sc_tend;
                         nrt[ijk] += br_tend;
                     }
                 }
             }
     }
 
-    // Sedimentation from Stevens and Seifert (2008)
+    // All warm-rain processes of a XZ slice in a single pass over the active cells: autoconversion,
+    // accretion, evaporation, and selfcollection & breakup. The tendencies are accumulated in the
+    // same order as the separate kernels, so the results are identical. The rain shape and slope
+    // parameters are kept for the sedimentation.
     template<typename TF>
-    void sedimentation_ss08(TF* const restrict qrt, TF* const restrict nrt, TF* const restrict rr_bot,
-                            TF* const restrict w_qr, TF* const restrict w_nr,
-                            TF* const restrict c_qr, TF* const restrict c_nr,
-                            TF* const restrict slope_qr, TF* const restrict slope_nr,
-                            TF* const restrict flux_qr, TF* const restrict flux_nr,
-                            const TF* const restrict mu_r, const TF* const restrict lambda_r,
-                            const TF* const restrict qr, const TF* const restrict nr,
-                            const TF* const restrict rho, const TF* const restrict rhoh,
-                            const TF* const restrict dzi,
-                            const TF* const restrict dz, const double dt,
-                            const int istart, const int jstart, const int kstart,
-                            const int iend,   const int jend,   const int kend,
-                            const int icells, const int kcells, const int ijcells, const int j)
+    void warm_processes(TF* const restrict qrt, TF* const restrict nrt,
+                        TF* const restrict qtt, TF* const restrict thlt,
+                        TF* const restrict mu_r, TF* const restrict lambda_r,
+                        const TF* const restrict qr, const TF* const restrict nr,
+                        const TF* const restrict ql, const TF* const restrict qt, const TF* const restrict thl,
+                        const TF* const restrict rho, const TF* const restrict exner, const TF* const restrict p,
+                        const TF nc,
+                        const Microphys_active_columns& warm_columns,
+                        const int jj, const int kk, const int j)
+    {
+        using mp_rates::x_star;
+        using mp_rates::lambda_evap;
+
+        const Microphys_active_columns& c = warm_columns;
+
+        for (int k=c.kmin; k<c.kmax; k++)
+            for (int n=c.jbeg[j]; n<c.jbeg[j+1]; n++)
+            {
+                if (k < c.kbot[n] || k >= c.ktop[n])
+                    continue;
+
+                const int ik  = c.ij[n] - j*jj + k*jj;
+                const int ijk = c.ij[n] + k*kk;
+
+                const bool has_cloud = (ql[ijk] > ql_min<TF>);
+                const bool has_rain  = (qr[ijk] > qr_min<TF>);
+
+                if (!(has_cloud || has_rain))
+                    continue;
+
+                TF qr_tend  = qrt[ijk];
+                TF nr_tend  = nrt[ijk];
+                TF qt_tend  = qtt[ijk];
+                TF thl_tend = thlt[ijk];
+
+                if (has_cloud)
+                {
+                    const TF au_tend = mp_rates::autoconversion(ql[ijk], qr[ijk], rho[k], nc);
+
+                    qr_tend  += au_tend;
+                    nr_tend  += au_tend * rho[k] / x_star<TF>;
+                    qt_tend  -= au_tend;
+                    thl_tend += Lv<TF> / (cp<TF> * exner[k]) * au_tend;
+                }
+
+                if (has_cloud && has_rain)
+                {
+                    const TF ac_tend = mp_rates::accretion(ql[ijk], qr[ijk], rho[k]);
+
+                    qr_tend  += ac_tend;
+                    qt_tend  -= ac_tend;
+                    thl_tend += Lv<TF> / (cp<TF> * exner[k]) * ac_tend;
+                }
+
+                if (has_rain)
+                {
+                    const TF mr      = calc_rain_mass(qr[ijk], nr[ijk], rho[k]);
+                    const TF dr      = calc_rain_diameter(mr);
+                    const TF mur     = calc_mu_r(dr);
+                    const TF lambdar = calc_lambda_r(mur, dr);
+
+                    mu_r[ik]     = mur;
+                    lambda_r[ik] = lambdar;
+
+                    const TF ev_tend = mp_rates::evaporation(
+                            nr[ijk], ql[ijk], qt[ijk], thl[ijk], rho[k], exner[k], p[k], dr);
+
+                    qr_tend  += ev_tend;
+                    nr_tend  += lambda_evap<TF> * ev_tend * rho[k] / mr;
+                    qt_tend  -= ev_tend;
+                    thl_tend += Lv<TF> / (cp<TF> * exner[k]) * ev_tend;
+
+                    const TF sc_tend = mp_rates::selfcollection(qr[ijk], nr[ijk], rho[k], lambdar);
+                    nr_tend += sc_tend;
+
+                    if (dr > TF(0.35e-3))
+                    {
+                        const TF br_tend = -mp_rates::breakup_factor(dr) * sc_tend;
+                        nr_tend += br_tend;
+                    }
+                }
+
+                qrt[ijk]  = qr_tend;
+                nrt[ijk]  = nr_tend;
+                qtt[ijk]  = qt_tend;
+                thlt[ijk] = thl_tend;
+            }
+    }
+
+    // Sedimentation velocity of the rain mass and number at the cell centers of a XZ slice
+    template<typename TF>
+    void calc_sedimentation_velocity(TF* const restrict w_qr, TF* const restrict w_nr,
+                                     const TF* const restrict mu_r, const TF* const restrict lambda_r,
+                                     const TF* const restrict qr, const TF* const restrict rho,
+                                     const int istart, const int iend,
+                                     const int kstart, const int kend,
+                                     const int icells, const int ijcells, const int j)
     {
         const TF w_max = 9.65; // 9.65=UCLA, 20=SS08, appendix A
         const TF a_R = 9.65;   // SB06, p51
@@ -391,10 +546,6 @@ namespace mp2d
         const TF Dv  = 25.0e-6;
         const TF b_R = a_R * exp(c_R*Dv); // UCLA-LES
 
-        const int kk3d = ijcells;
-        const int kk2d = icells;
-
-        // 1. Calculate sedimentation velocity at cell center
         for (int k=kstart; k<kend; k++)
         {
             const TF rho_n = sqrt(TF(1.2) / rho[k]);
@@ -407,8 +558,8 @@ namespace mp2d
                 if (qr[ijk] > qr_min<TF>)
                 {
                     // SS08:
-                    w_qr[ik] = std::min(w_max, std::max(TF(0.1), rho_n * a_R - b_R * TF(pow(TF(1.) + c_R/lambda_r[ik], TF(-1.)*(mu_r[ik]+TF(4.))))));
-                    w_nr[ik] = std::min(w_max, std::max(TF(0.1), rho_n * a_R - b_R * TF(pow(TF(1.) + c_R/lambda_r[ik], TF(-1.)*(mu_r[ik]+TF(1.))))));
+                    w_qr[ik] = std::min(w_max, std::max(TF(0.1), rho_n * a_R - b_R * fm::pow(TF(1.) + c_R/lambda_r[ik], TF(-1.)*(mu_r[ik]+TF(4.)))));
+                    w_nr[ik] = std::min(w_max, std::max(TF(0.1), rho_n * a_R - b_R * fm::pow(TF(1.) + c_R/lambda_r[ik], TF(-1.)*(mu_r[ik]+TF(1.)))));
                 }
                 else
                 {
@@ -417,6 +568,30 @@ namespace mp2d
                 }
             }
         }
+    }
+
+    // Sedimentation from Stevens and Seifert (2008)
+    template<typename TF>
+    void sedimentation_ss08(TF* const restrict qrt, TF* const restrict nrt, TF* const restrict rr_bot,
+                            TF* const restrict w_qr, TF* const restrict w_nr,
+                            TF* const restrict c_qr, TF* const restrict c_nr,
+                            TF* const restrict slope_qr, TF* const restrict slope_nr,
+                            TF* const restrict flux_qr, TF* const restrict flux_nr,
+                            const TF* const restrict mu_r, const TF* const restrict lambda_r,
+                            const TF* const restrict qr, const TF* const restrict nr,
+                            const TF* const restrict rho, const TF* const restrict rhoh,
+                            const TF* const restrict dzi,
+                            const TF* const restrict dz, const double dt,
+                            const int istart, const int jstart, const int kstart,
+                            const int iend,   const int jend,   const int kend,
+                            const int icells, const int kcells, const int ijcells, const int j)
+    {
+        const int kk3d = ijcells;
+        const int kk2d = icells;
+
+        // 1. Calculate sedimentation velocity at cell center
+        calc_sedimentation_velocity(w_qr, w_nr, mu_r, lambda_r, qr, rho,
+                                    istart, iend, kstart, kend, icells, ijcells, j);
 
         // 1.1 Set one ghost cell to zero
         for (int i=istart; i<iend; i++)
@@ -537,6 +712,45 @@ namespace mp2d
             rr_bot[ij] = -flux_qr[ik];
         }
     }
+
+    // Sedimentation by Lagrangian remapping, stable for any sedimentation CFL number.
+    // Only the rain columns are remapped, down from their highest rainy level.
+    template<typename TF>
+    void sedimentation_remap(TF* const restrict qrt, TF* const restrict nrt, TF* const restrict rr_bot,
+                             TF* const restrict w_qr, TF* const restrict w_nr,
+                             TF* const restrict mass_new,
+                             const TF* const restrict mu_r, const TF* const restrict lambda_r,
+                             const TF* const restrict qr, const TF* const restrict nr,
+                             const TF* const restrict rho,
+                             const TF* const restrict dz, const TF* const restrict dzi,
+                             const TF* const restrict zh, const double dt,
+                             const Microphys_active_columns& rain_columns,
+                             const int istart, const int iend,
+                             const int kstart, const int kend,
+                             const int icells, const int ijcells, const int j)
+    {
+        using Micro_sedimentation_remap::remap_column;
+
+        calc_sedimentation_velocity(w_qr, w_nr, mu_r, lambda_r, qr, rho,
+                                    istart, iend, kstart, kend, icells, ijcells, j);
+
+        zero_rain_rate_slice(rr_bot, istart, iend, icells, j);
+
+        const Microphys_active_columns& c = rain_columns;
+
+        for (int n=c.jbeg[j]; n<c.jbeg[j+1]; n++)
+        {
+            const int ij = c.ij[n];
+            const int i  = ij - j*icells;
+
+            // Sedimentation flux is multiplied with density, so the surface flux is in kg m-2 s-1 (== mm s-1).
+            rr_bot[ij] = remap_column(qrt+ij, mass_new, qr+ij, w_qr+i, rho, dz, dzi, zh,
+                                      TF(dt), kstart, c.ktop[n], ijcells, icells);
+
+            remap_column(nrt+ij, mass_new, nr+ij, w_nr+i, rho, dz, dzi, zh,
+                         TF(dt), kstart, c.ktop[n], ijcells, icells);
+        }
+    }
 }
 
 template<typename TF>
@@ -550,6 +764,7 @@ Microphys_2mom_warm<TF>::Microphys_2mom_warm(Master& masterin, Grid<TF>& gridin,
     swmicrobudget = inputin.get_item<bool>("micro", "swmicrobudget", "", false);
     cflmax = inputin.get_item<TF>("micro", "cflmax", "", 2.);
     Nc0 = inputin.get_item<TF>("micro", "Nc0", "");
+    swsedimentation = Microphys<TF>::read_sedimentation_type(inputin);
 
     // Initialize the qr (rain water specific humidity) and nr (droplot number concentration) fields
     const std::string group_name = "thermo";
@@ -573,6 +788,30 @@ void Microphys_2mom_warm<TF>::init()
     auto& gd = grid.get_grid_data();
 
     rr_bot.resize(gd.ijcells);     // 2D surface sedimentation flux (rain rate)
+
+    cloud_columns.init(gd.icells, gd.jcells, gd.ijcells);
+    rain_columns .init(gd.icells, gd.jcells, gd.ijcells);
+    warm_columns .init(gd.icells, gd.jcells, gd.ijcells);
+}
+
+template<typename TF>
+void Microphys_2mom_warm<TF>::build_active_columns(const TF* const restrict ql)
+{
+    auto& gd = grid.get_grid_data();
+
+    cloud_columns.build<TF>(
+            {{ql, ql_min<TF>}},
+            gd.istart, gd.jstart, gd.kstart,
+            gd.iend,   gd.jend,   gd.kend,
+            gd.icells, gd.ijcells);
+
+    rain_columns.build<TF>(
+            {{fields.sp.at("qr")->fld.data(), qr_min<TF>}},
+            gd.istart, gd.jstart, gd.kstart,
+            gd.iend,   gd.jend,   gd.kend,
+            gd.icells, gd.ijcells);
+
+    warm_columns.merge(cloud_columns, rain_columns);
 }
 
 template<typename TF>
@@ -650,6 +889,9 @@ void Microphys_2mom_warm<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF
     auto ql = fields.get_tmp();
     thermo.get_thermo_field(*ql, "qlqi", false, false);
 
+    // Index the cloudy and rainy columns, so that the process rates skip the rest of the domain
+    build_active_columns(ql->fld.data());
+
     // Get pressure and exner function from thermodynamics
     std::vector<TF> p     = thermo.get_basestate_vector("p");
     std::vector<TF> exner = thermo.get_basestate_vector("exner");
@@ -658,7 +900,7 @@ void Microphys_2mom_warm<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF
     // (1) limit the required number of tmp fields
     // (2) re-use some expensive calculations used in multiple microphysics routines.
     const int ikcells    = gd.icells * gd.kcells;                           // Size of XZ slice
-    const int n_slices   = 12;                                              // Number of XZ slices required
+    const int n_slices   = 10;                                              // Number of XZ slices required
     const int n_tmp_flds = std::ceil(static_cast<TF>(n_slices)/gd.jcells);  // Number of required tmp fields
 
     // Load the required number of tmp fields:
@@ -681,9 +923,6 @@ void Microphys_2mom_warm<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF
     TF* flux_qr = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
     TF* flux_nr = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
 
-    TF* rain_mass = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
-    TF* rain_diam = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
-
     TF* lambda_r = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
     TF* mu_r     = get_tmp_slice<TF>(tmp_fields, slice_counter, gd.jcells, ikcells);
 
@@ -691,52 +930,43 @@ void Microphys_2mom_warm<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF
     // Calculate microphysics tendencies
     // ---------------------------------
 
-    // Autoconversion; formation of rain drop by coagulating cloud droplets
-    mp3d::autoconversion(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(), fields.st.at("qt")->fld.data(), fields.st.at("thl")->fld.data(),
-                         fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(), Nc0,
-                         gd.istart, gd.jstart, gd.kstart,
-                         gd.iend,   gd.jend,   gd.kend,
-                         gd.icells, gd.ijcells);
-
-    // Accretion; growth of raindrops collecting cloud droplets
-    mp3d::accretion(fields.st.at("qr")->fld.data(), fields.st.at("qt")->fld.data(), fields.st.at("thl")->fld.data(),
-                    fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(),
-                    gd.istart, gd.jstart, gd.kstart,
-                    gd.iend,   gd.jend,   gd.kend,
-                    gd.icells, gd.ijcells);
-
-    // Rest of the microphysics is handled per XZ slice
+    // The microphysics is handled per XZ slice. The process rates are evaluated in a
+    // single pass; the individual process kernels are only used for the budget statistics.
     for (int j=gd.jstart; j<gd.jend; ++j)
     {
-        // Prepare the XZ slices which are used in all routines
-        mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
-                                         fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                         gd.istart, gd.iend, gd.kstart, gd.kend, gd.icells, gd.ijcells, j);
-
-        // Evaporation; evaporation of rain drops in unsaturated environment
-        mp2d::evaporation(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(),  fields.st.at("qt")->fld.data(), fields.st.at("thl")->fld.data(),
-                          fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),  ql->fld.data(),
-                          fields.sp.at("qt")->fld.data(), fields.sp.at("thl")->fld.data(), fields.rhoref.data(), exner.data(), p.data(),
-                          rain_mass, rain_diam,
-                          gd.istart, gd.jstart, gd.kstart,
-                          gd.iend,   gd.jend,   gd.kend,
-                          gd.icells, gd.ijcells, j);
+        // Autoconversion, accretion, evaporation, and selfcollection and breakup
+        if (warm_columns.has_slice(j))
+            mp2d::warm_processes(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(),  fields.st.at("qt")->fld.data(), fields.st.at("thl")->fld.data(),
+                                 mu_r, lambda_r,
+                                 fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),  ql->fld.data(),
+                                 fields.sp.at("qt")->fld.data(), fields.sp.at("thl")->fld.data(), fields.rhoref.data(), exner.data(), p.data(),
+                                 Nc0, warm_columns,
+                                 gd.icells, gd.ijcells, j);
+
+        // Without rain in this slice, there is no sedimentation.
+        if (!rain_columns.has_slice(j))
+        {
+            mp2d::zero_rain_rate_slice(rr_bot.data(), gd.istart, gd.iend, gd.icells, j);
+            continue;
+        }
 
-        // Self collection and breakup; growth of raindrops by mutual (rain-rain) coagulation, and breakup by collisions
-        mp2d::selfcollection_breakup(fields.st.at("nr")->fld.data(), fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                     rain_mass, rain_diam, lambda_r,
+        // Sedimentation; sub-grid sedimentation of rain
+        if (swsedimentation == Sedimentation_type::Remap)
+            mp2d::sedimentation_remap(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(), rr_bot.data(),
+                                      w_qr, w_nr, flux_qr, mu_r, lambda_r,
+                                      fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
+                                      fields.rhoref.data(), gd.dz.data(), gd.dzi.data(), gd.zh.data(), dt,
+                                      rain_columns,
+                                      gd.istart, gd.iend, gd.kstart, gd.kend,
+                                      gd.icells, gd.ijcells, j);
+        else
+            mp2d::sedimentation_ss08(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(), rr_bot.data(),
+                                     w_qr, w_nr, c_qr, c_nr, slope_qr, slope_nr, flux_qr, flux_nr, mu_r, lambda_r,
+                                     fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
+                                     fields.rhoref.data(), fields.rhorefh.data(), gd.dzi.data(), gd.dz.data(), dt,
                                      gd.istart, gd.jstart, gd.kstart,
                                      gd.iend,   gd.jend,   gd.kend,
-                                     gd.icells, gd.ijcells, j);
-
-        // Sedimentation; sub-grid sedimentation of rain
-        mp2d::sedimentation_ss08(fields.st.at("qr")->fld.data(), fields.st.at("nr")->fld.data(), rr_bot.data(),
-                                 w_qr, w_nr, c_qr, c_nr, slope_qr, slope_nr, flux_qr, flux_nr, mu_r, lambda_r,
-                                 fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
-                                 fields.rhoref.data(), fields.rhorefh.data(), gd.dzi.data(), gd.dz.data(), dt,
-                                 gd.istart, gd.jstart, gd.kstart,
-                                 gd.iend,   gd.jend,   gd.kend,
-                                 gd.icells, gd.kcells, gd.ijcells, j);
+                                     gd.icells, gd.kcells, gd.ijcells, j);
     }
 
     // Release all local tmp fields in use
@@ -765,7 +995,20 @@ void Microphys_2mom_warm<TF>::exec_stats(Stats<TF>& stats, Thermo<TF>& thermo, c
     stats.calc_stats_2d("rr", rr_bot, no_offset);
     stats.calc_stats("qr", *fields.sp.at("qr"), no_offset, threshold_qr);
 
-    if (swmicrobudget)
+    const std::vector<std::string> auto_names = {"auto_qrt", "auto_nrt", "auto_thlt", "auto_qtt"};
+    const std::vector<std::string> accr_names = {"accr_qrt", "accr_thlt", "accr_qtt"};
+    const std::vector<std::string> evap_names = {"evap_qrt", "evap_nrt", "evap_thlt", "evap_qtt"};
+    const std::vector<std::string> scbr_names = {"scbr_nrt"};
+    const std::vector<std::string> sed_names  = {"sed_qrt", "sed_nrt"};
+
+    // Skip the process rates of which all statistics are filtered out.
+    const bool do_auto = stats.is_any_needed(auto_names);
+    const bool do_accr = stats.is_any_needed(accr_names);
+    const bool do_evap = stats.is_any_needed(evap_names);
+    const bool do_scbr = stats.is_any_needed(scbr_names);
+    const bool do_sed  = stats.is_any_needed(sed_names);
+
+    if (swmicrobudget && (do_auto || do_accr || do_evap || do_scbr || do_sed))
     {
         // Vertical profiles. The statistics of qr & nr are handled by fields.cxx
         // Get cloud liquid water specific humidity from thermodynamics
@@ -773,6 +1016,8 @@ void Microphys_2mom_warm<TF>::exec_stats(Stats<TF>& stats, Thermo<TF>& thermo, c
         ql->loc = gd.sloc;
         thermo.get_thermo_field(*ql, "ql", false, false);
 
+        build_active_columns(ql->fld.data());
+
         // Get pressure and exner function from thermodynamics
         std::vector<TF> p     = thermo.get_basestate_vector("p");
         std::vector<TF> exner = thermo.get_basestate_vector("exner");
@@ -823,107 +1068,129 @@ void Microphys_2mom_warm<TF>::exec_stats(Stats<TF>& stats, Thermo<TF>& thermo, c
         // Calculate tendencies
         // Autoconversion; formation of rain drop by coagulating cloud droplets
         // -------------------------
-        zero_field(qrt->fld.data(),  gd.ncells);
-        zero_field(nrt->fld.data(),  gd.ncells);
-        zero_field(thlt->fld.data(), gd.ncells);
-        zero_field(qtt->fld.data(),  gd.ncells);
-
-        mp3d::autoconversion(qrt->fld.data(), nrt->fld.data(), qtt->fld.data(), thlt->fld.data(),
-                             fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(), Nc0,
-                             gd.istart, gd.jstart, gd.kstart,
-                             gd.iend,   gd.jend,   gd.kend,
-                             gd.icells, gd.ijcells);
-
-        stats.calc_stats("auto_qrt" , *qrt , no_offset, no_threshold);
-        stats.calc_stats("auto_nrt" , *nrt , no_offset, no_threshold);
-        stats.calc_stats("auto_thlt", *thlt, no_offset, no_threshold);
-        stats.calc_stats("auto_qtt" , *qtt , no_offset, no_threshold);
+        if (do_auto)
+        {
+            zero_field(qrt->fld.data(),  gd.ncells);
+            zero_field(nrt->fld.data(),  gd.ncells);
+            zero_field(thlt->fld.data(), gd.ncells);
+            zero_field(qtt->fld.data(),  gd.ncells);
+
+            mp3d::autoconversion(qrt->fld.data(), nrt->fld.data(), qtt->fld.data(), thlt->fld.data(),
+                                 fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(), Nc0,
+                                 cloud_columns, gd.ijcells);
+
+            stats.calc_stats("auto_qrt" , *qrt , no_offset, no_threshold);
+            stats.calc_stats("auto_nrt" , *nrt , no_offset, no_threshold);
+            stats.calc_stats("auto_thlt", *thlt, no_offset, no_threshold);
+            stats.calc_stats("auto_qtt" , *qtt , no_offset, no_threshold);
+        }
 
         // Accretion; growth of raindrops collecting cloud droplets
         // -------------------------
-        zero_field(qrt->fld.data(),  gd.ncells);
-        zero_field(thlt->fld.data(), gd.ncells);
-        zero_field(qtt->fld.data(),  gd.ncells);
+        if (do_accr)
+        {
+            zero_field(qrt->fld.data(),  gd.ncells);
+            zero_field(thlt->fld.data(), gd.ncells);
+            zero_field(qtt->fld.data(),  gd.ncells);
 
-        mp3d::accretion(qrt->fld.data(), qtt->fld.data(), thlt->fld.data(),
-                        fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(),
-                        gd.istart, gd.jstart, gd.kstart,
-                        gd.iend,   gd.jend,   gd.kend,
-                        gd.icells, gd.ijcells);
+            mp3d::accretion(qrt->fld.data(), qtt->fld.data(), thlt->fld.data(),
+                            fields.sp.at("qr")->fld.data(), ql->fld.data(), fields.rhoref.data(), exner.data(),
+                            cloud_columns, gd.ijcells);
 
-        stats.calc_stats("accr_qrt" , *qrt , no_offset, no_threshold);
-        stats.calc_stats("accr_thlt", *thlt, no_offset, no_threshold);
-        stats.calc_stats("accr_qtt" , *qtt , no_offset, no_threshold);
+            stats.calc_stats("accr_qrt" , *qrt , no_offset, no_threshold);
+            stats.calc_stats("accr_thlt", *thlt, no_offset, no_threshold);
+            stats.calc_stats("accr_qtt" , *qtt , no_offset, no_threshold);
+        }
 
         // Rest of the microphysics is handled per XZ slice
         // Evaporation; evaporation of rain drops in unsaturated environment
         // -------------------------
-        zero_field(qrt->fld.data(),  gd.ncells);
-        zero_field(nrt->fld.data(),  gd.ncells);
-        zero_field(thlt->fld.data(), gd.ncells);
-        zero_field(qtt->fld.data(),  gd.ncells);
-
-        for (int j=gd.jstart; j<gd.jend; ++j)
+        if (do_evap)
         {
-            mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
-                                             fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                             gd.istart, gd.iend, gd.kstart, gd.kend, gd.icells, gd.ijcells, j);
-
-            mp2d::evaporation(qrt->fld.data(), nrt->fld.data(),  qtt->fld.data(), thlt->fld.data(),
-                              fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),  ql->fld.data(),
-                              fields.sp.at("qt")->fld.data(), fields.sp.at("thl")->fld.data(), fields.rhoref.data(), exner.data(), p.data(),
-                              rain_mass, rain_diam,
-                              gd.istart, gd.jstart, gd.kstart,
-                              gd.iend,   gd.jend,   gd.kend,
-                              gd.icells, gd.ijcells, j);
-        }
+            zero_field(qrt->fld.data(),  gd.ncells);
+            zero_field(nrt->fld.data(),  gd.ncells);
+            zero_field(thlt->fld.data(), gd.ncells);
+            zero_field(qtt->fld.data(),  gd.ncells);
+
+            for (int j=gd.jstart; j<gd.jend; ++j)
+            {
+                mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
+                                                 fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
+                                                 rain_columns, gd.icells, gd.ijcells, j);
+
+                mp2d::evaporation(qrt->fld.data(), nrt->fld.data(),  qtt->fld.data(), thlt->fld.data(),
+                                  fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),  ql->fld.data(),
+                                  fields.sp.at("qt")->fld.data(), fields.sp.at("thl")->fld.data(), fields.rhoref.data(), exner.data(), p.data(),
+                                  rain_mass, rain_diam, rain_columns,
+                                  gd.icells, gd.ijcells, j);
+            }
 
-        stats.calc_stats("evap_qrt" , *qrt , no_offset, no_threshold);
-        stats.calc_stats("evap_nrt" , *nrt , no_offset, no_threshold);
-        stats.calc_stats("evap_thlt", *thlt, no_offset, no_threshold);
-        stats.calc_stats("evap_qtt" , *qtt , no_offset, no_threshold);
+            stats.calc_stats("evap_qrt" , *qrt , no_offset, no_threshold);
+            stats.calc_stats("evap_nrt" , *nrt , no_offset, no_threshold);
+            stats.calc_stats("evap_thlt", *thlt, no_offset, no_threshold);
+            stats.calc_stats("evap_qtt" , *qtt , no_offset, no_threshold);
+        }
 
         // Self collection and breakup; growth of raindrops by mutual (rain-rain) coagulation, and breakup by collisions
         // -------------------------
-        zero_field(nrt->fld.data(),  gd.ncells);
-
-        for (int j=gd.jstart; j<gd.jend; ++j)
+        if (do_scbr)
         {
-            mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
-                                             fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                             gd.istart, gd.iend, gd.kstart, gd.kend, gd.icells, gd.ijcells, j);
-
-            mp2d::selfcollection_breakup(nrt->fld.data(), fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                         rain_mass, rain_diam, lambda_r,
-                                         gd.istart, gd.jstart, gd.kstart,
-                                         gd.iend,   gd.jend,   gd.kend,
-                                         gd.icells, gd.ijcells, j);
-        }
+            zero_field(nrt->fld.data(),  gd.ncells);
 
-        stats.calc_stats("scbr_nrt" , *nrt , no_offset, no_threshold);
+            for (int j=gd.jstart; j<gd.jend; ++j)
+            {
+                mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
+                                                 fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
+                                                 rain_columns, gd.icells, gd.ijcells, j);
+
+                mp2d::selfcollection_breakup(nrt->fld.data(), fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
+                                             rain_mass, rain_diam, lambda_r, rain_columns,
+                                             gd.icells, gd.ijcells, j);
+            }
+
+            stats.calc_stats("scbr_nrt" , *nrt , no_offset, no_threshold);
+        }
 
         // Sedimentation; sub-grid sedimentation of rain
         // -------------------------
-        zero_field(qrt->fld.data(),  gd.ncells);
-        zero_field(nrt->fld.data(),  gd.ncells);
-
-        for (int j=gd.jstart; j<gd.jend; ++j)
+        if (do_sed)
         {
-            mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
-                                             fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
-                                             gd.istart, gd.iend, gd.kstart, gd.kend, gd.icells, gd.ijcells, j);
+            zero_field(qrt->fld.data(),  gd.ncells);
+            zero_field(nrt->fld.data(),  gd.ncells);
 
-            mp2d::sedimentation_ss08(qrt->fld.data(), nrt->fld.data(), rr_bot.data(),
-                                     w_qr, w_nr, c_qr, c_nr, slope_qr, slope_nr, flux_qr, flux_nr, mu_r, lambda_r,
-                                     fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
-                                     fields.rhoref.data(), fields.rhorefh.data(), gd.dzi.data(), gd.dz.data(), dt,
-                                     gd.istart, gd.jstart, gd.kstart,
-                                     gd.iend,   gd.jend,   gd.kend,
-                                     gd.icells, gd.kcells, gd.ijcells, j);
-        }
+            for (int j=gd.jstart; j<gd.jend; ++j)
+            {
+                if (!rain_columns.has_slice(j))
+                {
+                    mp2d::zero_rain_rate_slice(rr_bot.data(), gd.istart, gd.iend, gd.icells, j);
+                    continue;
+                }
 
-        stats.calc_stats("sed_qrt" , *qrt , no_offset, no_threshold);
-        stats.calc_stats("sed_nrt" , *nrt , no_offset, no_threshold);
+                mp2d::prepare_microphysics_slice(rain_mass, rain_diam, mu_r, lambda_r,
+                                                 fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(), fields.rhoref.data(),
+                                                 rain_columns, gd.icells, gd.ijcells, j);
+
+                if (swsedimentation == Sedimentation_type::Remap)
+                    mp2d::sedimentation_remap(qrt->fld.data(), nrt->fld.data(), rr_bot.data(),
+                                              w_qr, w_nr, flux_qr, mu_r, lambda_r,
+                                              fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
+                                              fields.rhoref.data(), gd.dz.data(), gd.dzi.data(), gd.zh.data(), dt,
+                                              rain_columns,
+                                              gd.istart, gd.iend, gd.kstart, gd.kend,
+                                              gd.icells, gd.ijcells, j);
+                else
+                    mp2d::sedimentation_ss08(qrt->fld.data(), nrt->fld.data(), rr_bot.data(),
+                                             w_qr, w_nr, c_qr, c_nr, slope_qr, slope_nr, flux_qr, flux_nr, mu_r, lambda_r,
+                                             fields.sp.at("qr")->fld.data(), fields.sp.at("nr")->fld.data(),
+                                             fields.rhoref.data(), fields.rhorefh.data(), gd.dzi.data(), gd.dz.data(), dt,
+                                             gd.istart, gd.jstart, gd.kstart,
+                                             gd.iend,   gd.jend,   gd.kend,
+                                             gd.icells, gd.kcells, gd.ijcells, j);
+            }
+
+            stats.calc_stats("sed_qrt" , *qrt , no_offset, no_threshold);
+            stats.calc_stats("sed_nrt" , *nrt , no_offset, no_threshold);
+        }
 
         // Release all local tmp fields in use
         for (auto& it: tmp_fields)
@@ -964,6 +1231,10 @@ void Microphys_2mom_warm<TF>::exec_cross(Cross<TF>& cross, unsigned long iotime)
 template<typename TF>
 unsigned long Microphys_2mom_warm<TF>::get_time_limit(unsigned long idt, const double dt)
 {
+    // The remapping sedimentation is stable for any CFL number.
+    if (swsedimentation == Sedimentation_type::Remap)
+        return Constants::ulhuge;
+
     auto& gd = grid.get_grid_data();
 
     // Calculate the maximum sedimentation CFL number
@@ -37,6 +37,7 @@
 #include "constants.h"
 #include "microphys.h"
 #include "microphys_nsw6.h"
+#include "microphys_sedi_remap.h"
 #include "microphys_2mom_warm.h"
 
 // Constants, move out later.
@@ -131,14 +132,15 @@ namespace
             const TF* const restrict rho, const TF* const restrict exner, const TF* const restrict p,
             const TF* const restrict dzi, const TF* const restrict dzhi,
             const TF Nc0, const TF dt,
-            const int istart, const int jstart, const int kstart,
-            const int iend, const int jend, const int kend,
-            const int jj, const int kk)
+            const Microphys_active_columns& active_columns,
+            const int kstart, const int kk)
     {
+        const Microphys_active_columns& c = active_columns;
+
         // Tomita Eq. 51. Nc0 is converted from SI units (m-3 instead of cm-3).
         const TF D_d = TF(0.146) - TF(5.964e-2)*std::log((Nc0*TF(1.e-6)) / TF(2.e3));
 
-        for (int k=kstart; k<kend; ++k)
+        for (int k=c.kmin; k<c.kmax; ++k)
         {
             const TF rho0_rho_sqrt = std::sqrt(rho[kstart]/rho[k]);
 
@@ -184,11 +186,10 @@ namespace
                 / TF(4.)
                 * rho0_rho_sqrt;
 
-            for (int j=jstart; j<jend; ++j)
-                #pragma ivdep
-                for (int i=istart; i<iend; ++i)
+            for (int n=0; n<c.size(); ++n)
+                if (k >= c.kbot[n] && k < c.ktop[n])
                 {
-                    const int ijk = i + j*jj + k*kk;
+                    const int ijk = c.ij[n] + k*kk;
 
                     // Compute the T out of the known values of ql and qi, this saves memory and sat_adjust.
                     const TF T = exner[k]*thl[ijk] + Lv<TF>/cp<TF>*ql[ijk] + Ls<TF>/cp<TF>*qi[ijk];
@@ -682,16 +683,12 @@ namespace
                 }
     }
 
-    // Sedimentation based on Stevens and Seifert (2008)
+    // Terminal velocity of a precipitating species, including the ghost cells.
     template<typename TF>
-    void sedimentation_ss08(
-            TF* const restrict qct, TF* const restrict rc_bot,
-            TF* const restrict w_qc, TF* const restrict c_qc,
-            TF* const restrict slope_qc, TF* const restrict flux_qc,
+    void calc_velocity_ss08(
+            TF* const restrict w_qc,
             const TF* const restrict qc,
             const TF* const restrict rho,
-            const TF* const restrict dzi, const TF* const restrict dz,
-            const double dt,
             const TF a_c, const TF b_c, const TF c_c, const TF d_c, const TF N_0c,
             const TF qc_min,
             const int istart, const int jstart, const int kstart,
@@ -743,6 +740,32 @@ namespace
                 w_qc[ijk_bot] = w_qc[ijk_bot+kk];
                 w_qc[ijk_top] = TF(0.);
             }
+    }
+
+    // Sedimentation based on Stevens and Seifert (2008)
+    template<typename TF>
+    void sedimentation_ss08(
+            TF* const restrict qct, TF* const restrict rc_bot,
+            TF* const restrict w_qc, TF* const restrict c_qc,
+            TF* const restrict slope_qc, TF* const restrict flux_qc,
+            const TF* const restrict qc,
+            const TF* const restrict rho,
+            const TF* const restrict dzi, const TF* const restrict dz,
+            const double dt,
+            const TF a_c, const TF b_c, const TF c_c, const TF d_c, const TF N_0c,
+            const TF qc_min,
+            const int istart, const int jstart, const int kstart,
+            const int iend, const int jend, const int kend,
+            const int jj, const int kk)
+    {
+        // 1. Calculate sedimentation velocity at cell center
+        calc_velocity_ss08(
+                w_qc, qc, rho,
+                a_c, b_c, c_c, d_c, N_0c,
+                qc_min,
+                istart, jstart, kstart,
+                iend, jend, kend,
+                jj, kk);
 
         // 2. Calculate CFL number using interpolated sedimentation velocity
         for (int k=kstart; k<kend; ++k)
@@ -824,6 +847,49 @@ namespace
             }
     }
 
+    // Sedimentation by Lagrangian remapping, stable for any sedimentation CFL number.
+    template<typename TF>
+    void sedimentation_remap(
+            TF* const restrict qct, TF* const restrict rc_bot,
+            TF* const restrict w_qc, TF* const restrict mass_new,
+            const TF* const restrict qc,
+            const TF* const restrict rho,
+            const TF* const restrict dz, const TF* const restrict dzi,
+            const TF* const restrict zh,
+            const double dt,
+            const TF a_c, const TF b_c, const TF c_c, const TF d_c, const TF N_0c,
+            const TF qc_min,
+            const Microphys_active_columns& active_columns,
+            const int istart, const int jstart, const int kstart,
+            const int iend, const int jend, const int kend,
+            const int jj, const int kk)
+    {
+        calc_velocity_ss08(
+                w_qc, qc, rho,
+                a_c, b_c, c_c, d_c, N_0c,
+                qc_min,
+                istart, jstart, kstart,
+                iend, jend, kend,
+                jj, kk);
+
+        for (int j=jstart; j<jend; ++j)
+            for (int i=istart; i<iend; ++i)
+                rc_bot[i + j*jj] = TF(0.);
+
+        // Columns without hydrometeors have nothing to sediment.
+        const Microphys_active_columns& c = active_columns;
+
+        for (int n=0; n<c.size(); ++n)
+        {
+            const int ij = c.ij[n];
+
+            // The flux is multiplied with density, so the surface flux is in kg m-2 s-1 (== mm s-1).
+            rc_bot[ij] = Micro_sedimentation_remap::remap_column(
+                    qct+ij, mass_new, qc+ij, w_qc+ij, rho, dz, dzi, zh,
+                    TF(dt), kstart, c.ktop[n], kk, kk);
+        }
+    }
+
     // Sedimentation from Stevens and Seifert (2008)
     template<typename TF>
     TF calc_cfl_ss08(
@@ -840,51 +906,14 @@ namespace
     {
         TF cfl_max = TF(0.);
 
-        constexpr TF V_Tmin = TF(0.1);
-        constexpr TF V_Tmax = TF(10.);
-
         // 1. Calculate sedimentation velocity at cell center
-        for (int k=kstart; k<kend; ++k)
-        {
-            const TF rho0_rho_sqrt = std::sqrt(rho[kstart]/rho[k]);
-
-            for (int j=jstart; j<jend; ++j)
-                #pragma ivdep
-                for (int i=istart; i<iend; ++i)
-                {
-                    const int ijk = i + j*jj + k*kk;
-
-                    if (qc[ijk] > qc_min)
-                    {
-                        const TF lambda_c = std::pow(
-                            a_c * N_0c * std::tgamma(b_c + TF(1.))
-                            / (rho[k] * qc[ijk]),
-                            TF(1.) / (b_c + TF(1.)) );
-
-                        TF V_T =
-                            c_c * rho0_rho_sqrt
-                            * std::tgamma(b_c + d_c + TF(1.)) / std::tgamma(b_c + TF(1.))
-                            * std::pow(lambda_c, -d_c);
-
-                        // Constrain the terminal velocity between 0.1 and 10.
-                        V_T = std::max(V_Tmin, std::min(V_T, V_Tmax));
-
-                        w_qc[ijk] = V_T;
-                    }
-                    else
-                        w_qc[ijk] = TF(0.);
-                }
-        }
-
-        // 1.1 Set one ghost cell to zero
-        for (int j=jstart; j<jend; ++j)
-            for (int i=istart; i<iend; ++i)
-            {
-                const int ijk_bot = i + j*jj + (kstart-1)*kk;
-                const int ijk_top = i + j*jj + (kend    )*kk;
-                w_qc[ijk_bot] = w_qc[ijk_bot+kk];
-                w_qc[ijk_top] = TF(0.);
-            }
+        calc_velocity_ss08(
+                w_qc, qc, rho,
+                a_c, b_c, c_c, d_c, N_0c,
+                qc_min,
+                istart, jstart, kstart,
+                iend, jend, kend,
+                jj, kk);
 
         // 2. Calculate CFL number using interpolated sedimentation velocity
         for (int k=kstart; k<kend; ++k)
@@ -912,6 +941,7 @@ Microphys_nsw6<TF>::Microphys_nsw6(Master& masterin, Grid<TF>& gridin, Fields<TF
     // swmicrobudget = inputin.get_item<bool>("micro", "swmicrobudget", "", false);
     cflmax = inputin.get_item<TF>("micro", "cflmax", "", 1.2);
     Nc0 = inputin.get_item<TF>("micro", "Nc0", "");
+    swsedimentation = Microphys<TF>::read_sedimentation_type(inputin);
 
     // Initialize the qr (rain water specific humidity) and nr (droplot number concentration) fields
     const std::string group_name = "thermo";
@@ -939,6 +969,8 @@ void Microphys_nsw6<TF>::init()
     rr_bot.resize(gd.ijcells);
     rs_bot.resize(gd.ijcells);
     rg_bot.resize(gd.ijcells);
+
+    active_columns.init(gd.icells, gd.jcells, gd.ijcells);
 }
 
 template<typename TF>
@@ -991,6 +1023,16 @@ void Microphys_nsw6<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF>& st
     thermo.get_thermo_field(*ql, "ql", false, false);
     thermo.get_thermo_field(*qi, "qi", false, false);
 
+    // Index the columns with hydrometeors; the conversion rates vanish elsewhere.
+    active_columns.build<TF>(
+            {{ql->fld.data(), ql_min<TF>}, {qi->fld.data(), qi_min<TF>},
+             {fields.sp.at("qr")->fld.data(), qr_min<TF>},
+             {fields.sp.at("qs")->fld.data(), qs_min<TF>},
+             {fields.sp.at("qg")->fld.data(), qg_min<TF>}},
+            gd.istart, gd.jstart, gd.kstart,
+            gd.iend,   gd.jend,   gd.kend,
+            gd.icells, gd.ijcells);
+
     const std::vector<TF>& p = thermo.get_basestate_vector("p");
     const std::vector<TF>& exner = thermo.get_basestate_vector("exner");
 
@@ -1003,9 +1045,8 @@ void Microphys_nsw6<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF>& st
             fields.rhoref.data(), exner.data(), p.data(),
             gd.dzi.data(), gd.dzhi.data(),
             this->Nc0, TF(dt),
-            gd.istart, gd.jstart, gd.kstart,
-            gd.iend, gd.jend, gd.kend,
-            gd.icells, gd.ijcells);
+            active_columns,
+            gd.kstart, gd.ijcells);
 
     fields.release_tmp(ql);
     fields.release_tmp(qi);
@@ -1016,49 +1057,94 @@ void Microphys_nsw6<TF>::exec(Thermo<TF>& thermo, const double dt, Stats<TF>& st
     auto tmp4 = fields.get_tmp();
 
     // Falling rain.
-    sedimentation_ss08(
-            fields.st.at("qr")->fld.data(), rr_bot.data(),
-            tmp1->fld.data(), tmp2->fld.data(),
-            tmp3->fld.data(), tmp4->fld.data(),
-            fields.sp.at("qr")->fld.data(),
-            fields.rhoref.data(),
-            gd.dzi.data(), gd.dz.data(),
-            dt,
-            a_r<TF>, b_r<TF>, c_r<TF>, d_r<TF>, N_0r<TF>,
-            qr_min<TF>,
-            gd.istart, gd.jstart, gd.kstart,
-            gd.iend, gd.jend, gd.kend,
-            gd.icells, gd.ijcells);
+    if (swsedimentation == Sedimentation_type::Remap)
+        sedimentation_remap(
+                fields.st.at("qr")->fld.data(), rr_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                fields.sp.at("qr")->fld.data(),
+                fields.rhoref.data(),
+                gd.dz.data(), gd.dzi.data(), gd.zh.data(),
+                dt,
+                a_r<TF>, b_r<TF>, c_r<TF>, d_r<TF>, N_0r<TF>,
+                qr_min<TF>,
+                active_columns,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
+    else
+        sedimentation_ss08(
+                fields.st.at("qr")->fld.data(), rr_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                tmp3->fld.data(), tmp4->fld.data(),
+                fields.sp.at("qr")->fld.data(),
+                fields.rhoref.data(),
+                gd.dzi.data(), gd.dz.data(),
+                dt,
+                a_r<TF>, b_r<TF>, c_r<TF>, d_r<TF>, N_0r<TF>,
+                qr_min<TF>,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
 
     // Falling snow.
-    sedimentation_ss08(
-            fields.st.at("qs")->fld.data(), rs_bot.data(),
-            tmp1->fld.data(), tmp2->fld.data(),
-            tmp3->fld.data(), tmp4->fld.data(),
-            fields.sp.at("qs")->fld.data(),
-            fields.rhoref.data(),
-            gd.dzi.data(), gd.dz.data(),
-            dt,
-            a_s<TF>, b_s<TF>, c_s<TF>, d_s<TF>, N_0s<TF>,
-            qs_min<TF>,
-            gd.istart, gd.jstart, gd.kstart,
-            gd.iend, gd.jend, gd.kend,
-            gd.icells, gd.ijcells);
+    if (swsedimentation == Sedimentation_type::Remap)
+        sedimentation_remap(
+                fields.st.at("qs")->fld.data(), rs_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                fields.sp.at("qs")->fld.data(),
+                fields.rhoref.data(),
+                gd.dz.data(), gd.dzi.data(), gd.zh.data(),
+                dt,
+                a_s<TF>, b_s<TF>, c_s<TF>, d_s<TF>, N_0s<TF>,
+                qs_min<TF>,
+                active_columns,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
+    else
+        sedimentation_ss08(
+                fields.st.at("qs")->fld.data(), rs_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                tmp3->fld.data(), tmp4->fld.data(),
+                fields.sp.at("qs")->fld.data(),
+                fields.rhoref.data(),
+                gd.dzi.data(), gd.dz.data(),
+                dt,
+                a_s<TF>, b_s<TF>, c_s<TF>, d_s<TF>, N_0s<TF>,
+                qs_min<TF>,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
 
     // Falling graupel.
-    sedimentation_ss08(
-            fields.st.at("qg")->fld.data(), rg_bot.data(),
-            tmp1->fld.data(), tmp2->fld.data(),
-            tmp3->fld.data(), tmp4->fld.data(),
-            fields.sp.at("qg")->fld.data(),
-            fields.rhoref.data(),
-            gd.dzi.data(), gd.dz.data(),
-            dt,
-            a_g<TF>, b_g<TF>, c_g<TF>, d_g<TF>, N_0g<TF>,
-            qg_min<TF>,
-            gd.istart, gd.jstart, gd.kstart,
-            gd.iend, gd.jend, gd.kend,
-            gd.icells, gd.ijcells);
+    if (swsedimentation == Sedimentation_type::Remap)
+        sedimentation_remap(
+                fields.st.at("qg")->fld.data(), rg_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                fields.sp.at("qg")->fld.data(),
+                fields.rhoref.data(),
+                gd.dz.data(), gd.dzi.data(), gd.zh.data(),
+                dt,
+                a_g<TF>, b_g<TF>, c_g<TF>, d_g<TF>, N_0g<TF>,
+                qg_min<TF>,
+                active_columns,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
+    else
+        sedimentation_ss08(
+                fields.st.at("qg")->fld.data(), rg_bot.data(),
+                tmp1->fld.data(), tmp2->fld.data(),
+                tmp3->fld.data(), tmp4->fld.data(),
+                fields.sp.at("qg")->fld.data(),
+                fields.rhoref.data(),
+                gd.dzi.data(), gd.dz.data(),
+                dt,
+                a_g<TF>, b_g<TF>, c_g<TF>, d_g<TF>, N_0g<TF>,
+                qg_min<TF>,
+                gd.istart, gd.jstart, gd.kstart,
+                gd.iend, gd.jend, gd.kend,
+                gd.icells, gd.ijcells);
 
     fields.release_tmp(tmp1);
     fields.release_tmp(tmp2);
@@ -1118,6 +1204,10 @@ void Microphys_nsw6<TF>::exec_cross(Cross<TF>& cross, unsigned long iotime)
 template<typename TF>
 unsigned long Microphys_nsw6<TF>::get_time_limit(unsigned long idt, const double dt)
 {
+    // The remapping sedimentation is stable for any CFL number.
+    if (swsedimentation == Sedimentation_type::Remap)
+        return Constants::ulhuge;
+
     auto& gd = grid.get_grid_data();
 
     auto tmp = fields.get_tmp();
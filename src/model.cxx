@@ -49,6 +49,7 @@
 #include "limiter.h"
 #include "stats.h"
 #include "budget.h"
+#include "spectra.h"
 #include "column.h"
 #include "cross.h"
 #include "dump.h"
@@ -151,6 +152,7 @@ Model<TF>::Model(Master& masterin, int argc, char *argv[]) :
         cross      = std::make_shared<Cross <TF>>(master, *grid, *soil_grid, *fields, *input);
 
         budget     = Budget<TF>::factory(master, *grid, *fields, *thermo, *diff, *advec, *force, *stats, *input);
+        spectra    = std::make_shared<Spectra<TF>>(master, *grid, *fields, *fft, *stats, *input);
 
         // Parse the statistics masks
         add_statistics_masks();
@@ -200,6 +202,7 @@ void Model<TF>::init()
     radiation->init(*timeloop);
     decay->init(*input);
     budget->init();
+    spectra->init();
     source->init();
     aerosol->init();
     background->init(*input_nc);
@@ -288,6 +291,7 @@ void Model<TF>::load()
     diff->create(*stats, false);
 
     budget->create(*stats);
+    spectra->create(*stats);
 }
 
 // In these functions data necessary to start the model is saved to disk.
@@ -314,6 +318,8 @@ void Model<TF>::save()
 
     boundary->create_cold_start(*input_nc);
     boundary->save(timeloop->get_iotime(), *thermo);
+
+    fields->flush_checkpoint();
 }
 
 template<typename TF>
@@ -559,6 +565,10 @@ void Model<TF>::exec()
                 }
 
             } // End time loop.
+
+            // Make sure that the last checkpoint is on disk before the run ends.
+            #pragma omp taskwait
+            fields->flush_checkpoint();
         } // End OpenMP master region.
     } // End OpenMP parallel region.
 
@@ -630,11 +640,13 @@ void Model<TF>::calculate_statistics(int iteration, double time, unsigned long i
 
         grid     ->exec_stats(*stats);
         fields   ->exec_stats(*stats);
+        stats    ->calc_histograms();
         thermo   ->exec_stats(*stats);
         background ->exec_stats(*stats);
         microphys->exec_stats(*stats, *thermo, dt);
         diff     ->exec_stats(*stats, *thermo);
         budget   ->exec_stats(*stats);
+        spectra  ->exec_stats(*stats);
         boundary ->exec_stats(*stats);
     }
 
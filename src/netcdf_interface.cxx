@@ -402,6 +402,36 @@ void Netcdf_handle::add_attribute(
     nc_check(master, nc_check_code, mpiid_to_write);
 }
 
+// Set the chunk sizes of a variable, and optionally enable (shuffled) deflate compression.
+void Netcdf_handle::set_chunking(
+        const int var_id,
+        const std::vector<int>& chunk_sizes,
+        const int deflate_level)
+{
+    const std::vector<size_t> chunk_sizes_size_t(chunk_sizes.begin(), chunk_sizes.end());
+
+    int nc_check_code = 0;
+
+    if (master.get_mpiid() == mpiid_to_write)
+        nc_check_code = nc_redef(root_ncid);
+    nc_check(master, nc_check_code, mpiid_to_write);
+
+    if (master.get_mpiid() == mpiid_to_write)
+        nc_check_code = nc_def_var_chunking(ncid, var_id, NC_CHUNKED, chunk_sizes_size_t.data());
+    nc_check(master, nc_check_code, mpiid_to_write);
+
+    if (deflate_level > 0)
+    {
+        if (master.get_mpiid() == mpiid_to_write)
+            nc_check_code = nc_def_var_deflate(ncid, var_id, 1, 1, deflate_level);
+        nc_check(master, nc_check_code, mpiid_to_write);
+    }
+
+    if (master.get_mpiid() == mpiid_to_write)
+        nc_check_code = nc_enddef(root_ncid);
+    nc_check(master, nc_check_code, mpiid_to_write);
+}
+
 Netcdf_group& Netcdf_handle::add_group(const std::string& name)
 {
     int group_ncid = -1;
@@ -756,6 +786,12 @@ void Netcdf_variable<T>::add_attribute(const std::string& name, const float valu
     nc_handle.add_attribute(name, value, var_id);
 }
 
+template<typename T>
+void Netcdf_variable<T>::set_chunking(const std::vector<int>& chunk_sizes, const int deflate_level)
+{
+    nc_handle.set_chunking(var_id, chunk_sizes, deflate_level);
+}
+
 template class Netcdf_variable<double>;
 template class Netcdf_variable<float>;
 template class Netcdf_variable<int>;
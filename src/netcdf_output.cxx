@@ -0,0 +1,109 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include "master.h"
+#include "input.h"
+#include "netcdf_output.h"
+
+template<typename TF>
+Netcdf_output<TF>::Netcdf_output(Master& masterin, Input& inputin) :
+    master(masterin)
+{
+    iotimeprec = inputin.get_item<int>("time", "iotimeprec", "", 0);
+}
+
+template<typename TF>
+Netcdf_output_file<TF>& Netcdf_output<TF>::get_file(
+        const std::string& name, const std::string& mode, const int iotime,
+        const std::vector<Dimension>& dims, const std::vector<int>& chunks, const int deflate_level)
+{
+    const std::string key = mode.empty() ? name : name + "." + mode;
+
+    auto it = files.find(key);
+    if (it == files.end())
+    {
+        // The output time of the first record is in the file name, such that restarts create new files.
+        char filename[256];
+        std::sprintf(filename, "%s.%07d.nc", key.c_str(), iotime);
+        master.print_message("Creating \"%s\"\n", filename);
+
+        Netcdf_output_file<TF> output;
+        output.file = std::make_unique<Netcdf_file>(master, filename, Netcdf_mode::Create);
+
+        output.file->add_dimension("time");
+        output.time_var = std::make_unique<Netcdf_variable<double>>(
+                output.file->template add_variable<double>("time", {"time"}));
+        output.time_var->add_attribute("units", "seconds since start");
+
+        std::vector<std::string> var_dims = {"time"};
+        for (auto& dim : dims)
+        {
+            output.file->add_dimension(dim.first, dim.second.size());
+            Netcdf_variable<TF> dim_var = output.file->template add_variable<TF>(dim.first, {dim.first});
+            dim_var.add_attribute("units", "m");
+            dim_var.insert(dim.second, {0});
+
+            var_dims.push_back(dim.first);
+        }
+
+        output.var = std::make_unique<Netcdf_variable<TF>>(
+                output.file->template add_variable<TF>(name, var_dims));
+
+        // Chunk each record separately, with the chunk shape tuned to the orientation of the data.
+        std::vector<int> record_chunks = {1};
+        record_chunks.insert(record_chunks.end(), chunks.begin(), chunks.end());
+        output.var->set_chunking(record_chunks, deflate_level);
+
+        it = files.emplace(key, std::move(output)).first;
+    }
+
+    // Start a new record if this is a new output time.
+    Netcdf_output_file<TF>& output = it->second;
+    if (output.iotime != iotime)
+    {
+        ++output.record;
+        output.iotime = iotime;
+
+        const double time = iotime * std::pow(10., iotimeprec);
+        output.time_var->insert(time, {output.record});
+        output.file->sync();
+    }
+
+    return output;
+}
+
+template<typename TF>
+std::vector<TF> Netcdf_output<TF>::get_global_coordinates(const int n, const TF d, const bool is_half)
+{
+    std::vector<TF> coords(n);
+    for (int i=0; i<n; ++i)
+        coords[i] = (i + (is_half ? TF(0) : TF(0.5))) * d;
+    return coords;
+}
+
+#ifdef FLOAT_SINGLE
+template class Netcdf_output<float>;
+#else
+template class Netcdf_output<double>;
+#endif
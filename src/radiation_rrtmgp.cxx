@@ -23,6 +23,8 @@
 #include <string>
 #include <cmath>
 #include <stdexcept>
+#include <exception>
+#include <memory>
 
 #include "radiation_rrtmgp.h"
 #include "radiation_rrtmgp_functions.h"
@@ -644,10 +646,319 @@ namespace
                 }
     }
 
+    // Average the columns of every n_coarse x n_coarse block of a field without ghost cells.
+    void coarsen_block_mean(
+            Float* restrict out, const Float* restrict in,
+            const int n_coarse, const int imax, const int jmax, const int n_lev)
+    {
+        const int imax_c = imax / n_coarse;
+        const int ijmax = imax*jmax;
+        const int ijmax_c = ijmax / (n_coarse*n_coarse);
+        const Float fac = Float(1.) / (n_coarse*n_coarse);
+
+        #pragma omp parallel for
+        for (int k=0; k<n_lev; ++k)
+        {
+            for (int n=0; n<ijmax_c; ++n)
+                out[n + k*ijmax_c] = Float(0.);
+
+            for (int j=0; j<jmax; ++j)
+                for (int i=0; i<imax; ++i)
+                    out[i/n_coarse + (j/n_coarse)*imax_c + k*ijmax_c] += in[i + j*imax + k*ijmax];
+
+            for (int n=0; n<ijmax_c; ++n)
+                out[n + k*ijmax_c] *= fac;
+        }
+    }
+
+    // Copy the sampled column of every block of a field without ghost cells.
+    void coarsen_sample(
+            Float* restrict out, const Float* restrict in, const int* restrict sample,
+            const int ijmax, const int ijmax_c, const int n_lev)
+    {
+        #pragma omp parallel for
+        for (int k=0; k<n_lev; ++k)
+            for (int n=0; n<ijmax_c; ++n)
+                out[n + k*ijmax_c] = in[sample[n] + k*ijmax];
+    }
+
+    // Copy the coarse columns back to all columns of their block.
+    void expand_coarse(
+            Float* restrict out, const Float* restrict in,
+            const int n_coarse, const int imax, const int jmax, const int n_lev)
+    {
+        const int imax_c = imax / n_coarse;
+        const int ijmax = imax*jmax;
+        const int ijmax_c = ijmax / (n_coarse*n_coarse);
+
+        #pragma omp parallel for
+        for (int k=0; k<n_lev; ++k)
+            for (int j=0; j<jmax; ++j)
+                for (int i=0; i<imax; ++i)
+                    out[i + j*imax + k*ijmax] = in[i/n_coarse + (j/n_coarse)*imax_c + k*ijmax_c];
+    }
+
+    // Integer hash (splitmix64 finalizer) to draw reproducible random numbers.
+    unsigned long long hash_index(unsigned long long x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Pick a random column in every n_coarse x n_coarse block. The choice depends only on the
+    // global index of the block and the radiation call, and not on the MPI decomposition.
+    void set_coarse_sample(
+            int* restrict sample, const unsigned long long call_index,
+            const int n_coarse, const int imax, const int jmax, const int itot,
+            const int mpicoordx, const int mpicoordy)
+    {
+        const int imax_c = imax / n_coarse;
+        const int jmax_c = jmax / n_coarse;
+        const unsigned long long itot_c = itot / n_coarse;
+        const unsigned long long call_hash = hash_index(call_index);
+
+        for (int jc=0; jc<jmax_c; ++jc)
+            for (int ic=0; ic<imax_c; ++ic)
+            {
+                const unsigned long long block = (ic + mpicoordx*imax_c) + (jc + mpicoordy*jmax_c)*itot_c;
+                const unsigned long long r = hash_index(call_hash + block);
+
+                const int di = r % n_coarse;
+                const int dj = (r / n_coarse) % n_coarse;
+
+                sample[ic + jc*imax_c] = (ic*n_coarse + di) + (jc*n_coarse + dj)*imax;
+            }
+    }
+
     Float deg_to_rad(const Float deg)
     {
         return Float(2.*M_PI/360. * deg);
     }
+
+    // Band limits of the g-points that are kept if every band is sampled with
+    // gpt_sample_factor times fewer g-points, with at least one g-point per band.
+    Array<int,2> get_sampled_band_lims_gpt(const Array<int,2>& band_lims_gpt, const int gpt_sample_factor)
+    {
+        const int n_bnd = band_lims_gpt.dim(2);
+        Array<int,2> band_lims_gpt_sampled({2, n_bnd});
+
+        int n_gpt_sampled = 0;
+        for (int ibnd=1; ibnd<=n_bnd; ++ibnd)
+        {
+            const int n_gpt_bnd = band_lims_gpt({2, ibnd}) - band_lims_gpt({1, ibnd}) + 1;
+            const int n_gpt_bnd_sampled = std::max(1, n_gpt_bnd / gpt_sample_factor);
+
+            band_lims_gpt_sampled({1, ibnd}) = n_gpt_sampled + 1;
+            band_lims_gpt_sampled({2, ibnd}) = n_gpt_sampled + n_gpt_bnd_sampled;
+            n_gpt_sampled += n_gpt_bnd_sampled;
+        }
+
+        return band_lims_gpt_sampled;
+    }
+
+    // Weight of every sampled g-point, which is the number of g-points in its band divided by the
+    // number of sampled g-points. As every g-point is sampled with equal probability, the weighted
+    // sum over the sampled g-points is an unbiased estimate of the sum over all g-points.
+    std::vector<Float> get_sampled_gpt_weights(
+            const Array<int,2>& band_lims_gpt, const Array<int,2>& band_lims_gpt_sampled)
+    {
+        const int n_bnd = band_lims_gpt.dim(2);
+        std::vector<Float> weights(band_lims_gpt_sampled({2, n_bnd}));
+
+        for (int ibnd=1; ibnd<=n_bnd; ++ibnd)
+        {
+            const int n_gpt_bnd = band_lims_gpt({2, ibnd}) - band_lims_gpt({1, ibnd}) + 1;
+            const int n_gpt_bnd_sampled = band_lims_gpt_sampled({2, ibnd}) - band_lims_gpt_sampled({1, ibnd}) + 1;
+
+            for (int igpt=band_lims_gpt_sampled({1, ibnd}); igpt<=band_lims_gpt_sampled({2, ibnd}); ++igpt)
+                weights[igpt-1] = Float(n_gpt_bnd) / n_gpt_bnd_sampled;
+        }
+
+        return weights;
+    }
+
+    // Select the g-points of every band. A random sample draws the g-points without replacement
+    // from the hashed key, a rotating sample cycles through the band over consecutive calls.
+    void set_gpt_sample(
+            std::vector<int>& gpt, std::vector<int>& perm,
+            const Array<int,2>& band_lims_gpt, const Array<int,2>& band_lims_gpt_sampled,
+            const bool random, const unsigned long long key, const unsigned long long call_index)
+    {
+        const int n_bnd = band_lims_gpt.dim(2);
+        unsigned long long n_draw = 0;
+
+        for (int ibnd=1; ibnd<=n_bnd; ++ibnd)
+        {
+            const int gpt_beg = band_lims_gpt({1, ibnd});
+            const int n_gpt_bnd = band_lims_gpt({2, ibnd}) - gpt_beg + 1;
+            const int gpt_sampled_beg = band_lims_gpt_sampled({1, ibnd});
+            const int n_gpt_bnd_sampled = band_lims_gpt_sampled({2, ibnd}) - gpt_sampled_beg + 1;
+
+            if (random)
+            {
+                for (int n=0; n<n_gpt_bnd; ++n)
+                    perm[n] = n;
+
+                // Partial Fisher-Yates shuffle.
+                for (int n=0; n<n_gpt_bnd_sampled; ++n)
+                {
+                    const int m = n + hash_index(key + (++n_draw)) % (n_gpt_bnd - n);
+                    std::swap(perm[n], perm[m]);
+                    gpt[gpt_sampled_beg-1 + n] = gpt_beg + perm[n];
+                }
+            }
+            else
+            {
+                const int offset = (call_index * n_gpt_bnd_sampled) % n_gpt_bnd;
+                for (int n=0; n<n_gpt_bnd_sampled; ++n)
+                    gpt[gpt_sampled_beg-1 + n] = gpt_beg + (offset + n) % n_gpt_bnd;
+            }
+        }
+    }
+
+    // Copy the sampled g-points, which are the last and slowest varying dimension of the array.
+    template<int N>
+    void copy_sampled_gpts(Array<Float,N>& out, const Array<Float,N>& in, const std::vector<int>& gpt)
+    {
+        const int n_slice = in.size() / in.dim(N);
+        for (int n=0; n<static_cast<int>(gpt.size()); ++n)
+            std::copy(in.ptr() + (gpt[n]-1)*n_slice, in.ptr() + gpt[n]*n_slice, out.ptr() + n*n_slice);
+    }
+
+    void weigh_sampled_gpts(Array<Float,3>& gpt_flux, const std::vector<Float>& weights)
+    {
+        const int n_slice = gpt_flux.size() / gpt_flux.dim(3);
+        for (int n=0; n<static_cast<int>(weights.size()); ++n)
+            for (int i=0; i<n_slice; ++i)
+                gpt_flux.ptr()[i + n*n_slice] *= weights[n];
+    }
+
+    // Horizontal mean (bias) and rms of the difference between the sampled and full-spectrum net flux.
+    void calc_gpt_sample_error(
+            std::vector<Float>& bias, std::vector<Float>& rmse,
+            const Float* restrict flux_up, const Float* restrict flux_dn,
+            const Float* restrict flux_up_ref, const Float* restrict flux_dn_ref,
+            Master& master, const int ijmax, const int n_lev, const int kstart, const int ijtot)
+    {
+        for (int ilev=0; ilev<n_lev; ++ilev)
+        {
+            Float sum = Float(0.);
+            Float sum_sq = Float(0.);
+
+            for (int n=0; n<ijmax; ++n)
+            {
+                const int nk = n + ilev*ijmax;
+                const Float err = (flux_up[nk] - flux_dn[nk]) - (flux_up_ref[nk] - flux_dn_ref[nk]);
+                sum += err;
+                sum_sq += err*err;
+            }
+
+            bias[ilev+kstart] = sum;
+            rmse[ilev+kstart] = sum_sq;
+        }
+
+        master.sum(&bias[kstart], n_lev);
+        master.sum(&rmse[kstart], n_lev);
+
+        for (int k=kstart; k<kstart+n_lev; ++k)
+        {
+            bias[k] /= ijtot;
+            rmse[k] = std::sqrt(rmse[k] / ijtot);
+        }
+    }
+
+    // Work objects of one longwave column block. They are allocated once per thread
+    // and reused for all blocks that the thread solves. With g-point sampling, the solver
+    // works on copies of the sampled g-points with the spectral definition gpt_spec.
+    struct Lw_block_work
+    {
+        Lw_block_work(
+                const int n_col, const int n_lay, const int n_lev,
+                const Optical_props& kdist, const Optical_props& cloud, const Optical_props* gpt_spec) :
+            optical_props(std::make_unique<Optical_props_1scl>(n_col, n_lay, kdist)),
+            cloud_optical_props(std::make_unique<Optical_props_1scl>(n_col, n_lay, cloud)),
+            sources(n_col, n_lay, kdist),
+            fluxes(n_col, n_lev),
+            rel({n_col, n_lay}), rei({n_col, n_lay}),
+            gpt_flux_up({n_col, n_lev, (gpt_spec ? *gpt_spec : kdist).get_ngpt()}),
+            gpt_flux_dn({n_col, n_lev, (gpt_spec ? *gpt_spec : kdist).get_ngpt()})
+        {
+            if (gpt_spec)
+            {
+                const int n_gpt_sampled = gpt_spec->get_ngpt();
+                optical_props_gpt = std::make_unique<Optical_props_1scl>(n_col, n_lay, *gpt_spec);
+                sources_gpt = std::make_unique<Source_func_lw>(n_col, n_lay, *gpt_spec);
+                flux_dn_inc_gpt.set_dims({n_col, n_gpt_sampled});
+                gpt.resize(n_gpt_sampled);
+                perm.resize(kdist.get_ngpt());
+            }
+        }
+
+        std::unique_ptr<Optical_props_arry> optical_props;
+        std::unique_ptr<Optical_props_1scl> cloud_optical_props;
+        Source_func_lw sources;
+        Fluxes_broadband fluxes;
+
+        Array<Float,2> rel;
+        Array<Float,2> rei;
+        Array<Float,3> gpt_flux_up;
+        Array<Float,3> gpt_flux_dn;
+
+        std::unique_ptr<Optical_props_arry> optical_props_gpt;
+        std::unique_ptr<Source_func_lw> sources_gpt;
+        Array<Float,2> flux_dn_inc_gpt;
+        std::vector<int> gpt;
+        std::vector<int> perm;
+    };
+
+    // Work objects of one shortwave column block, see Lw_block_work.
+    struct Sw_block_work
+    {
+        Sw_block_work(
+                const int n_col, const int n_lay, const int n_lev,
+                const Optical_props& kdist, const Optical_props& cloud, const Optical_props* aerosol,
+                const Optical_props* gpt_spec) :
+            optical_props(std::make_unique<Optical_props_2str>(n_col, n_lay, kdist)),
+            cloud_optical_props(std::make_unique<Optical_props_2str>(n_col, n_lay, cloud)),
+            aerosol_optical_props(aerosol ? std::make_unique<Optical_props_2str>(n_col, n_lay, *aerosol) : nullptr),
+            fluxes(n_col, n_lev),
+            toa_src_dummy({n_col, kdist.get_ngpt()}),
+            rel({n_col, n_lay}), rei({n_col, n_lay}),
+            gpt_flux_up    ({n_col, n_lev, (gpt_spec ? *gpt_spec : kdist).get_ngpt()}),
+            gpt_flux_dn    ({n_col, n_lev, (gpt_spec ? *gpt_spec : kdist).get_ngpt()}),
+            gpt_flux_dn_dir({n_col, n_lev, (gpt_spec ? *gpt_spec : kdist).get_ngpt()})
+        {
+            if (gpt_spec)
+            {
+                const int n_gpt_sampled = gpt_spec->get_ngpt();
+                optical_props_gpt = std::make_unique<Optical_props_2str>(n_col, n_lay, *gpt_spec);
+                toa_src_gpt.set_dims({n_col, n_gpt_sampled});
+                flux_dn_dif_inc_gpt.set_dims({n_col, n_gpt_sampled});
+                gpt.resize(n_gpt_sampled);
+                perm.resize(kdist.get_ngpt());
+            }
+        }
+
+        std::unique_ptr<Optical_props_arry> optical_props;
+        std::unique_ptr<Optical_props_2str> cloud_optical_props;
+        std::unique_ptr<Optical_props_2str> aerosol_optical_props;
+        Fluxes_broadband fluxes;
+
+        Array<Float,2> toa_src_dummy;
+        Array<Float,2> rel;
+        Array<Float,2> rei;
+        Array<Float,3> gpt_flux_up;
+        Array<Float,3> gpt_flux_dn;
+        Array<Float,3> gpt_flux_dn_dir;
+
+        std::unique_ptr<Optical_props_arry> optical_props_gpt;
+        Array<Float,2> toa_src_gpt;
+        Array<Float,2> flux_dn_dif_inc_gpt;
+        std::vector<int> gpt;
+        std::vector<int> perm;
+    };
 }
 
 
@@ -677,6 +988,48 @@ Radiation_rrtmgp<TF>::Radiation_rrtmgp(
 
     dt_rad = inputin.get_item<double>("radiation", "dt_rad", "");
 
+    n_col_block = inputin.get_item<int>("radiation", "n_col_block", "", 4);
+    if (n_col_block < 1)
+        throw std::runtime_error("Radiation n_col_block has to be at least 1.");
+
+    // The model runs its CPU kernels on a single thread, so the threads of the block loop are set here.
+    n_threads = inputin.get_item<int>("radiation", "n_threads", "", 1);
+    if (n_threads < 1)
+        throw std::runtime_error("Radiation n_threads has to be at least 1.");
+
+    swcoarse = inputin.get_item<std::string>("radiation", "swcoarse", "", "0");
+    if (swcoarse == "0")
+        n_coarse = 1;
+    else if (swcoarse == "mean" || swcoarse == "random")
+    {
+        #ifdef USECUDA
+        throw std::runtime_error("Coarse radiation is not (yet) implemented on the GPU.");
+        #endif
+
+        n_coarse = inputin.get_item<int>("radiation", "n_coarse", "");
+        if (n_coarse < 1)
+            throw std::runtime_error("Radiation n_coarse has to be at least 1.");
+    }
+    else
+        throw std::runtime_error("Invalid option for \"swcoarse\"");
+
+    swgptsample = inputin.get_item<std::string>("radiation", "swgptsample", "", "0");
+    gpt_sample_call = 0;
+    if (swgptsample == "0")
+        gpt_sample_factor = 1;
+    else if (swgptsample == "random" || swgptsample == "rotate")
+    {
+        #ifdef USECUDA
+        throw std::runtime_error("G-point sampling is not (yet) implemented on the GPU.");
+        #endif
+
+        gpt_sample_factor = inputin.get_item<int>("radiation", "gpt_sample_factor", "");
+        if (gpt_sample_factor < 1)
+            throw std::runtime_error("Radiation gpt_sample_factor has to be at least 1.");
+    }
+    else
+        throw std::runtime_error("Invalid option for \"swgptsample\"");
+
     t_sfc       = inputin.get_item<Float>("radiation", "t_sfc"      , "");
     tsi_scaling = inputin.get_item<Float>("radiation", "tsi_scaling", "", -999.);
 
@@ -801,6 +1154,19 @@ void Radiation_rrtmgp<TF>::init(Timeloop<TF>& timeloop)
 
     // initialize aod
     aod550.set_dims({gd.imax*gd.jmax});
+
+    // Statistics of the g-point sampling error on the flux levels.
+    if (swgptsample != "0")
+    {
+        lw_gpt_bias.resize(gd.kcells);
+        lw_gpt_rmse.resize(gd.kcells);
+        sw_gpt_bias.resize(gd.kcells);
+        sw_gpt_rmse.resize(gd.kcells);
+    }
+
+    // The coarse blocks may not cross the boundaries of the MPI subdomains.
+    if (gd.imax % n_coarse != 0 || gd.jmax % n_coarse != 0)
+        throw std::runtime_error("Radiation n_coarse has to be a divisor of imax and jmax");
 }
 
 
@@ -1458,6 +1824,12 @@ void Radiation_rrtmgp<TF>::create_solver_longwave(
             stats.add_prof("lw_flux_up_clear", "Clear-sky longwave upwelling flux"  , "W m-2", "zh", group_name);
             stats.add_prof("lw_flux_dn_clear", "Clear-sky longwave downwelling flux", "W m-2", "zh", group_name);
         }
+
+        if (swgptsample != "0")
+        {
+            stats.add_prof("lw_gpt_bias", "Longwave net flux bias of g-point sampling", "W m-2", "zh", group_name);
+            stats.add_prof("lw_gpt_rmse", "Longwave net flux rms error of g-point sampling", "W m-2", "zh", group_name);
+        }
     }
 
     // Set up the column statistics
@@ -1522,6 +1894,12 @@ void Radiation_rrtmgp<TF>::create_solver_shortwave(
             stats.add_prof("sw_flux_dn_clear"    , "Clear-sky shortwave downwelling flux"       , "W m-2", "zh", group_name);
             stats.add_prof("sw_flux_dn_dir_clear", "Clear-sky shortwave direct downwelling flux", "W m-2", "zh", group_name);
         }
+
+        if (swgptsample != "0")
+        {
+            stats.add_prof("sw_gpt_bias", "Shortwave net flux bias of g-point sampling", "W m-2", "zh", group_name);
+            stats.add_prof("sw_gpt_rmse", "Shortwave net flux rms error of g-point sampling", "W m-2", "zh", group_name);
+        }
     }
 
     // Set up the column statistics
@@ -1679,6 +2057,95 @@ void Radiation_rrtmgp<TF>::exec(
 
         const bool compute_clouds = true;
 
+        // With coarse radiation, the solver runs on one column per n_coarse x n_coarse block.
+        // The fluxes are copied back to all columns of the block, which maps the heating rates
+        // and surface fluxes to the full grid. The blocks lie within the MPI subdomain.
+        const bool sw_coarse = (swcoarse != "0");
+        const int n_col_rad = ijmax / (n_coarse*n_coarse);
+
+        Array<Float,2> t_lay_c, t_lev_c, h2o_c, rh_c, clwp_c, ciwp_c;
+        Array<Float,1> t_sfc_c;
+        Array<Float,2> flux_up_c, flux_dn_c, flux_net_c;
+
+        if (sw_coarse)
+        {
+            std::vector<int> sample;
+            if (swcoarse == "random")
+            {
+                auto& md = master.get_MPI_data();
+                sample.resize(n_col_rad);
+                set_coarse_sample(
+                        sample.data(), timeloop.get_itime() / idt_rad,
+                        n_coarse, gd.imax, gd.jmax, gd.itot,
+                        md.mpicoordx, md.mpicoordy);
+            }
+
+            auto coarsen = [&](Float* out, const Float* in, const int n_lev_in)
+            {
+                if (swcoarse == "random")
+                    coarsen_sample(out, in, sample.data(), ijmax, n_col_rad, n_lev_in);
+                else
+                    coarsen_block_mean(out, in, n_coarse, gd.imax, gd.jmax, n_lev_in);
+            };
+
+            t_lay_c.set_dims({n_col_rad, gd.ktot});
+            t_lev_c.set_dims({n_col_rad, gd.ktot+1});
+            t_sfc_c.set_dims({n_col_rad});
+            h2o_c  .set_dims({n_col_rad, gd.ktot});
+            rh_c   .set_dims({n_col_rad, gd.ktot});
+            clwp_c .set_dims({n_col_rad, gd.ktot});
+            ciwp_c .set_dims({n_col_rad, gd.ktot});
+
+            coarsen(t_lay_c.ptr(), t_lay_a.ptr(), gd.ktot);
+            coarsen(t_lev_c.ptr(), t_lev_a.ptr(), gd.ktot+1);
+            coarsen(t_sfc_c.ptr(), t_sfc_a.ptr(), 1);
+            coarsen(h2o_c  .ptr(), h2o_a  .ptr(), gd.ktot);
+            coarsen(rh_c   .ptr(), rh_a   .ptr(), gd.ktot);
+            coarsen(clwp_c .ptr(), clwp_a .ptr(), gd.ktot);
+            coarsen(ciwp_c .ptr(), ciwp_a .ptr(), gd.ktot);
+
+            flux_up_c .set_dims({n_col_rad, gd.ktot+1});
+            flux_dn_c .set_dims({n_col_rad, gd.ktot+1});
+            flux_net_c.set_dims({n_col_rad, gd.ktot+1});
+        }
+
+        const Array<Float,2>& t_lay_r = sw_coarse ? t_lay_c : t_lay_a;
+        const Array<Float,2>& t_lev_r = sw_coarse ? t_lev_c : t_lev_a;
+        const Array<Float,1>& t_sfc_r = sw_coarse ? t_sfc_c : t_sfc_a;
+        const Array<Float,2>& h2o_r   = sw_coarse ? h2o_c   : h2o_a;
+        const Array<Float,2>& rh_r    = sw_coarse ? rh_c    : rh_a;
+        const Array<Float,2>& clwp_r  = sw_coarse ? clwp_c  : clwp_a;
+        const Array<Float,2>& ciwp_r  = sw_coarse ? ciwp_c  : ciwp_a;
+
+        Array<Float,2>& flux_up_r  = sw_coarse ? flux_up_c  : flux_up;
+        Array<Float,2>& flux_dn_r  = sw_coarse ? flux_dn_c  : flux_dn;
+        Array<Float,2>& flux_net_r = sw_coarse ? flux_net_c : flux_net;
+
+        auto expand = [&](Float* out, const Float* in, const int n_lev_in)
+        {
+            expand_coarse(out, in, n_coarse, gd.imax, gd.jmax, n_lev_in);
+        };
+
+        // With g-point sampling, every radiation call draws a new sample.
+        const bool sample_gpt = (swgptsample != "0");
+        gpt_sample_call = timeloop.get_itime() / idt_rad;
+
+        auto solve_longwave = [&](const bool compute_clouds_in, const bool sample_gpt_in)
+        {
+            exec_longwave(
+                    thermo, microphys, timeloop, stats,
+                    flux_up_r, flux_dn_r, flux_net_r,
+                    t_lay_r, t_lev_r, t_sfc_r, h2o_r, clwp_r, ciwp_r,
+                    compute_clouds_in, n_col_rad, sample_gpt_in);
+
+            if (sw_coarse)
+            {
+                expand(flux_up .ptr(), flux_up_c .ptr(), gd.ktot+1);
+                expand(flux_dn .ptr(), flux_dn_c .ptr(), gd.ktot+1);
+                expand(flux_net.ptr(), flux_net_c.ptr(), gd.ktot+1);
+            }
+        };
+
         // get aerosol mixing ratios
         if (sw_aerosol && swtimedep_aerosol)
             aerosol.get_radiation_fields(aerosol_concs);
@@ -1708,11 +2175,7 @@ void Radiation_rrtmgp<TF>::exec(
                     set_background_column_longwave(p_top);
                 }
 
-                exec_longwave(
-                        thermo, microphys, timeloop, stats,
-                        flux_up, flux_dn, flux_net,
-                        t_lay_a, t_lev_a, t_sfc_a, h2o_a, clwp_a, ciwp_a,
-                        compute_clouds, gd.imax*gd.jmax);
+                solve_longwave(compute_clouds, sample_gpt);
 
                 calc_tendency(
                         fields.sd.at("thlt_rad")->fld.data(),
@@ -1750,13 +2213,24 @@ void Radiation_rrtmgp<TF>::exec(
                     do_gcs(*fields.sd.at("lw_flux_up"), flux_up);
                     do_gcs(*fields.sd.at("lw_flux_dn"), flux_dn);
 
+                    if (sample_gpt)
+                    {
+                        // Compare the sampled fluxes with the full spectrum for the statistics.
+                        const Array<Float,2> flux_up_sampled(flux_up);
+                        const Array<Float,2> flux_dn_sampled(flux_dn);
+
+                        solve_longwave(compute_clouds, false);
+
+                        calc_gpt_sample_error(
+                                lw_gpt_bias, lw_gpt_rmse,
+                                flux_up_sampled.ptr(), flux_dn_sampled.ptr(),
+                                flux_up.ptr(), flux_dn.ptr(),
+                                master, ijmax, gd.ktot+1, gd.kstart, gd.itot*gd.jtot);
+                    }
+
                     if (sw_clear_sky_stats)
                     {
-                        exec_longwave(
-                                thermo, microphys, timeloop, stats,
-                                flux_up, flux_dn, flux_net,
-                                t_lay_a, t_lev_a, t_sfc_a, h2o_a, clwp_a, ciwp_a,
-                                !compute_clouds, gd.imax*gd.jmax);
+                        solve_longwave(!compute_clouds, sample_gpt);
 
                         do_gcs(*fields.sd.at("lw_flux_up_clear"), flux_up);
                         do_gcs(*fields.sd.at("lw_flux_dn_clear"), flux_dn);
@@ -1783,14 +2257,42 @@ void Radiation_rrtmgp<TF>::exec(
                 }
 
                 Array<Float,2> flux_dn_dir({gd.imax*gd.jmax, gd.ktot+1});
-                if (is_day(this->mu0))
+
+                Array<Float,2> flux_dn_dir_c;
+                Array<Float,1> aod550_c;
+                if (sw_coarse)
+                {
+                    flux_dn_dir_c.set_dims({n_col_rad, gd.ktot+1});
+                    aod550_c.set_dims({n_col_rad});
+                }
+
+                Array<Float,2>& flux_dn_dir_r = sw_coarse ? flux_dn_dir_c : flux_dn_dir;
+                Array<Float,1>& aod550_r = sw_coarse ? aod550_c : aod550;
+
+                auto solve_shortwave = [&](const bool compute_clouds_in, const bool sample_gpt_in)
                 {
                     exec_shortwave(
                             thermo, microphys, timeloop, stats,
-                            flux_up, flux_dn, flux_dn_dir, flux_net,
-                            aod550,
-                            t_lay_a, t_lev_a, h2o_a, rh_a, clwp_a, ciwp_a,
-                            compute_clouds, gd.imax * gd.jmax);
+                            flux_up_r, flux_dn_r, flux_dn_dir_r, flux_net_r,
+                            aod550_r,
+                            t_lay_r, t_lev_r, h2o_r, rh_r, clwp_r, ciwp_r,
+                            compute_clouds_in, n_col_rad, sample_gpt_in);
+
+                    if (sw_coarse)
+                    {
+                        expand(flux_up    .ptr(), flux_up_c    .ptr(), gd.ktot+1);
+                        expand(flux_dn    .ptr(), flux_dn_c    .ptr(), gd.ktot+1);
+                        expand(flux_dn_dir.ptr(), flux_dn_dir_c.ptr(), gd.ktot+1);
+                        expand(flux_net   .ptr(), flux_net_c   .ptr(), gd.ktot+1);
+
+                        if (sw_aerosol)
+                            expand(aod550.ptr(), aod550_c.ptr(), 1);
+                    }
+                };
+
+                if (is_day(this->mu0))
+                {
+                    solve_shortwave(compute_clouds, sample_gpt);
 
                     calc_tendency(
                             fields.sd.at("thlt_rad")->fld.data(),
@@ -1866,16 +2368,34 @@ void Radiation_rrtmgp<TF>::exec(
                     do_gcs(*fields.sd.at("sw_flux_dn"), flux_dn);
                     do_gcs(*fields.sd.at("sw_flux_dn_dir"), flux_dn_dir);
 
+                    if (sample_gpt)
+                    {
+                        // Compare the sampled fluxes with the full spectrum for the statistics.
+                        if (is_day(this->mu0))
+                        {
+                            const Array<Float,2> flux_up_sampled(flux_up);
+                            const Array<Float,2> flux_dn_sampled(flux_dn);
+
+                            solve_shortwave(compute_clouds, false);
+
+                            calc_gpt_sample_error(
+                                    sw_gpt_bias, sw_gpt_rmse,
+                                    flux_up_sampled.ptr(), flux_dn_sampled.ptr(),
+                                    flux_up.ptr(), flux_dn.ptr(),
+                                    master, ijmax, gd.ktot+1, gd.kstart, gd.itot*gd.jtot);
+                        }
+                        else
+                        {
+                            std::fill(sw_gpt_bias.begin(), sw_gpt_bias.end(), Float(0.));
+                            std::fill(sw_gpt_rmse.begin(), sw_gpt_rmse.end(), Float(0.));
+                        }
+                    }
+
                     if (sw_clear_sky_stats)
                     {
                         if (is_day(this->mu0))
                         {
-                            exec_shortwave(
-                                    thermo, microphys, timeloop, stats,
-                                    flux_up, flux_dn, flux_dn_dir, flux_net,
-                                    aod550,
-                                    t_lay_a, t_lev_a, h2o_a, rh_a, clwp_a, ciwp_a,
-                                    !compute_clouds, gd.imax * gd.jmax);
+                            solve_shortwave(!compute_clouds, sample_gpt);
                         }
                         do_gcs(*fields.sd.at("sw_flux_up_clear"), flux_up);
                         do_gcs(*fields.sd.at("sw_flux_dn_clear"), flux_dn);
@@ -1990,6 +2510,12 @@ void Radiation_rrtmgp<TF>::exec_all_stats(
                 save_stats_and_cross(*fields.sd.at("lw_flux_dn_clear"), "lw_flux_dn_clear", gd.wloc);
             }
 
+            if (do_stats && swgptsample != "0")
+            {
+                stats.set_prof("lw_gpt_bias", lw_gpt_bias);
+                stats.set_prof("lw_gpt_rmse", lw_gpt_rmse);
+            }
+
             if (swtimedep_background)
             {
                 stats.set_prof_background("lw_flux_up_ref", lw_flux_up_col.v());
@@ -2010,6 +2536,12 @@ void Radiation_rrtmgp<TF>::exec_all_stats(
                 save_stats_and_cross(*fields.sd.at("sw_flux_dn_dir_clear"), "sw_flux_dn_dir_clear", gd.wloc);
             }
 
+            if (do_stats && swgptsample != "0")
+            {
+                stats.set_prof("sw_gpt_bias", sw_gpt_bias);
+                stats.set_prof("sw_gpt_rmse", sw_gpt_rmse);
+            }
+
             bool cross_diff = std::find(crosslist.begin(), crosslist.end(), "sw_flux_dn_diff_filtered") != crosslist.end();
             if (sw_diffuse_filter && do_cross && cross_diff)
             {
@@ -2278,11 +2810,8 @@ void Radiation_rrtmgp<TF>::exec_longwave(
         Array<Float,2>& flux_up, Array<Float,2>& flux_dn, Array<Float,2>& flux_net,
         const Array<Float,2>& t_lay, const Array<Float,2>& t_lev, const Array<Float,1>& t_sfc,
         const Array<Float,2>& h2o, const Array<Float,2>& clwp, const Array<Float,2>& ciwp,
-        const bool compute_clouds, const int n_col)
+        const bool compute_clouds, const int n_col, const bool sample_gpt)
 {
-    // How many profiles are solved simultaneously?
-    constexpr int n_col_block = 4;
-
     auto& gd = grid.get_grid_data();
 
     const int n_lay = gd.ktot;
@@ -2301,20 +2830,21 @@ void Radiation_rrtmgp<TF>::exec_longwave(
     // Check the dimension ordering. The top is not at 1 in MicroHH, but the surface is.
     const int top_at_1 = 0;
 
-    // Define the pointers for the subsetting.
-    std::unique_ptr<Optical_props_arry> optical_props_subset =
-            std::make_unique<Optical_props_1scl>(n_col_block, n_lay, *kdist_lw);
-    std::unique_ptr<Source_func_lw> sources_subset =
-            std::make_unique<Source_func_lw>(n_col_block, n_lay, *kdist_lw);
-    std::unique_ptr<Optical_props_1scl> cloud_optical_props_subset =
-            std::make_unique<Optical_props_1scl>(n_col_block, n_lay, *cloud_lw);
-
-    std::unique_ptr<Optical_props_arry> optical_props_left =
-            std::make_unique<Optical_props_1scl>(n_col_block_left, n_lay, *kdist_lw);
-    std::unique_ptr<Source_func_lw> sources_left =
-            std::make_unique<Source_func_lw>(n_col_block_left, n_lay, *kdist_lw);
-    std::unique_ptr<Optical_props_1scl> cloud_optical_props_left =
-            std::make_unique<Optical_props_1scl>(n_col_block_left, n_lay, *cloud_lw);
+    // With g-point sampling, the solver runs on a spectral definition with fewer g-points per band.
+    const Array<int,2> band_lims_gpt = kdist_lw->get_band_lims_gpoint();
+    Array<int,2> band_lims_gpt_sampled;
+    std::vector<Float> gpt_weights;
+    std::unique_ptr<Optical_props> gpt_spec;
+
+    if (sample_gpt)
+    {
+        band_lims_gpt_sampled = get_sampled_band_lims_gpt(band_lims_gpt, gpt_sample_factor);
+        gpt_weights = get_sampled_gpt_weights(band_lims_gpt, band_lims_gpt_sampled);
+        gpt_spec = std::make_unique<Optical_props>(kdist_lw->get_band_lims_wavenumber(), band_lims_gpt_sampled);
+    }
+
+    const unsigned long long gpt_sample_key =
+            hash_index(gpt_sample_call) ^ hash_index(master.get_mpiid() + 1);
 
     // Define the arrays that contain the subsets.
     const std::vector<Float>& p  = thermo.get_basestate_vector("p");
@@ -2327,18 +2857,18 @@ void Radiation_rrtmgp<TF>::exec_longwave(
     Gas_optics_rrtmgp::get_col_dry(col_dry, gas_concs.get_vmr("h2o"), p_lev.subset({{ {1, n_col}, {1, n_lev} }}));
 
     // Lambda function for solving optical properties subset.
+    // The lambda is called concurrently for different blocks, therefore it writes only
+    // to the work objects and to the columns col_s_in to col_e_in of the output.
     auto call_kernels = [&](
             const int col_s_in, const int col_e_in,
-            std::unique_ptr<Optical_props_arry>& optical_props_subset_in,
-            std::unique_ptr<Optical_props_1scl>& cloud_optical_props_in,
-            Source_func_lw& sources_subset_in,
-            const Array<Float,2>& emis_sfc_subset_in,
-            const Array<Float,2>& lw_flux_dn_inc_subset_in,
-            std::unique_ptr<Fluxes_broadband>& fluxes)
+            Lw_block_work& work)
     {
         const int n_col_in = col_e_in - col_s_in + 1;
         Gas_concs gas_concs_subset(gas_concs, col_s_in, n_col_in);
 
+        std::unique_ptr<Optical_props_arry>& optical_props_subset_in = work.optical_props;
+        Source_func_lw& sources_subset_in = work.sources;
+
         kdist_lw->gas_optics(
                 p_lay.subset({{ {col_s_in, col_e_in}, {1, n_lay} }}),
                 p_lev.subset({{ {col_s_in, col_e_in}, {1, n_lev} }}),
@@ -2357,8 +2887,8 @@ void Radiation_rrtmgp<TF>::exec_longwave(
             Array<Float,2> ciwp_subset(ciwp.subset({{ {col_s_in, col_e_in}, {1, n_lay} }}));
 
             // Compute the effective droplet radius.
-            Array<Float,2> rel({n_col_in, n_lay});
-            Array<Float,2> rei({n_col_in, n_lay});
+            Array<Float,2>& rel = work.rel;
+            Array<Float,2>& rei = work.rei;
 
             const Float sig_g = 1.34;
             const Float fac = std::exp(std::log(sig_g)*std::log(sig_g)); // no conversion to micron yet.
@@ -2403,76 +2933,110 @@ void Radiation_rrtmgp<TF>::exec_longwave(
             cloud_lw->cloud_optics(
                     clwp_subset, ciwp_subset,
                     rel, rei,
-                    *cloud_optical_props_in);
+                    *work.cloud_optical_props);
 
             // Add the cloud optical props to the gas optical properties.
             add_to(
                     dynamic_cast<Optical_props_1scl&>(*optical_props_subset_in),
-                    dynamic_cast<Optical_props_1scl&>(*cloud_optical_props_in));
+                    dynamic_cast<Optical_props_1scl&>(*work.cloud_optical_props));
         }
 
-        Array<Float,3> gpt_flux_up({n_col_in, n_lev, n_gpt});
-        Array<Float,3> gpt_flux_dn({n_col_in, n_lev, n_gpt});
-
-        Rte_lw::rte_lw(
-                optical_props_subset_in,
-                top_at_1,
-                sources_subset_in,
-                emis_sfc_subset_in,
-                lw_flux_dn_inc_subset_in,
-                gpt_flux_up, gpt_flux_dn,
-                n_ang);
+        if (!sample_gpt)
+        {
+            Rte_lw::rte_lw(
+                    optical_props_subset_in,
+                    top_at_1,
+                    sources_subset_in,
+                    emis_sfc.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    lw_flux_dn_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}),
+                    work.gpt_flux_up, work.gpt_flux_dn,
+                    n_ang);
+
+            work.fluxes.reduce(work.gpt_flux_up, work.gpt_flux_dn, optical_props_subset_in, top_at_1);
+        }
+        else
+        {
+            // 3. Solve only the sampled g-points and weigh them before the spectral integration.
+            set_gpt_sample(
+                    work.gpt, work.perm, band_lims_gpt, band_lims_gpt_sampled,
+                    swgptsample == "random", hash_index(gpt_sample_key + col_s_in), gpt_sample_call);
+
+            copy_sampled_gpts(work.optical_props_gpt->get_tau(), optical_props_subset_in->get_tau(), work.gpt);
+            copy_sampled_gpts(work.sources_gpt->get_sfc_source(), sources_subset_in.get_sfc_source(), work.gpt);
+            copy_sampled_gpts(work.sources_gpt->get_lay_source(), sources_subset_in.get_lay_source(), work.gpt);
+            copy_sampled_gpts(work.sources_gpt->get_lev_source_inc(), sources_subset_in.get_lev_source_inc(), work.gpt);
+            copy_sampled_gpts(work.sources_gpt->get_lev_source_dec(), sources_subset_in.get_lev_source_dec(), work.gpt);
+            copy_sampled_gpts(
+                    work.flux_dn_inc_gpt, lw_flux_dn_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}), work.gpt);
+
+            Rte_lw::rte_lw(
+                    work.optical_props_gpt,
+                    top_at_1,
+                    *work.sources_gpt,
+                    emis_sfc.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    work.flux_dn_inc_gpt,
+                    work.gpt_flux_up, work.gpt_flux_dn,
+                    n_ang);
+
+            weigh_sampled_gpts(work.gpt_flux_up, gpt_weights);
+            weigh_sampled_gpts(work.gpt_flux_dn, gpt_weights);
+
+            work.fluxes.reduce(work.gpt_flux_up, work.gpt_flux_dn, work.optical_props_gpt, top_at_1);
+        }
 
-        fluxes->reduce(gpt_flux_up, gpt_flux_dn, optical_props_subset_in, top_at_1);
+        Fluxes_broadband& fluxes = work.fluxes;
 
         // Copy the data to the output.
         for (int ilev=1; ilev<=n_lev; ++ilev)
             for (int icol=1; icol<=n_col_in; ++icol)
             {
-                flux_up ({icol+col_s_in-1, ilev}) = fluxes->get_flux_up ()({icol, ilev});
-                flux_dn ({icol+col_s_in-1, ilev}) = fluxes->get_flux_dn ()({icol, ilev});
-                flux_net({icol+col_s_in-1, ilev}) = fluxes->get_flux_net()({icol, ilev});
+                flux_up ({icol+col_s_in-1, ilev}) = fluxes.get_flux_up ()({icol, ilev});
+                flux_dn ({icol+col_s_in-1, ilev}) = fluxes.get_flux_dn ()({icol, ilev});
+                flux_net({icol+col_s_in-1, ilev}) = fluxes.get_flux_net()({icol, ilev});
             }
     };
 
-    for (int b=1; b<=n_blocks; ++b)
+    // Solve the full blocks concurrently. Each thread allocates its work objects at its
+    // first block. Exceptions cannot leave the parallel region and are rethrown after it.
+    std::exception_ptr block_exception = nullptr;
+
+    #pragma omp parallel num_threads(n_threads) if (n_blocks > 1 && n_threads > 1)
     {
-        const int col_s = (b-1) * n_col_block + 1;
-        const int col_e =  b    * n_col_block;
+        std::unique_ptr<Lw_block_work> work;
+
+        #pragma omp for schedule(static)
+        for (int b=1; b<=n_blocks; ++b)
+        {
+            try
+            {
+                if (!work)
+                    work = std::make_unique<Lw_block_work>(
+                            n_col_block, n_lay, n_lev, *kdist_lw, *cloud_lw, gpt_spec.get());
 
-        Array<Float,2> emis_sfc_subset = emis_sfc.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> lw_flux_dn_inc_subset = lw_flux_dn_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
-        std::unique_ptr<Fluxes_broadband> fluxes_subset =
-                std::make_unique<Fluxes_broadband>(n_col_block, n_lev);
+                const int col_s = (b-1) * n_col_block + 1;
+                const int col_e =  b    * n_col_block;
 
-        call_kernels(
-                col_s, col_e,
-                optical_props_subset,
-                cloud_optical_props_subset,
-                *sources_subset,
-                emis_sfc_subset,
-                lw_flux_dn_inc_subset,
-                fluxes_subset);
+                call_kernels(col_s, col_e, *work);
+            }
+            catch (...)
+            {
+                #pragma omp critical
+                block_exception = std::current_exception();
+            }
+        }
     }
 
+    if (block_exception)
+        std::rethrow_exception(block_exception);
+
     if (n_col_block_left > 0)
     {
         const int col_s = n_col - n_col_block_left + 1;
         const int col_e = n_col;
 
-        Array<Float,2> emis_sfc_left = emis_sfc.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> lw_flux_dn_inc_left = lw_flux_dn_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
-        std::unique_ptr<Fluxes_broadband> fluxes_left =
-                std::make_unique<Fluxes_broadband>(n_col_block_left, n_lev);
+        Lw_block_work work_left(n_col_block_left, n_lay, n_lev, *kdist_lw, *cloud_lw, gpt_spec.get());
 
-        call_kernels(
-                col_s, col_e,
-                optical_props_left,
-                cloud_optical_props_left,
-                *sources_left,
-                emis_sfc_left,
-                lw_flux_dn_inc_left,
-                fluxes_left);
+        call_kernels(col_s, col_e, work_left);
     }
 }
 
@@ -2486,11 +3050,8 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
         const Array<Float,2>& t_lay, const Array<Float,2>& t_lev,
         const Array<Float,2>& h2o, const Array<Float, 2>& rh,
         const Array<Float,2>& clwp, const Array<Float,2>& ciwp,
-        const bool compute_clouds, const int n_col)
+        const bool compute_clouds, const int n_col, const bool sample_gpt)
 {
-    // How many profiles are solved simultaneously?
-    constexpr int n_col_block = 4;
-
     auto& gd = grid.get_grid_data();
 
     const int n_lay = gd.ktot;
@@ -2506,28 +3067,22 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
     // Check the dimension ordering. The top is not at 1 in MicroHH, but the surface is.
     const int top_at_1 = 0;
 
-    // Define the pointers for the subsetting.
-    std::unique_ptr<Optical_props_arry> optical_props_subset =
-            std::make_unique<Optical_props_2str>(n_col_block, n_lay, *kdist_sw);
-    std::unique_ptr<Optical_props_2str> cloud_optical_props_subset =
-            std::make_unique<Optical_props_2str>(n_col_block, n_lay, *cloud_sw);
-    std::unique_ptr<Optical_props_2str> aerosol_optical_props_subset;
-    if (sw_aerosol)
-    {
-        aerosol_optical_props_subset = std::make_unique<Optical_props_2str>(n_col_block, n_lay, *aerosol_sw);
-    }
-
+    // With g-point sampling, the solver runs on a spectral definition with fewer g-points per band.
+    const Array<int,2> band_lims_gpt = kdist_sw->get_band_lims_gpoint();
+    Array<int,2> band_lims_gpt_sampled;
+    std::vector<Float> gpt_weights;
+    std::unique_ptr<Optical_props> gpt_spec;
 
-    std::unique_ptr<Optical_props_arry> optical_props_left =
-            std::make_unique<Optical_props_2str>(n_col_block_left, n_lay, *kdist_sw);
-    std::unique_ptr<Optical_props_2str> cloud_optical_props_left =
-            std::make_unique<Optical_props_2str>(n_col_block_left, n_lay, *cloud_sw);
-    std::unique_ptr<Optical_props_2str> aerosol_optical_props_left;
-    if (sw_aerosol)
+    if (sample_gpt)
     {
-        aerosol_optical_props_left = std::make_unique<Optical_props_2str>(n_col_block_left, n_lay, *aerosol_sw);
+        band_lims_gpt_sampled = get_sampled_band_lims_gpt(band_lims_gpt, gpt_sample_factor);
+        gpt_weights = get_sampled_gpt_weights(band_lims_gpt, band_lims_gpt_sampled);
+        gpt_spec = std::make_unique<Optical_props>(kdist_sw->get_band_lims_wavenumber(), band_lims_gpt_sampled);
     }
 
+    const unsigned long long gpt_sample_key =
+            hash_index(gpt_sample_call) ^ hash_index(master.get_mpiid() + 1);
+
     // Define the arrays that contain the subsets.
     std::vector<Float> p  = thermo.get_basestate_vector("p");
     std::vector<Float> ph = thermo.get_basestate_vector("ph");
@@ -2545,22 +3100,19 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
     Gas_optics_rrtmgp::get_col_dry(col_dry, gas_concs.get_vmr("h2o"), p_lev.subset({{ {1, n_col}, {1, n_lev} }}));
 
     // Lambda function for solving optical properties subset.
+    // The lambda is called concurrently for different blocks, therefore it writes only
+    // to the work objects and to the columns col_s_in to col_e_in of the output.
     auto call_kernels = [&](
             const int col_s_in, const int col_e_in,
-            std::unique_ptr<Optical_props_arry>& optical_props_subset_in,
-            std::unique_ptr<Optical_props_2str>& cloud_optical_props_in,
-            std::unique_ptr<Optical_props_2str>& aerosol_optical_props_in,
-            const Array<Float,1>& mu0_subset_in,
-            const Array<Float,2>& toa_src_subset_in,
-            const Array<Float,2>& sfc_alb_dir_subset_in,
-            const Array<Float,2>& sfc_alb_dif_subset_in,
-            const Array<Float,2>& sw_flux_dn_dif_inc_subset_in,
-            std::unique_ptr<Fluxes_broadband>& fluxes)
+            Sw_block_work& work)
     {
         const int n_col_in = col_e_in - col_s_in + 1;
 
         Gas_concs gas_concs_subset(gas_concs, col_s_in, n_col_in);
-        Array<Float,2> toa_src_dummy({n_col_in, n_gpt});
+
+        std::unique_ptr<Optical_props_arry>& optical_props_subset_in = work.optical_props;
+        std::unique_ptr<Optical_props_2str>& cloud_optical_props_in = work.cloud_optical_props;
+        std::unique_ptr<Optical_props_2str>& aerosol_optical_props_in = work.aerosol_optical_props;
 
         // 1. Solve the gas optical properties.
         kdist_sw->gas_optics(
@@ -2569,7 +3121,7 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
                 t_lay.subset({{ {col_s_in, col_e_in}, {1, n_lay} }}),
                 gas_concs_subset,
                 optical_props_subset_in,
-                toa_src_dummy,
+                work.toa_src_dummy,
                 col_dry.subset({{ {col_s_in, col_e_in}, {1, n_lay} }}) );
 
         // 2. Solve the cloud optical properties.
@@ -2579,8 +3131,8 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
             Array<Float,2> ciwp_subset(ciwp.subset({{ {col_s_in, col_e_in}, {1, n_lay} }}));
 
             // Compute the effective droplet radius.
-            Array<Float,2> rel({n_col_in, n_lay});
-            Array<Float,2> rei({n_col_in, n_lay});
+            Array<Float,2>& rel = work.rel;
+            Array<Float,2>& rei = work.rei;
 
             const Float sig_g = 1.34;
             const Float fac = std::exp(std::log(sig_g)*std::log(sig_g)); // no conversion to micron yet.
@@ -2674,90 +3226,121 @@ void Radiation_rrtmgp<TF>::exec_shortwave(
             }
 
         // 3. Solve the fluxes.
-        Array<Float,3> gpt_flux_up    ({n_col_in, n_lev, n_gpt});
-        Array<Float,3> gpt_flux_dn    ({n_col_in, n_lev, n_gpt});
-        Array<Float,3> gpt_flux_dn_dir({n_col_in, n_lev, n_gpt});
+        if (!sample_gpt)
+        {
+            Rte_sw::rte_sw(
+                    optical_props_subset_in,
+                    top_at_1,
+                    mu0.subset({{ {col_s_in, col_e_in} }}),
+                    sw_flux_dn_dir_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}),
+                    sfc_alb_dir.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    sfc_alb_dif.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    sw_flux_dn_dif_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}),
+                    work.gpt_flux_up,
+                    work.gpt_flux_dn,
+                    work.gpt_flux_dn_dir);
+
+            // 4. Reduce the fluxes to the needed information.
+            work.fluxes.reduce(
+                    work.gpt_flux_up, work.gpt_flux_dn, work.gpt_flux_dn_dir,
+                    optical_props_subset_in, top_at_1);
+        }
+        else
+        {
+            // Solve only the sampled g-points and weigh them before the spectral integration.
+            set_gpt_sample(
+                    work.gpt, work.perm, band_lims_gpt, band_lims_gpt_sampled,
+                    swgptsample == "random", hash_index(gpt_sample_key + col_s_in), gpt_sample_call);
+
+            Optical_props_2str& optical_props_full = dynamic_cast<Optical_props_2str&>(*optical_props_subset_in);
+            Optical_props_2str& optical_props_gpt = dynamic_cast<Optical_props_2str&>(*work.optical_props_gpt);
+
+            copy_sampled_gpts(optical_props_gpt.get_tau(), optical_props_full.get_tau(), work.gpt);
+            copy_sampled_gpts(optical_props_gpt.get_ssa(), optical_props_full.get_ssa(), work.gpt);
+            copy_sampled_gpts(optical_props_gpt.get_g  (), optical_props_full.get_g  (), work.gpt);
+            copy_sampled_gpts(
+                    work.toa_src_gpt, sw_flux_dn_dir_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}), work.gpt);
+            copy_sampled_gpts(
+                    work.flux_dn_dif_inc_gpt, sw_flux_dn_dif_inc.subset({{ {col_s_in, col_e_in}, {1, n_gpt} }}), work.gpt);
+
+            Rte_sw::rte_sw(
+                    work.optical_props_gpt,
+                    top_at_1,
+                    mu0.subset({{ {col_s_in, col_e_in} }}),
+                    work.toa_src_gpt,
+                    sfc_alb_dir.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    sfc_alb_dif.subset({{ {1, n_bnd}, {col_s_in, col_e_in} }}),
+                    work.flux_dn_dif_inc_gpt,
+                    work.gpt_flux_up,
+                    work.gpt_flux_dn,
+                    work.gpt_flux_dn_dir);
+
+            weigh_sampled_gpts(work.gpt_flux_up, gpt_weights);
+            weigh_sampled_gpts(work.gpt_flux_dn, gpt_weights);
+            weigh_sampled_gpts(work.gpt_flux_dn_dir, gpt_weights);
+
+            // 4. Reduce the fluxes to the needed information.
+            work.fluxes.reduce(
+                    work.gpt_flux_up, work.gpt_flux_dn, work.gpt_flux_dn_dir,
+                    work.optical_props_gpt, top_at_1);
+        }
 
-        Rte_sw::rte_sw(
-                optical_props_subset_in,
-                top_at_1,
-                mu0_subset_in,
-                toa_src_subset_in,
-                sfc_alb_dir_subset_in,
-                sfc_alb_dif_subset_in,
-                sw_flux_dn_dif_inc_subset_in,
-                gpt_flux_up,
-                gpt_flux_dn,
-                gpt_flux_dn_dir);
-
-        // 4. Reduce the fluxes to the needed information.
-        fluxes->reduce(
-                gpt_flux_up, gpt_flux_dn, gpt_flux_dn_dir,
-                optical_props_subset_in, top_at_1);
+        Fluxes_broadband& fluxes = work.fluxes;
 
         // Copy the data to the output.
         for (int ilev=1; ilev<=n_lev; ++ilev)
             for (int icol=1; icol<=n_col_in; ++icol)
             {
-                flux_up    ({icol+col_s_in-1, ilev}) = fluxes->get_flux_up    ()({icol, ilev});
-                flux_dn    ({icol+col_s_in-1, ilev}) = fluxes->get_flux_dn    ()({icol, ilev});
-                flux_dn_dir({icol+col_s_in-1, ilev}) = fluxes->get_flux_dn_dir()({icol, ilev});
-                flux_net   ({icol+col_s_in-1, ilev}) = fluxes->get_flux_net   ()({icol, ilev});
+                flux_up    ({icol+col_s_in-1, ilev}) = fluxes.get_flux_up    ()({icol, ilev});
+                flux_dn    ({icol+col_s_in-1, ilev}) = fluxes.get_flux_dn    ()({icol, ilev});
+                flux_dn_dir({icol+col_s_in-1, ilev}) = fluxes.get_flux_dn_dir()({icol, ilev});
+                flux_net   ({icol+col_s_in-1, ilev}) = fluxes.get_flux_net   ()({icol, ilev});
             }
     };
 
-    for (int b=1; b<=n_blocks; ++b)
+    const Optical_props* aerosol_props = sw_aerosol ? aerosol_sw.get() : nullptr;
+
+    // Solve the full blocks concurrently, see exec_longwave().
+    std::exception_ptr block_exception = nullptr;
+
+    #pragma omp parallel num_threads(n_threads) if (n_blocks > 1 && n_threads > 1)
     {
-        const int col_s = (b-1) * n_col_block + 1;
-        const int col_e =  b    * n_col_block;
+        std::unique_ptr<Sw_block_work> work;
 
-        Array<Float,1> mu0_subset = mu0.subset({{ {col_s, col_e} }});
-        Array<Float,2> toa_src_subset = sw_flux_dn_dir_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
-        Array<Float,2> sfc_alb_dir_subset = sfc_alb_dir.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> sfc_alb_dif_subset = sfc_alb_dif.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> sw_flux_dn_dif_inc_subset = sw_flux_dn_dif_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
+        #pragma omp for schedule(static)
+        for (int b=1; b<=n_blocks; ++b)
+        {
+            try
+            {
+                if (!work)
+                    work = std::make_unique<Sw_block_work>(
+                            n_col_block, n_lay, n_lev, *kdist_sw, *cloud_sw, aerosol_props, gpt_spec.get());
 
-        std::unique_ptr<Fluxes_broadband> fluxes_subset =
-                std::make_unique<Fluxes_broadband>(n_col_block, n_lev);
+                const int col_s = (b-1) * n_col_block + 1;
+                const int col_e =  b    * n_col_block;
 
-        call_kernels(
-                col_s, col_e,
-                optical_props_subset,
-                cloud_optical_props_subset,
-                aerosol_optical_props_subset,
-                mu0_subset,
-                toa_src_subset,
-                sfc_alb_dir_subset,
-                sfc_alb_dif_subset,
-                sw_flux_dn_dif_inc_subset,
-                fluxes_subset);
+                call_kernels(col_s, col_e, *work);
+            }
+            catch (...)
+            {
+                #pragma omp critical
+                block_exception = std::current_exception();
+            }
+        }
     }
 
+    if (block_exception)
+        std::rethrow_exception(block_exception);
+
     if (n_col_block_left > 0)
     {
         const int col_s = n_col - n_col_block_left + 1;
         const int col_e = n_col;
 
-        Array<Float,1> mu0_left = mu0.subset({{ {col_s, col_e} }});
-        Array<Float,2> toa_src_left = sw_flux_dn_dir_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
-        Array<Float,2> sfc_alb_dir_left = sfc_alb_dir.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> sfc_alb_dif_left = sfc_alb_dif.subset({{ {1, n_bnd}, {col_s, col_e} }});
-        Array<Float,2> sw_flux_dn_dif_inc_left = sw_flux_dn_dif_inc.subset({{ {col_s, col_e}, {1, n_gpt} }});
-
-        std::unique_ptr<Fluxes_broadband> fluxes_left =
-                std::make_unique<Fluxes_broadband>(n_col_block_left, n_lev);
-
-        call_kernels(
-                col_s, col_e,
-                optical_props_left,
-                cloud_optical_props_left,
-                aerosol_optical_props_left,
-                mu0_left,
-                toa_src_left,
-                sfc_alb_dir_left,
-                sfc_alb_dif_left,
-                sw_flux_dn_dif_inc_left,
-                fluxes_left);
+        Sw_block_work work_left(
+                n_col_block_left, n_lay, n_lev, *kdist_sw, *cloud_sw, aerosol_props, gpt_spec.get());
+
+        call_kernels(col_s, col_e, work_left);
     }
 }
 
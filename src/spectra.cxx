@@ -0,0 +1,354 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2023 Chiel van Heerwaarden
+ * Copyright (c) 2011-2023 Thijs Heus
+ * Copyright (c) 2014-2023 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+#include "master.h"
+#include "input.h"
+#include "grid.h"
+#include "fields.h"
+#include "fft.h"
+#include "stats.h"
+#include "constants.h"
+#include "finite_difference.h"
+#include "spectra.h"
+
+namespace
+{
+    using Finite_difference::O2::interp2;
+
+    // Copy the interior of a field into a compact array without ghost cells, as
+    // required by the FFT. Full level fields can be interpolated to the half levels.
+    template<typename TF>
+    void copy_no_ghost_cells(
+            TF* const restrict out, const TF* const restrict in, const bool interp_to_half,
+            const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
+            const int icells, const int ijcells)
+    {
+        const int imax = iend-istart;
+        const int jmax = jend-jstart;
+
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
+            for (int j=jstart; j<jend; ++j)
+                #pragma ivdep
+                for (int i=istart; i<iend; ++i)
+                {
+                    const int ijk  = i + j*icells + k*ijcells;
+                    const int ijkc = (i-istart) + (j-jstart)*imax + (k-kstart)*imax*jmax;
+                    out[ijkc] = interp_to_half ? interp2(in[ijk-ijcells], in[ijk]) : in[ijk];
+                }
+    }
+
+    // Add the products of the spectral coefficients at the requested levels to the radial bins.
+    template<typename TF>
+    void add_to_bins(
+            double* const restrict spec, const TF* const restrict a, const TF* const restrict b,
+            const int* const restrict bin_index, const TF* const restrict bin_weight,
+            const std::vector<int>& kindex, const int kstart, const int nbins, const int ijblock)
+    {
+        for (int n=0; n<static_cast<int>(kindex.size()); ++n)
+        {
+            const int k = kindex[n] - kstart;
+            double* const restrict spec_n = spec + n*nbins;
+
+            for (int ij=0; ij<ijblock; ++ij)
+            {
+                const int ijk = ij + k*ijblock;
+                if (bin_index[ij] >= 0)
+                    spec_n[bin_index[ij]] += bin_weight[ij]*a[ijk]*b[ijk];
+            }
+        }
+    }
+
+    // Find the index of the level nearest to the given height.
+    template<typename TF>
+    int nearest_level(const std::vector<TF>& z, const TF height, const int kstart, const int kend)
+    {
+        int knear = kstart;
+        for (int k=kstart+1; k<kend; ++k)
+            if (std::abs(z[k]-height) < std::abs(z[knear]-height))
+                knear = k;
+        return knear;
+    }
+}
+
+template<typename TF>
+Spectra<TF>::Spectra(
+        Master& masterin, Grid<TF>& gridin, Fields<TF>& fieldsin, FFT<TF>& fftin,
+        Stats<TF>& statsin, Input& inputin) :
+    master(masterin), grid(gridin), fields(fieldsin), fft(fftin)
+{
+    swspectra = inputin.get_item<bool>("spectra", "swspectra", "", false);
+
+    // The spectra are part of the statistics, so disable them if the statistics are disabled.
+    if (!statsin.get_switch())
+        swspectra = false;
+
+    if (swspectra)
+    {
+        spectralist = inputin.get_list<std::string>("spectra", "spectralist", "", std::vector<std::string>());
+        zspectra = inputin.get_list<TF>("spectra", "zspectra", "");
+
+        // Cospectra are given as pairs of variables separated by a colon, e.g. w:thl.
+        std::vector<std::string> cospectralist_in =
+                inputin.get_list<std::string>("spectra", "cospectralist", "", std::vector<std::string>());
+
+        for (auto& pair : cospectralist_in)
+        {
+            const size_t pos = pair.find(':');
+            if ( (pos == std::string::npos) || (pos == 0) || (pos == pair.size()-1) )
+                throw std::runtime_error("Cospectrum \"" + pair + "\" in [spectra] is not of the form var1:var2");
+            cospectralist.emplace_back(pair.substr(0, pos), pair.substr(pos+1));
+        }
+    }
+    else
+    {
+        inputin.flag_as_used("spectra", "spectralist", "");
+        inputin.flag_as_used("spectra", "cospectralist", "");
+        inputin.flag_as_used("spectra", "zspectra", "");
+    }
+}
+
+template<typename TF>
+Spectra<TF>::~Spectra()
+{
+}
+
+template<typename TF>
+void Spectra<TF>::init()
+{
+    if (!swspectra)
+        return;
+
+    auto& gd = grid.get_grid_data();
+    auto& md = master.get_MPI_data();
+
+    // The bins have the width of the lowest wavenumber in the longest direction of the domain,
+    // and extend up to the corners of the spectral domain, to keep all variance in the spectra.
+    const TF dkx = TF(2.*M_PI) / gd.xsize;
+    const TF dky = TF(2.*M_PI) / gd.ysize;
+    dk = std::max(dkx, dky);
+
+    const TF kmax_corner = std::sqrt(std::pow(dkx*(gd.itot/2), 2) + std::pow(dky*(gd.jtot/2), 2));
+    nbins = static_cast<int>(std::round(kmax_corner/dk)) + 1;
+
+    // After the forward FFT each process holds a block of iblock x jblock coefficients
+    // in the halfcomplex format of FFTW for all heights. Element n and N-n hold the real
+    // and imaginary part of wavenumber n, the mean and Nyquist coefficient have no pair.
+    const int ijblock = gd.iblock*gd.jblock;
+    bin_index.resize(ijblock);
+    bin_weight.resize(ijblock);
+
+    const TF ntot = TF(gd.itot)*TF(gd.jtot);
+
+    for (int j=0; j<gd.jblock; ++j)
+        for (int i=0; i<gd.iblock; ++i)
+        {
+            const int ij = i + j*gd.iblock;
+
+            const int iindex = md.mpicoordy*gd.iblock + i;
+            const int jindex = md.mpicoordx*gd.jblock + j;
+
+            const int mx = std::min(iindex, gd.itot-iindex);
+            const int my = std::min(jindex, gd.jtot-jindex);
+
+            if (mx == 0 && my == 0)
+            {
+                bin_index[ij] = -1;
+                bin_weight[ij] = TF(0.);
+                continue;
+            }
+
+            const TF wx = (mx == 0 || 2*mx == gd.itot) ? TF(1.) : TF(2.);
+            const TF wy = (my == 0 || 2*my == gd.jtot) ? TF(1.) : TF(2.);
+
+            const TF kr = std::sqrt(std::pow(dkx*mx, 2) + std::pow(dky*my, 2));
+
+            // Normalize such that the integral of the spectrum over the radial wavenumber equals the (co)variance.
+            bin_index[ij] = static_cast<int>(std::round(kr/dk));
+            bin_weight[ij] = wx*wy / (ntot*ntot*dk);
+        }
+}
+
+template<typename TF>
+void Spectra<TF>::create(Stats<TF>& stats)
+{
+    if (!swspectra)
+        return;
+
+    auto& gd = grid.get_grid_data();
+
+    auto check_field = [&](const std::string& name)
+    {
+        if ( (fields.ap.find(name) == fields.ap.end()) && (fields.sd.find(name) == fields.sd.end()) )
+            throw std::runtime_error("Spectrum of \"" + name + "\" is not supported");
+    };
+
+    for (auto& name : spectralist)
+        check_field(name);
+
+    for (auto& pair : cospectralist)
+    {
+        check_field(pair.first);
+        check_field(pair.second);
+    }
+
+    // Find the grid levels nearest to the requested heights.
+    kspec.clear();
+    kspech.clear();
+
+    std::vector<TF> z_spec;
+    std::vector<TF> zh_spec;
+
+    for (const TF z : zspectra)
+    {
+        kspec .push_back(nearest_level(gd.z , z, gd.kstart, gd.kend));
+        kspech.push_back(nearest_level(gd.zh, z, gd.kstart, gd.kend));
+
+        z_spec .push_back(gd.z [kspec .back()]);
+        zh_spec.push_back(gd.zh[kspech.back()]);
+    }
+
+    std::vector<TF> kr(nbins);
+    for (int n=0; n<nbins; ++n)
+        kr[n] = n*dk;
+
+    stats.add_dimension("kr", nbins);
+    stats.add_dimension("z_spec", zspectra.size());
+    stats.add_dimension("zh_spec", zspectra.size());
+
+    stats.add_fixed_prof_raw("kr", "Radial wavenumber", "rad m-1", "kr", "", kr);
+    stats.add_fixed_prof_raw("z_spec", "Full level height of the spectra", "m", "z_spec", "", z_spec);
+    stats.add_fixed_prof_raw("zh_spec", "Half level height of the spectra", "m", "zh_spec", "", zh_spec);
+
+    for (auto& name : spectralist)
+    {
+        const Field3d<TF>& fld = (fields.ap.find(name) != fields.ap.end()) ? *fields.ap.at(name) : *fields.sd.at(name);
+        const std::string zloc = (fld.loc[2] == 1) ? "zh_spec" : "z_spec";
+
+        stats.add_array(
+                name + "_spec", "Power spectrum of the " + fld.longname,
+                fields.simplify_unit(fld.unit, "", 2) + " m", {zloc, "kr"}, "spectra");
+    }
+
+    for (auto& pair : cospectralist)
+    {
+        const Field3d<TF>& fld1 = (fields.ap.find(pair.first ) != fields.ap.end()) ? *fields.ap.at(pair.first ) : *fields.sd.at(pair.first );
+        const Field3d<TF>& fld2 = (fields.ap.find(pair.second) != fields.ap.end()) ? *fields.ap.at(pair.second) : *fields.sd.at(pair.second);
+        const std::string zloc = (fld1.loc[2] == 1 || fld2.loc[2] == 1) ? "zh_spec" : "z_spec";
+
+        stats.add_array(
+                pair.first + "_" + pair.second + "_cospec",
+                "Cospectrum of the " + fld1.longname + " and " + fld2.longname,
+                fields.simplify_unit(fld1.unit, fld2.unit) + " m", {zloc, "kr"}, "spectra");
+    }
+}
+
+template<typename TF>
+void Spectra<TF>::exec_stats(Stats<TF>& stats)
+{
+    if (!swspectra)
+        return;
+
+    std::vector<TF> spec;
+
+    for (auto& name : spectralist)
+    {
+        calc_spectrum(spec, name, name);
+        stats.set_array(name + "_spec", spec);
+    }
+
+    for (auto& pair : cospectralist)
+    {
+        calc_spectrum(spec, pair.first, pair.second);
+        stats.set_array(pair.first + "_" + pair.second + "_cospec", spec);
+    }
+}
+
+template<typename TF>
+void Spectra<TF>::calc_spectrum(std::vector<TF>& spec, const std::string& name1, const std::string& name2)
+{
+    auto& gd = grid.get_grid_data();
+
+    const Field3d<TF>& fld1 = (fields.ap.find(name1) != fields.ap.end()) ? *fields.ap.at(name1) : *fields.sd.at(name1);
+    const Field3d<TF>& fld2 = (fields.ap.find(name2) != fields.ap.end()) ? *fields.ap.at(name2) : *fields.sd.at(name2);
+
+    // Spectra that involve a half level variable are computed at the half levels.
+    const bool at_half = (fld1.loc[2] == 1) || (fld2.loc[2] == 1);
+    const std::vector<int>& kindex = at_half ? kspech : kspec;
+
+    auto fft1 = fields.get_tmp();
+    auto work = fields.get_tmp();
+
+    copy_no_ghost_cells(
+            fft1->fld.data(), fld1.fld.data(), at_half && (fld1.loc[2] == 0),
+            gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+            gd.icells, gd.ijcells);
+
+    fft.exec_forward(fft1->fld.data(), work->fld.data());
+
+    std::vector<double> spec_sum(kindex.size()*nbins, 0.);
+
+    if (name1 == name2)
+    {
+        add_to_bins(
+                spec_sum.data(), fft1->fld.data(), fft1->fld.data(),
+                bin_index.data(), bin_weight.data(),
+                kindex, gd.kstart, nbins, gd.iblock*gd.jblock);
+    }
+    else
+    {
+        auto fft2 = fields.get_tmp();
+
+        copy_no_ghost_cells(
+                fft2->fld.data(), fld2.fld.data(), at_half && (fld2.loc[2] == 0),
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                gd.icells, gd.ijcells);
+
+        fft.exec_forward(fft2->fld.data(), work->fld.data());
+
+        add_to_bins(
+                spec_sum.data(), fft1->fld.data(), fft2->fld.data(),
+                bin_index.data(), bin_weight.data(),
+                kindex, gd.kstart, nbins, gd.iblock*gd.jblock);
+
+        fields.release_tmp(fft2);
+    }
+
+    fields.release_tmp(fft1);
+    fields.release_tmp(work);
+
+    master.sum(spec_sum.data(), spec_sum.size());
+
+    spec.assign(spec_sum.begin(), spec_sum.end());
+}
+
+
+#ifdef FLOAT_SINGLE
+template class Spectra<float>;
+#else
+template class Spectra<double>;
+#endif
@@ -43,15 +43,12 @@
 #include "advec.h"
 #include "diff.h"
 #include "netcdf_interface.h"
+#include "stats_functions.h"
 
 namespace
 {
     using namespace Constants;
-
-    // Help function(s) to switch between the different NetCDF data types
-    template<typename TF> TF netcdf_fp_fillvalue();
-    template<> double netcdf_fp_fillvalue<double>() { return NC_FILL_DOUBLE; }
-    template<> float  netcdf_fp_fillvalue<float>()  { return NC_FILL_FLOAT; }
+    using namespace Stats_functions;
 
     template<typename TF, Stats_mask_type mode>
     TF is_false(const TF value, const TF threshold)
@@ -93,6 +90,100 @@ namespace
         }
     }
 
+    // Add one sample of a profile to the time average. Levels that hold a fill value,
+    // because the mask was empty at that level, do not count as a sample.
+    template<typename TF>
+    void accumulate_prof(Prof_var<TF>& p)
+    {
+        const int kcells = p.data.size();
+
+        if (p.nsamples.empty())
+        {
+            p.sum .assign(kcells, 0.);
+            p.sum2.assign(kcells, 0.);
+            p.nsamples.assign(kcells, 0);
+            p.data_tvar.assign(kcells, 0.);
+        }
+
+        for (int k=0; k<kcells; ++k)
+        {
+            if (is_valid_sample(p.data[k]))
+            {
+                p.sum [k] += p.data[k];
+                p.sum2[k] += static_cast<double>(p.data[k])*p.data[k];
+                ++p.nsamples[k];
+            }
+        }
+    }
+
+    // Replace the profile by its time average and variance, and reset the accumulators.
+    // Levels without a single valid sample in the averaging window get the fill value.
+    template<typename TF>
+    void average_prof(Prof_var<TF>& p)
+    {
+        const int kcells = p.data.size();
+
+        for (int k=0; k<kcells; ++k)
+        {
+            if (p.nsamples[k] > 0)
+            {
+                const double mean = p.sum[k] / p.nsamples[k];
+                p.data[k] = mean;
+                p.data_tvar[k] = std::max(p.sum2[k] / p.nsamples[k] - mean*mean, 0.);
+            }
+        }
+
+        set_fillvalue_prof(p.data.data(), p.nsamples.data(), 0, kcells);
+        set_fillvalue_prof(p.data_tvar.data(), p.nsamples.data(), 0, kcells);
+
+        std::fill(p.sum .begin(), p.sum .end(), 0.);
+        std::fill(p.sum2.begin(), p.sum2.end(), 0.);
+        std::fill(p.nsamples.begin(), p.nsamples.end(), 0);
+    }
+
+    template<typename TF>
+    void accumulate_time_series(Time_series_var<TF>& ts)
+    {
+        if (is_valid_sample(ts.data))
+        {
+            ts.sum  += ts.data;
+            ts.sum2 += static_cast<double>(ts.data)*ts.data;
+            ++ts.nsamples;
+        }
+    }
+
+    template<typename TF>
+    void average_time_series(Time_series_var<TF>& ts)
+    {
+        if (ts.nsamples > 0)
+        {
+            const double mean = ts.sum / ts.nsamples;
+            ts.data = mean;
+            ts.data_tvar = std::max(ts.sum2 / ts.nsamples - mean*mean, 0.);
+        }
+        else
+        {
+            ts.data = netcdf_fp_fillvalue<TF>();
+            ts.data_tvar = netcdf_fp_fillvalue<TF>();
+        }
+
+        ts.sum = 0.;
+        ts.sum2 = 0.;
+        ts.nsamples = 0;
+    }
+
+    template<typename TF>
+    void accumulate_array(Array_var<TF>& a)
+    {
+        accumulate_samples(a.sum, a.nsamples, a.data);
+    }
+
+    template<typename TF>
+    void average_array(Array_var<TF>& a)
+    {
+        average_samples(a.data, a.sum, a.nsamples);
+    }
+
     template<typename TF, Stats_mask_type mode>
     void calc_mask_thres(
             unsigned int* const restrict mfield, unsigned int* const restrict mfield_bot,
@@ -221,53 +312,187 @@ namespace
         }
     }
 
+    // Masks are bit-packed per (j,k) row into 64-bit words along i, such that the
+    // number of points can be computed with popcounts and such that sums can skip
+    // runs of 64 points that are entirely outside of the mask.
+    constexpr int bits_per_word = 64;
+
+    inline int mask_words(const int imax)
+    {
+        return (imax + bits_per_word - 1) / bits_per_word;
+    }
+
+    void pack_mask(
+            uint64_t* const restrict bits, const unsigned int* const restrict mfield, const unsigned int flag,
+            const int istart, const int iend, const int jstart, const int jend,
+            const int kcells, const int icells, const int ijcells)
+    {
+        const int jmax = jend-jstart;
+        const int nwords = mask_words(iend-istart);
+
+        #pragma omp parallel for
+        for (int k=0; k<kcells; ++k)
+            for (int j=jstart; j<jend; ++j)
+            {
+                uint64_t* const restrict row = bits + ((j-jstart) + k*jmax)*nwords;
+                for (int w=0; w<nwords; ++w)
+                {
+                    const int i0 = istart + w*bits_per_word;
+                    const int i1 = std::min(i0 + bits_per_word, iend);
+
+                    uint64_t word = 0;
+                    for (int i=i0; i<i1; ++i)
+                    {
+                        const int ijk = i + j*icells + k*ijcells;
+                        word |= static_cast<uint64_t>((mfield[ijk] & flag) != 0) << (i-i0);
+                    }
+                    row[w] = word;
+                }
+            }
+    }
+
     // Calculate the number of points contained in the mask.
-    template<typename TF>
     void calc_nmask(
-            int* restrict nmask_full, int* restrict nmask_half, int& nmask_bottom,
-            const unsigned int* const mfield, const unsigned int* const mfield_bot,
-            const unsigned int flag, const unsigned int flagh,
-            const int istart, const int iend, const int jstart, const int jend,
-            const int kstart, const int kend,
-            const int icells, const int ijcells, const int kcells)
+            int* const restrict nmask, const uint64_t* const restrict bits,
+            const int nwords_level, const int kcells)
     {
         #pragma omp parallel for
-        for (int k=kstart; k<kend; ++k)
+        for (int k=0; k<kcells; ++k)
         {
-            nmask_full[k] = 0;
-            nmask_half[k] = 0;
+            int n = 0;
+            for (int w=0; w<nwords_level; ++w)
+                n += __builtin_popcountll(bits[w + k*nwords_level]);
+            nmask[k] = n;
+        }
+    }
 
-            // #pragma omp parallel for reduction (+:nmask_full[k], nmask_half[k]) collapse(2)
-            for (int j=jstart; j<jend; ++j)
-                for (int i=istart; i<iend; ++i)
+    // Sum f(ijk) over the points of one bit-packed row. Empty words are skipped, full words
+    // are summed without testing the bits, and the remaining words visit only the set bits.
+    template<typename F>
+    inline double sum_mask_row(
+            const uint64_t* const restrict row, const int nwords, const int ijk0, F&& f)
+    {
+        double tmp = 0.;
+        for (int w=0; w<nwords; ++w)
+        {
+            uint64_t word = row[w];
+            if (word == 0)
+                continue;
+
+            const int ijkw = ijk0 + w*bits_per_word;
+            if (word == ~uint64_t(0))
+            {
+                #pragma ivdep
+                for (int b=0; b<bits_per_word; ++b)
+                    tmp += f(ijkw + b);
+            }
+            else
+            {
+                while (word)
                 {
-                    const int ijk = i + j*icells + k*ijcells;
-                    nmask_full[k] += in_mask<int>(mfield[ijk], flag );
-                    nmask_half[k] += in_mask<int>(mfield[ijk], flagh);
+                    tmp += f(ijkw + __builtin_ctzll(word));
+                    word &= word - 1;
                 }
+            }
         }
+        return tmp;
+    }
 
-        nmask_bottom     = 0;
-        // nmask_half[kend] = 0;
-        // #pragma omp parallel for reduction (+:nmask_bottom) collapse(2)
-        // #pragma omp parallel for reduction (+:nmask_bottom, nmask_half[kend]) collapse(2)
-        for (int j=jstart; j<jend; ++j)
-            for (int i=istart; i<iend; ++i)
+    // Call f(ijk) for the points of one bit-packed row, for kernels that scatter
+    // into memory and can therefore not use the vectorized sum of sum_mask_row.
+    template<typename F>
+    inline void for_each_in_mask_row(
+            const uint64_t* const restrict row, const int nwords, const int ijk0, F&& f)
+    {
+        for (int w=0; w<nwords; ++w)
+        {
+            uint64_t word = row[w];
+            const int ijkw = ijk0 + w*bits_per_word;
+            while (word)
             {
-                const int ij  = i + j*icells;
-                const int ijk = i + j*icells + kend*ijcells;
-                nmask_bottom += in_mask<int>(mfield_bot[ij], flag);
-                // nmask_half[kend] += in_mask<int>(mfield[ijk], flagh);
+                f(ijkw + __builtin_ctzll(word));
+                word &= word - 1;
             }
+        }
+    }
+
+    template<typename TF>
+    const uint64_t* mask_bits(const Mask<TF>& m, const int loc)
+    {
+        return (loc == 0) ? m.bits.data() : m.bitsh.data();
+    }
+
+    template<typename TF>
+    inline int hist_bin(const TF value, const std::pair<TF, TF>& range, const int nbins)
+    {
+        const TF frac = (value - range.first) / (range.second - range.first);
+        return (frac >= TF(0.) && frac < TF(1.)) ? static_cast<int>(frac*nbins) : -1;
+    }
+
+    // Count the masked points per bin and level. Values outside the range are not counted.
+    // A half level field can be interpolated to the full levels, to pair it with a full level field.
+    template<typename TF>
+    void calc_hist(
+            double* const restrict counts,
+            const TF* const restrict fld1, const bool half1, const std::pair<TF, TF>& range1,
+            const TF* const restrict fld2, const bool half2, const std::pair<TF, TF>& range2,
+            const uint64_t* const restrict bits, const int* const nmask, const int nbins,
+            const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
+            const int icells, const int ijcells)
+    {
+        using Finite_difference::O2::interp2;
+
+        const int jmax = jend-jstart;
+        const int nwords = mask_words(iend-istart);
+        const int nbins_level = (fld2 == nullptr) ? nbins : nbins*nbins;
+
+        auto value = [&](const TF* const restrict fld, const bool interp, const int ijk)
+        {
+            return interp ? interp2(fld[ijk], fld[ijk+ijcells]) : fld[ijk];
+        };
+
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
+        {
+            if (!nmask[k])
+                continue;
+
+            double* const restrict counts_k = counts + (k-kstart)*nbins_level;
+
+            for (int j=jstart; j<jend; ++j)
+            {
+                const uint64_t* const row = bits + ((j-jstart) + k*jmax)*nwords;
+                for_each_in_mask_row(
+                        row, nwords, istart + j*icells + k*ijcells,
+                        [&](const int ijk)
+                        {
+                            const int b1 = hist_bin(value(fld1, half1, ijk), range1, nbins);
+                            if (b1 < 0)
+                                return;
+
+                            if (fld2 == nullptr)
+                                counts_k[b1] += 1.;
+                            else
+                            {
+                                const int b2 = hist_bin(value(fld2, half2, ijk), range2, nbins);
+                                if (b2 >= 0)
+                                    counts_k[b2 + b1*nbins] += 1.;
+                            }
+                        });
+            }
+        }
     }
 
     template<typename TF>
     void calc_mean(
             TF* const restrict prof, const TF* const restrict fld,
-            const unsigned int* const mask, const unsigned int flag, const int* const nmask,
+            const uint64_t* const restrict bits, const int* const nmask,
             const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
             const int icells, const int ijcells)
     {
+        const int jmax = jend-jstart;
+        const int nwords = mask_words(iend-istart);
+
         #pragma omp parallel for
         for (int k=kstart; k<kend; ++k)
         {
@@ -275,12 +500,12 @@ namespace
             {
                 double tmp = 0.;
                 for (int j=jstart; j<jend; ++j)
-                    #pragma ivdep
-                    for (int i=istart; i<iend; ++i)
-                    {
-                        const int ijk  = i + j*icells + k*ijcells;
-                        tmp += in_mask<double>(mask[ijk], flag) * fld[ijk];
-                    }
+                {
+                    const uint64_t* const row = bits + ((j-jstart) + k*jmax)*nwords;
+                    tmp += sum_mask_row(
+                            row, nwords, istart + j*icells + k*ijcells,
+                            [&](const int ijk) { return fld[ijk]; });
+                }
 
                 prof[k] = tmp / nmask[k];
             }
@@ -342,10 +567,13 @@ namespace
     template<typename TF>
     void calc_moment(
             TF* const restrict prof, const TF* const restrict fld, const TF* const restrict fld_mean, const TF offset,
-            const unsigned int* const mask, const unsigned int flag, const int* const nmask, const int power,
+            const uint64_t* const restrict bits, const int* const nmask, const int power,
             const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
             const int icells, const int ijcells)
     {
+        const int jmax = jend-jstart;
+        const int nwords = mask_words(iend-istart);
+
         #pragma omp parallel for
         for (int k=kstart; k<kend+1; ++k)
         {
@@ -353,12 +581,12 @@ namespace
             {
                 double tmp = 0.;
                 for (int j=jstart; j<jend; ++j)
-                    #pragma ivdep
-                    for (int i=istart; i<iend; ++i)
-                    {
-                        const int ijk  = i + j*icells + k*ijcells;
-                        tmp += in_mask<double>(mask[ijk], flag)*std::pow(fld[ijk] - fld_mean[k] + offset, power);
-                    }
+                {
+                    const uint64_t* const row = bits + ((j-jstart) + k*jmax)*nwords;
+                    tmp += sum_mask_row(
+                            row, nwords, istart + j*icells + k*ijcells,
+                            [&](const int ijk) { return std::pow(fld[ijk] - fld_mean[k] + offset, power); });
+                }
 
                 prof[k] = tmp / nmask[k];
             }
@@ -411,10 +639,13 @@ namespace
     template<typename TF>
     void calc_frac(
             TF* const restrict prof, const TF* const restrict fld, const TF offset, const TF threshold,
-            const unsigned int* const mask, const unsigned int flag, const int* const nmask,
+            const uint64_t* const restrict bits, const int* const nmask,
             const int istart, const int iend, const int jstart, const int jend, const int kstart, const int kend,
             const int icells, const int ijcells)
     {
+        const int jmax = jend-jstart;
+        const int nwords = mask_words(iend-istart);
+
         #pragma omp parallel for
         for (int k=kstart; k<kend+1; ++k)
         {
@@ -422,12 +653,12 @@ namespace
             {
                 double tmp = 0.;
                 for (int j=jstart; j<jend; ++j)
-                    #pragma ivdep
-                    for (int i=istart; i<iend; ++i)
-                    {
-                        const int ijk  = i + j*icells + k*ijcells;
-                        tmp += in_mask<double>(mask[ijk], flag)*((fld[ijk] + offset) > threshold);
-                    }
+                {
+                    const uint64_t* const row = bits + ((j-jstart) + k*jmax)*nwords;
+                    tmp += sum_mask_row(
+                            row, nwords, istart + j*icells + k*ijcells,
+                            [&](const int ijk) { return static_cast<double>((fld[ijk] + offset) > threshold); });
+                }
                 prof[k] = tmp / nmask[k];
             }
         }
@@ -556,6 +787,52 @@ Stats<TF>::Stats(
         masklist.insert(masklist.end(), xymasklist.begin(), xymasklist.end());
 
         swtendency = inputin.get_item<bool>("stats", "swtendency", "", false);
+
+        // Optionally average the samples in memory and write only the averages.
+        swtimeavg = inputin.get_item<bool>("stats", "swtimeavg", "", false);
+        if (swtimeavg)
+        {
+            avgtime = inputin.get_item<double>("stats", "avgtime", "");
+            swtimevar = inputin.get_item<bool>("stats", "swtimevar", "", false);
+        }
+        else
+            swtimevar = false;
+
+        // Histograms of single variables, and joint histograms of pairs given as var1:var2.
+        std::vector<std::string> histlist = inputin.get_list<std::string>("stats", "histlist", "", std::vector<std::string>());
+        std::vector<std::string> jointhistlist = inputin.get_list<std::string>("stats", "jointhistlist", "", std::vector<std::string>());
+
+        for (auto& name : histlist)
+            histograms.push_back({name + "_hist", name, ""});
+
+        for (auto& pair : jointhistlist)
+        {
+            const size_t pos = pair.find(':');
+            if ( (pos == std::string::npos) || (pos == 0) || (pos == pair.size()-1) )
+                throw std::runtime_error("Joint histogram \"" + pair + "\" in [stats] is not of the form var1:var2");
+
+            const std::string name1 = pair.substr(0, pos);
+            const std::string name2 = pair.substr(pos+1);
+            histograms.push_back({name1 + "_" + name2 + "_jhist", name1, name2});
+        }
+
+        if (!histograms.empty())
+        {
+            histbins = inputin.get_item<int>("stats", "histbins", "", 50);
+            swhistmask = inputin.get_item<bool>("stats", "swhistmask", "", false);
+
+            for (auto& h : histograms)
+                for (auto& name : {h.var1, h.var2})
+                    if (!name.empty() && hist_range.find(name) == hist_range.end())
+                    {
+                        const TF histmin = inputin.get_item<TF>("stats", "histmin", name);
+                        const TF histmax = inputin.get_item<TF>("stats", "histmax", name);
+                        if (histmax <= histmin)
+                            throw std::runtime_error("histmax has to be larger than histmin for " + name);
+                        hist_range[name] = std::make_pair(histmin, histmax);
+                    }
+        }
+
         std::vector<std::string> whitelistin = inputin.get_list<std::string>("stats", "whitelist", "", std::vector<std::string>());
 
         // Anything without an underscore is mean value, so should be on the whitelist
@@ -596,6 +873,13 @@ void Stats<TF>::init()
     isampletime = convert_to_itime(sampletime);
     statistics_counter = 0;
 
+    if (swtimeavg)
+    {
+        iavgtime = convert_to_itime(avgtime);
+        if (iavgtime == 0 || iavgtime % isampletime != 0)
+            throw std::runtime_error("avgtime in [stats] has to be a multiple of sampletime");
+    }
+
     // Vectors which hold the amount of grid points sampled on each model level.
     mfield.resize(gd.ncells);
     mfield_bot.resize(gd.ijcells);
@@ -688,11 +972,66 @@ void Stats<TF>::create(const Timeloop<TF>& timeloop, std::string sim_name)
 
         m.nmask. resize(gd.kcells);
         m.nmaskh.resize(gd.kcells);
+
+        m.bits .resize(mask_words(gd.imax)*gd.jmax*gd.kcells);
+        m.bitsh.resize(mask_words(gd.imax)*gd.jmax*gd.kcells);
     }
 
     // For each mask, add the area as a variable.
     add_prof("area" , "Fractional area contained in mask", "-", "z" , "default");
     add_prof("areah", "Fractional area contained in mask", "-", "zh", "default");
+
+    create_histograms();
+}
+
+template<typename TF>
+void Stats<TF>::create_histograms()
+{
+    if (histograms.empty())
+        return;
+
+    auto get_field = [&](const std::string& name) -> Field3d<TF>&
+    {
+        if (fields.ap.find(name) != fields.ap.end())
+            return *fields.ap.at(name);
+        else if (fields.sd.find(name) != fields.sd.end())
+            return *fields.sd.at(name);
+        else
+            throw std::runtime_error("Histogram of \"" + name + "\" is not supported");
+    };
+
+    // Each variable gets a bin dimension, with the bin centers as coordinate.
+    for (auto& range : hist_range)
+    {
+        const std::string dim_name = range.first + "_bin";
+        const TF dbin = (range.second.second - range.second.first) / histbins;
+
+        std::vector<TF> bins(histbins);
+        for (int n=0; n<histbins; ++n)
+            bins[n] = range.second.first + (n+TF(0.5))*dbin;
+
+        add_dimension(dim_name, histbins);
+        add_fixed_prof_raw(dim_name, "Bin center of " + get_field(range.first).longname, get_field(range.first).unit, dim_name, "", bins);
+    }
+
+    for (auto& h : histograms)
+    {
+        const Field3d<TF>& fld1 = get_field(h.var1);
+
+        if (h.var2.empty())
+        {
+            const std::string zloc = (fld1.loc[2] == 1) ? "zh" : "z";
+            add_array(h.name, "Histogram of the " + fld1.longname, "-", {zloc, h.var1 + "_bin"}, "histograms");
+        }
+        else
+        {
+            // Joint histograms are computed at the full levels.
+            const Field3d<TF>& fld2 = get_field(h.var2);
+            add_array(
+                    h.name, "Joint histogram of the " + fld1.longname + " and " + fld2.longname, "-",
+                    {"z", h.var1 + "_bin", h.var2 + "_bin"}, "histograms");
+        }
+    }
 }
 
 template<typename TF>
@@ -736,9 +1075,6 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
     auto& agd = grid.get_grid_data();
     auto& sgd = soil_grid.get_grid_data();
 
-    // Write message in case stats is triggered.
-    master.print_message("Saving statistics for time %f\n", time);
-
     // Finalize the total tendencies
     if (do_tendency())
     {
@@ -770,6 +1106,52 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
         }
     }
 
+    // In case of time averaging, add the sample to the averages and only
+    // continue to the output at the end of the averaging window.
+    if (swtimeavg)
+    {
+        for (auto& mask : masks)
+        {
+            Mask<TF>& m = mask.second;
+
+            for (auto& p : m.profs)
+                accumulate_prof(p.second);
+            for (auto& p : m.soil_profs)
+                accumulate_prof(p.second);
+            for (auto& p : m.background_profs)
+                accumulate_prof(p.second);
+            for (auto& ts : m.tseries)
+                accumulate_time_series(ts.second);
+            for (auto& a : m.arrays)
+                accumulate_array(a.second);
+        }
+
+        if (itime % iavgtime != 0)
+        {
+            wmean_set = false;
+            return;
+        }
+
+        for (auto& mask : masks)
+        {
+            Mask<TF>& m = mask.second;
+
+            for (auto& p : m.profs)
+                average_prof(p.second);
+            for (auto& p : m.soil_profs)
+                average_prof(p.second);
+            for (auto& p : m.background_profs)
+                average_prof(p.second);
+            for (auto& ts : m.tseries)
+                average_time_series(ts.second);
+            for (auto& a : m.arrays)
+                average_array(a.second);
+        }
+    }
+
+    // Write message in case stats is triggered.
+    master.print_message("Saving statistics for time %f\n", time);
+
     for (auto& mask : masks)
     {
         Mask<TF>& m = mask.second;
@@ -793,6 +1175,15 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
                     p.second.data.begin() + agd.kstart + ksize);
 
             m.profs.at(p.first).ncvar.insert(prof_nogc, time_height_index, time_height_size);
+
+            if (p.second.ncvar_tvar)
+            {
+                std::vector<TF> tvar_nogc(
+                        p.second.data_tvar.begin() + agd.kstart,
+                        p.second.data_tvar.begin() + agd.kstart + ksize);
+
+                p.second.ncvar_tvar->insert(tvar_nogc, time_height_index, time_height_size);
+            }
         }
 
         for (auto& p : m.soil_profs)
@@ -805,6 +1196,15 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
                     p.second.data.begin() + sgd.kstart + ksize);
 
             m.soil_profs.at(p.first).ncvar.insert(prof_nogc, time_height_index, time_height_size);
+
+            if (p.second.ncvar_tvar)
+            {
+                std::vector<TF> tvar_nogc(
+                        p.second.data_tvar.begin() + sgd.kstart,
+                        p.second.data_tvar.begin() + sgd.kstart + ksize);
+
+                p.second.ncvar_tvar->insert(tvar_nogc, time_height_index, time_height_size);
+            }
         }
 
         for (auto& p : m.background_profs)
@@ -813,11 +1213,30 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
             std::vector<int> time_height_size  = {1, ksize};
 
             m.background_profs.at(p.first).ncvar.insert(p.second.data, time_height_index, time_height_size);
+
+            if (p.second.ncvar_tvar)
+                p.second.ncvar_tvar->insert(p.second.data_tvar, time_height_index, time_height_size);
         }
 
         for (auto& ts : m.tseries)
+        {
             m.tseries.at(ts.first).ncvar.insert(m.tseries.at(ts.first).data, time_index);
 
+            if (ts.second.ncvar_tvar)
+                ts.second.ncvar_tvar->insert(ts.second.data_tvar, time_index);
+        }
+
+        for (auto& a : m.arrays)
+        {
+            std::vector<int> array_index(a.second.dim_sizes.size()+1, 0);
+            array_index[0] = statistics_counter;
+
+            std::vector<int> array_size{1};
+            array_size.insert(array_size.end(), a.second.dim_sizes.begin(), a.second.dim_sizes.end());
+
+            a.second.ncvar.insert(a.second.data, array_index, array_size);
+        }
+
         // Synchronize the NetCDF file.
         m.data_file->sync();
     }
@@ -828,6 +1247,43 @@ void Stats<TF>::exec(const int iteration, const double time, const unsigned long
     ++statistics_counter;
 }
 
+// Check whether any of the statistics that calc_stats() derives from a variable is
+// registered, to allow producers to skip the computation of fields of which all
+// statistics are filtered out by the whitelist and blacklist.
+template<typename TF>
+bool Stats<TF>::is_needed(const std::string& name)
+{
+    if (!swstats)
+        return false;
+
+    const std::vector<std::string> operations = {"w", "grad", "flux", "diff", "frac", "path", "cover"};
+
+    for (auto& var : varlist)
+    {
+        if (var == name)
+            return true;
+
+        if ( (var.size() > name.size()+1) && (var.compare(0, name.size(), name) == 0) && (var[name.size()] == '_') )
+        {
+            const std::string op = var.substr(name.size()+1);
+            if (has_only_digits(op) || (std::find(operations.begin(), operations.end(), op) != operations.end()))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename TF>
+bool Stats<TF>::is_any_needed(const std::vector<std::string>& names)
+{
+    for (auto& name : names)
+        if (is_needed(name))
+            return true;
+
+    return false;
+}
+
 // Retrieve the user input list of requested masks.
 template<typename TF>
 const std::vector<std::string>& Stats<TF>::get_mask_list()
@@ -1123,6 +1579,18 @@ void Stats<TF>::add_prof(
             m.background_profs.at(name).ncvar.add_attribute("long_name", longname);
         }
 
+        // Add the temporal variance over the averaging window next to the average.
+        if (swtimevar)
+        {
+            Prof_var<TF>& p = ((zloc == "z") || (zloc == "zh")) ? m.profs.at(name) :
+                              (zloc == "zs") ? m.soil_profs.at(name) : m.background_profs.at(name);
+
+            p.ncvar_tvar = std::make_unique<Netcdf_variable<TF>>(
+                    handle.add_variable<TF>(name + "_tvar", {"time", zloc}));
+            p.ncvar_tvar->add_attribute("units", fields.simplify_unit(unit, "", 2));
+            p.ncvar_tvar->add_attribute("long_name", "Temporal variance of the " + longname);
+        }
+
         m.data_file->sync();
     }
 
@@ -1243,6 +1711,14 @@ void Stats<TF>::add_time_series(
 
         m.tseries.at(name).ncvar.add_attribute("units", unit);
         m.tseries.at(name).ncvar.add_attribute("long_name", longname);
+
+        if (swtimevar)
+        {
+            m.tseries.at(name).ncvar_tvar = std::make_unique<Netcdf_variable<TF>>(
+                    handle.add_variable<TF>(name + "_tvar", {"time"}));
+            m.tseries.at(name).ncvar_tvar->add_attribute("units", fields.simplify_unit(unit, "", 2));
+            m.tseries.at(name).ncvar_tvar->add_attribute("long_name", "Temporal variance of the " + longname);
+        }
         // m.tseries.at(name).ncvar.add_attribute("_FillValue", netcdf_fp_fillvalue<TF>());
     }
 
@@ -1250,6 +1726,53 @@ void Stats<TF>::add_time_series(
 
 }
 
+// Add a statistic with time as the first and the given dimensions as the
+// remaining ones. The dimensions have to be added first with add_dimension().
+template<typename TF>
+void Stats<TF>::add_array(
+        const std::string& name, const std::string& longname,
+        const std::string& unit, const std::vector<std::string>& dims,
+        const std::string& group_name, Stats_whitelist_type wltype)
+{
+    if (is_blacklisted(name, wltype))
+        return;
+
+    if ( (std::find(varlist.begin(), varlist.end(), name) != varlist.end()) ||
+         (std::find(varlist_array.begin(), varlist_array.end(), name) != varlist_array.end()) )
+        throw std::runtime_error("Variable " + name + " is added twice in add_array()");
+
+    std::vector<std::string> dims_time{"time"};
+    dims_time.insert(dims_time.end(), dims.begin(), dims.end());
+
+    for (auto& mask : masks)
+    {
+        Mask<TF>& m = mask.second;
+
+        Netcdf_handle& handle = (group_name == "") ? dynamic_cast<Netcdf_handle&>(*m.data_file) : dynamic_cast<Netcdf_handle&>
+            (m.data_file->group_exists(group_name) ? m.data_file->get_group(group_name) : m.data_file->add_group(group_name));
+
+        Array_var<TF> tmp{handle.add_variable<TF>(name, dims_time)};
+
+        const std::vector<int> dim_sizes = tmp.ncvar.get_dim_sizes();
+        tmp.dim_sizes.assign(dim_sizes.begin()+1, dim_sizes.end());
+
+        int size = 1;
+        for (const int n : tmp.dim_sizes)
+            size *= n;
+        tmp.data.resize(size);
+
+        m.arrays.emplace(
+                std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(std::move(tmp)));
+
+        m.arrays.at(name).ncvar.add_attribute("units", unit);
+        m.arrays.at(name).ncvar.add_attribute("long_name", longname);
+
+        m.data_file->sync();
+    }
+
+    varlist_array.push_back(name);
+}
+
 template<typename TF>
 void Stats<TF>::initialize_masks()
 {
@@ -1278,11 +1801,16 @@ void Stats<TF>::finalize_masks()
     {
         // CvH: compute the nmask over the entire depth. Masks need to provide the proper count for
         // the ghost cells in order to be able to calculate mean profile in ghost cells (needed for budgets).
-        calc_nmask<TF>(
-                it.second.nmask.data(), it.second.nmaskh.data(), it.second.nmask_bot,
-                mfield.data(), mfield_bot.data(), it.second.flag, it.second.flagh,
-                gd.istart, gd.iend, gd.jstart, gd.jend, 0, gd.kcells,
-                gd.icells, gd.ijcells, gd.kcells);
+        pack_mask(
+                it.second.bits.data(), mfield.data(), it.second.flag,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kcells, gd.icells, gd.ijcells);
+        pack_mask(
+                it.second.bitsh.data(), mfield.data(), it.second.flagh,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kcells, gd.icells, gd.ijcells);
+
+        const int nwords_level = mask_words(gd.imax)*gd.jmax;
+        calc_nmask(it.second.nmask.data() , it.second.bits.data() , nwords_level, gd.kcells);
+        calc_nmask(it.second.nmaskh.data(), it.second.bitsh.data(), nwords_level, gd.kcells);
 
         master.sum(it.second.nmask.data() , gd.kcells);
         master.sum(it.second.nmaskh.data(), gd.kcells);
@@ -1377,6 +1905,119 @@ void Stats<TF>::set_time_series(const std::string& varname, const TF val)
     }
 }
 
+template<typename TF>
+void Stats<TF>::set_array(const std::string& varname, const std::vector<TF>& data)
+{
+    auto it = std::find(varlist_array.begin(), varlist_array.end(), varname);
+    if (it != varlist_array.end())
+    {
+        for (auto& it : masks)
+            it.second.arrays.at(varname).data = data;
+    }
+}
+
+// Compute the histograms as the fraction of the masked points per bin and height. The counts
+// of all histograms and masks are gathered into a single buffer to reduce them at once.
+template<typename TF>
+void Stats<TF>::calc_histograms()
+{
+    if (histograms.empty())
+        return;
+
+    auto& gd = grid.get_grid_data();
+
+    std::vector<std::string> hist_masks;
+    for (auto& m : masks)
+        if (swhistmask || m.first == "default")
+            hist_masks.push_back(m.first);
+
+    std::vector<const Histogram*> active;
+    for (auto& h : histograms)
+        if (std::find(varlist_array.begin(), varlist_array.end(), h.name) != varlist_array.end())
+            active.push_back(&h);
+
+    if (active.empty())
+        return;
+
+    std::vector<size_t> offsets;
+    size_t size = 0;
+    for (size_t nm=0; nm<hist_masks.size(); ++nm)
+        for (auto h : active)
+        {
+            offsets.push_back(size);
+            size += masks.at(hist_masks[nm]).arrays.at(h->name).data.size();
+        }
+
+    std::vector<double> counts(size, 0.);
+
+    auto get_field = [&](const std::string& name) -> const Field3d<TF>&
+    {
+        return (fields.ap.find(name) != fields.ap.end()) ? *fields.ap.at(name) : *fields.sd.at(name);
+    };
+
+    int n = 0;
+    for (auto& mask_name : hist_masks)
+    {
+        const Mask<TF>& m = masks.at(mask_name);
+
+        for (auto h : active)
+        {
+            const Field3d<TF>& fld1 = get_field(h->var1);
+
+            if (h->var2.empty())
+                calc_hist(
+                        counts.data() + offsets[n],
+                        fld1.fld.data(), false, hist_range.at(h->var1),
+                        static_cast<const TF*>(nullptr), false, hist_range.at(h->var1),
+                        mask_bits(m, fld1.loc[2]), (fld1.loc[2] == 1) ? m.nmaskh.data() : m.nmask.data(), histbins,
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend+fld1.loc[2],
+                        gd.icells, gd.ijcells);
+            else
+            {
+                const Field3d<TF>& fld2 = get_field(h->var2);
+                calc_hist(
+                        counts.data() + offsets[n],
+                        fld1.fld.data(), fld1.loc[2] == 1, hist_range.at(h->var1),
+                        fld2.fld.data(), fld2.loc[2] == 1, hist_range.at(h->var2),
+                        m.bits.data(), m.nmask.data(), histbins,
+                        gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend,
+                        gd.icells, gd.ijcells);
+            }
+            ++n;
+        }
+    }
+
+    master.sum(counts.data(), size);
+
+    // Normalize with the number of masked points per level, and copy the domain
+    // histograms to all masks in case the histograms are not computed per mask.
+    n = 0;
+    for (auto& mask_name : hist_masks)
+    {
+        for (auto h : active)
+        {
+            const Mask<TF>& m = masks.at(mask_name);
+            const bool half = (h->var2.empty() && get_field(h->var1).loc[2] == 1);
+            const int* const nmask = half ? m.nmaskh.data() : m.nmask.data();
+
+            std::vector<TF> data(masks.at(mask_name).arrays.at(h->name).data.size());
+            const int nbins_level = h->var2.empty() ? histbins : histbins*histbins;
+
+            for (size_t i=0; i<data.size(); ++i)
+            {
+                const int k = gd.kstart + i/nbins_level;
+                data[i] = (nmask[k] > 0) ? counts[offsets[n]+i] / nmask[k] : netcdf_fp_fillvalue<TF>();
+            }
+
+            if (swhistmask)
+                masks.at(mask_name).arrays.at(h->name).data = data;
+            else
+                set_array(h->name, data);
+            ++n;
+        }
+    }
+}
+
 template<typename TF>
 void Stats<TF>::calc_mask_mean_profile(
         std::vector<TF>& prof,
@@ -1393,7 +2034,7 @@ void Stats<TF>::calc_mask_mean_profile(
     // CvH. Do the mean over the entire depth. The calc_mean function always add 1 to the specified
     // kend, so I send kcells-1 as the limit. This is not elegant, yet it works.
     calc_mean(
-            prof.data(), fld.fld.data(), mfield.data(), flag, nmask,
+            prof.data(), fld.fld.data(), mask_bits(m.second, fld.loc[2]), nmask,
             gd.istart, gd.iend, gd.jstart, gd.jend, 1, gd.kcells, gd.icells, gd.ijcells);
 
     master.sum(prof.data(), gd.kcells);
@@ -1418,7 +2059,7 @@ void Stats<TF>::calc_mask_stats(
         calc_mean(
                 m.second.profs.at(varname).data.data(),
                 fld.fld.data(),
-                mfield.data(), flag, nmask,
+                mask_bits(m.second, fld.loc[2]), nmask,
                 gd.istart, gd.iend,
                 gd.jstart, gd.jend,
                 gd.kstart, gd.kend + fld.loc[2],
@@ -1470,7 +2111,7 @@ void Stats<TF>::calc_stats_mean(
             calc_mean(
                     m.second.profs.at(varname).data.data(),
                     fld.fld.data(),
-                    mfield.data(), flag, nmask,
+                    mask_bits(m.second, fld.loc[2]), nmask,
                     gd.istart, gd.iend,
                     gd.jstart, gd.jend,
                     gd.kstart, gd.kend + fld.loc[2],
@@ -1511,7 +2152,7 @@ void Stats<TF>::calc_stats_moments(
                         m.second.profs.at(name).data.data(),
                         fld.fld.data(),
                         m.second.profs.at(varname).data.data(),
-                        offset, mfield.data(), flag, nmask, power,
+                        offset, mask_bits(m.second, fld.loc[2]), nmask, power,
                         gd.istart, gd.iend,
                         gd.jstart, gd.jend,
                         gd.kstart, gd.kend,
@@ -1548,7 +2189,7 @@ void Stats<TF>::calc_stats_w(
             calc_mean(
                     m.second.profs.at(name).data.data(),
                     advec_flux->fld.data(),
-                    mfield.data(), flag, nmask,
+                    mask_bits(m.second, fld.loc[2]), nmask,
                     gd.istart, gd.iend,
                     gd.jstart, gd.jend,
                     0, gd.kcells,
@@ -1587,7 +2228,7 @@ void Stats<TF>::calc_stats_diff(
             calc_mean(
                     m.second.profs.at(name).data.data(),
                     diff_flux->fld.data(),
-                    mfield.data(), flag, nmask,
+                    mask_bits(m.second, !fld.loc[2]), nmask,
                     gd.istart, gd.iend,
                     gd.jstart, gd.jend,
                     gd.kstart, gd.kend+(1-fld.loc[2]),
@@ -1775,7 +2416,7 @@ void Stats<TF>::calc_stats_frac(
                     m.second.profs.at(name).data.data(),
                     fld.fld.data(),
                     offset, threshold,
-                    mfield.data(), flag, nmask,
+                    mask_bits(m.second, fld.loc[2]), nmask,
                     gd.istart, gd.iend,
                     gd.jstart, gd.jend,
                     gd.kstart, gd.kend,
@@ -1807,7 +2448,7 @@ void Stats<TF>::calc_tend(Field3d<TF>& fld, const std::string& tend_name)
         for (auto& m : masks)
         {
             set_flag(flag, nmask, m.second, fld.loc[2]);
-            calc_mean(m.second.profs.at(name).data.data(), fld.fld.data(), mfield.data(), flag, nmask,
+            calc_mean(m.second.profs.at(name).data.data(), fld.fld.data(), mask_bits(m.second, fld.loc[2]), nmask,
                     gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend+fld.loc[2], gd.icells, gd.ijcells);
             master.sum(m.second.profs.at(name).data.data(), gd.kcells);
 
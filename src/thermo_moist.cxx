@@ -99,14 +99,12 @@ namespace
                 }
 
             for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
-                {
-                    const int ij  = i + j*jj;
-                    Struct_sat_adjust<TF> ssa = sat_adjust(thlh[ij], qth[ij], ph[k], exnh);
-                    ql[ij] = ssa.ql;
-                    qi[ij] = ssa.qi;
-                }
+            {
+                const int ij = istart + j*jj;
+                sat_adjust_row<TF, TF>(
+                        &ql[ij], &qi[ij], nullptr, nullptr,
+                        &thlh[ij], &qth[ij], ph[k], exnh, iend-istart);
+            }
 
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -135,14 +133,12 @@ namespace
             if (k >= kstart && k < kend)
             {
                 for (int j=jstart; j<jend; j++)
-                    #pragma ivdep
-                    for (int i=istart; i<iend; i++)
-                    {
-                        const int ijk = i + j*jj + k*kk;
-                        Struct_sat_adjust<TF> ssa = sat_adjust(thl[ijk], qt[ijk], p[k], ex);
-                        ql[ijk] = ssa.ql;
-                        qi[ijk] = ssa.qi;
-                    }
+                {
+                    const int ijk = istart + j*jj + k*kk;
+                    sat_adjust_row<TF, TF>(
+                            &ql[ijk], &qi[ijk], nullptr, nullptr,
+                            &thl[ijk], &qt[ijk], p[k], ex, iend-istart);
+                }
             }
             else
             {
@@ -195,14 +191,12 @@ namespace
                     }
 
                 for (int j=jstart; j<jend; j++)
-                    #pragma ivdep
-                    for (int i=istart; i<iend; i++)
-                    {
-                        const int ij  = i + j*jj;
-                        Struct_sat_adjust<TF> ssa = sat_adjust(thlh[ij], qth[ij], ph[k], exnh);
-                        ql[ij] = ssa.ql;
-                        qi[ij] = ssa.qi;
-                    }
+                {
+                    const int ij = istart + j*jj;
+                    sat_adjust_row<TF, TF>(
+                            &ql[ij], &qi[ij], nullptr, nullptr,
+                            &thlh[ij], &qth[ij], ph[k], exnh, iend-istart);
+                }
             }
             else
             {
@@ -240,12 +234,12 @@ namespace
         {
             const TF ex = exner(p[k]);
             for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
-                {
-                    const int ijk = i + j*jj + k*kk;
-                    ql[ijk] = sat_adjust(thl[ijk], qt[ijk], p[k], ex).ql;
-                }
+            {
+                const int ijk = istart + j*jj + k*kk;
+                sat_adjust_row<TF, TF>(
+                        &ql[ijk], nullptr, nullptr, nullptr,
+                        &thl[ijk], &qt[ijk], p[k], ex, iend-istart);
+            }
         }
     }
 
@@ -263,12 +257,12 @@ namespace
         {
             const TF ex = exner(p[k]);
             for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
-                {
-                    const int ijk = i + j*jj + k*kk;
-                    qsat[ijk] = sat_adjust(thl[ijk], qt[ijk], p[k], ex).qs;
-                }
+            {
+                const int ijk = istart + j*jj + k*kk;
+                sat_adjust_row<TF, TF>(
+                        nullptr, nullptr, nullptr, &qsat[ijk],
+                        &thl[ijk], &qt[ijk], p[k], ex, iend-istart);
+            }
         }
     }
 
@@ -424,12 +418,12 @@ namespace
         {
             const TF ex = exner(p[k]);
             for (int j=jstart; j<jend; j++)
-                #pragma ivdep
-                for (int i=istart; i<iend; i++)
-                {
-                    const int ijk = i + j*jj + k*kk;
-                    qi[ijk] = sat_adjust(thl[ijk], qt[ijk], p[k], ex).qi;
-                }
+            {
+                const int ijk = istart + j*jj + k*kk;
+                sat_adjust_row<TF, TF>(
+                        nullptr, &qi[ijk], nullptr, nullptr,
+                        &thl[ijk], &qt[ijk], p[k], ex, iend-istart);
+            }
         }
     }
 
@@ -486,12 +480,12 @@ namespace
         for (int k=kstart; k<kend; ++k)
         {
             for (int j=jstart; j<jend; ++j)
-                #pragma ivdep
-                for (int i=istart; i<iend; ++i)
-                {
-                    const int ijk = i + j*jj+ k*kk;
-                    T[ijk] = sat_adjust(thl[ijk], qt[ijk], pref[k], exnref[k]).t;
-                }
+            {
+                const int ijk = istart + j*jj + k*kk;
+                sat_adjust_row<TF, TF>(
+                        nullptr, nullptr, &T[ijk], nullptr,
+                        &thl[ijk], &qt[ijk], pref[k], exnref[k], iend-istart);
+            }
         }
     }
 
@@ -790,6 +784,58 @@ namespace
         return kinv;
     }
 
+    template<typename TF>
+    void calc_radiation_fields_h(
+            TF* restrict T_h, TF* restrict T_sfc,
+            TF* restrict thlh, TF* restrict qth,
+            const TF* restrict thl, const TF* restrict qt, const TF* restrict thl_bot,
+            const TF* restrict ph,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int igc, const int jgc, const int kgc,
+            const int jj, const int kk,
+            const int jj_nogc, const int kk_nogc)
+    {
+        // Half level temperature and surface temperature, without ghost cells.
+        using Finite_difference::O2::interp2;
+
+        for (int k=kstart; k<kend+1; ++k)
+        {
+            const TF exnh = exner(ph[k]);
+            for (int j=jstart; j<jend; ++j)
+                #pragma ivdep
+                for (int i=istart; i<iend; ++i)
+                {
+                    const int ij  = i + j*jj;
+                    const int ijk = i + j*jj + k*kk;
+                    thlh[ij] = interp2(thl[ijk-kk], thl[ijk]);
+                    qth [ij] = interp2(qt [ijk-kk], qt [ijk]);
+                }
+
+            for (int j=jstart; j<jend; ++j)
+            {
+                const int ij = istart + j*jj;
+                const int ijk_nogc = (j-jgc)*jj_nogc + (k-kgc)*kk_nogc;
+                sat_adjust_row<TF, TF>(
+                        nullptr, nullptr, &T_h[ijk_nogc], nullptr,
+                        &thlh[ij], &qth[ij], ph[k], exnh, iend-istart);
+            }
+        }
+
+        // Calculate surface temperature (assuming no liquid water)
+        const TF exn_bot = exner(ph[kstart]);
+        for (int j=jstart; j<jend; ++j)
+            #pragma ivdep
+            for (int i=istart; i<iend; ++i)
+            {
+                const int ij = i + j*jj;
+                const int ij_nogc = (i-igc) + (j-jgc)*jj_nogc;
+
+                T_sfc[ij_nogc] = thl_bot[ij] * exn_bot;
+            }
+    }
+
     template<typename TF>
     void calc_radiation_fields(
             TF* restrict T, TF* restrict T_h, TF* restrict vmr_h2o,
@@ -830,40 +876,10 @@ namespace
                 }
         }
 
-        for (int k=kstart; k<kend+1; ++k)
-        {
-            const TF exnh = exner(ph[k]);
-            for (int j=jstart; j<jend; ++j)
-                #pragma ivdep
-                for (int i=istart; i<iend; ++i)
-                {
-                    const int ij  = i + j*jj;
-                    const int ijk = i + j*jj + k*kk;
-                    thlh[ij] = interp2(thl[ijk-kk], thl[ijk]);
-                    qth [ij] = interp2(qt [ijk-kk], qt [ijk]);
-                }
-
-            for (int j=jstart; j<jend; ++j)
-                #pragma ivdep
-                for (int i=istart; i<iend; ++i)
-                {
-                    const int ij = i + j*jj;
-                    const int ijk_nogc = (i-igc) + (j-jgc)*jj_nogc + (k-kgc)*kk_nogc;
-                    T_h[ijk_nogc] = sat_adjust(thlh[ij], qth[ij], ph[k], exnh).t;
-                }
-        }
-
-        // Calculate surface temperature (assuming no liquid water)
-        const TF exn_bot = exner(ph[kstart]);
-        for (int j=jstart; j<jend; ++j)
-            #pragma ivdep
-            for (int i=istart; i<iend; ++i)
-            {
-                const int ij = i + j*jj;
-                const int ij_nogc = (i-igc) + (j-jgc)*jj_nogc;
-
-                T_sfc[ij_nogc] = thl_bot[ij] * exn_bot;
-            }
+        calc_radiation_fields_h(
+                T_h, T_sfc, thlh, qth, thl, qt, thl_bot, ph,
+                istart, iend, jstart, jend, kstart, kend,
+                igc, jgc, kgc, jj, kk, jj_nogc, kk_nogc);
     }
     
     template<typename TF>
@@ -906,40 +922,139 @@ namespace
                 }
         }
 
-        for (int k=kstart; k<kend+1; ++k)
+        calc_radiation_fields_h(
+                T_h, T_sfc, thlh, qth, thl, qt, thl_bot, ph,
+                istart, iend, jstart, jend, kstart, kend,
+                igc, jgc, kgc, jj, kk, jj_nogc, kk_nogc);
+    }
+
+    template<typename TF, typename TC>
+    void calc_satcache(
+            TC* const restrict ql, TC* const restrict qi, TC* const restrict T, TC* const restrict qs,
+            const TF* const restrict thl, const TF* const restrict qt, const TF* const restrict p,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int jj, const int kk)
+    {
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
         {
-            const TF exnh = exner(ph[k]);
+            const TF ex = exner(p[k]);
+            for (int j=jstart; j<jend; ++j)
+            {
+                const int ijk = istart + j*jj + k*kk;
+                sat_adjust_row(
+                        &ql[ijk], &qi[ijk], &T[ijk], &qs[ijk],
+                        &thl[ijk], &qt[ijk], p[k], ex, iend-istart);
+            }
+        }
+    }
+
+    template<typename TF, typename TC>
+    void copy_from_satcache(
+            TF* const restrict fld, const TC* const restrict fld_cache,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int jj, const int kk)
+    {
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
             for (int j=jstart; j<jend; ++j)
                 #pragma ivdep
                 for (int i=istart; i<iend; ++i)
                 {
-                    const int ij  = i + j*jj;
                     const int ijk = i + j*jj + k*kk;
-                    thlh[ij] = interp2(thl[ijk-kk], thl[ijk]);
-                    qth [ij] = interp2(qt [ijk-kk], qt [ijk]);
+                    fld[ijk] = static_cast<TF>(fld_cache[ijk]);
                 }
+    }
 
+    template<typename TF, typename TC>
+    void calc_condensate_from_satcache(
+            TF* const restrict qc, const TF* const restrict qt, const TC* const restrict qs,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int jj, const int kk)
+    {
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
             for (int j=jstart; j<jend; ++j)
                 #pragma ivdep
                 for (int i=istart; i<iend; ++i)
                 {
-                    const int ij = i + j*jj;
-                    const int ijk_nogc = (i-igc) + (j-jgc)*jj_nogc + (k-kgc)*kk_nogc;
-                    T_h[ijk_nogc] = sat_adjust(thlh[ij], qth[ij], ph[k], exnh).t;
+                    const int ijk = i + j*jj + k*kk;
+                    qc[ijk] = std::max(qt[ijk] - static_cast<TF>(qs[ijk]), TF(0.));
                 }
-        }
+    }
 
-        // Calculate surface temperature (assuming no liquid water)
-        const TF exn_bot = exner(ph[kstart]);
-        for (int j=jstart; j<jend; ++j)
-            #pragma ivdep
-            for (int i=istart; i<iend; ++i)
-            {
-                const int ij = i + j*jj;
-                const int ij_nogc = (i-igc) + (j-jgc)*jj_nogc;
+    template<typename TF, typename TC>
+    void calc_relative_humidity_from_satcache(
+            TF* const restrict rh, const TF* const restrict qt, const TC* const restrict qs,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int jj, const int kk)
+    {
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
+            for (int j=jstart; j<jend; ++j)
+                #pragma ivdep
+                for (int i=istart; i<iend; ++i)
+                {
+                    const int ijk = i + j*jj + k*kk;
+                    rh[ijk] = std::min(qt[ijk] / static_cast<TF>(qs[ijk]), TF(1.));
+                }
+    }
 
-                T_sfc[ij_nogc] = thl_bot[ij] * exn_bot;
-            }
+    template<typename TF, typename TC>
+    void calc_radiation_fields_from_satcache(
+            TF* restrict T, TF* restrict vmr_h2o, TF* restrict rh,
+            TF* restrict clwp, TF* restrict ciwp,
+            const TC* restrict ql_c, const TC* restrict qi_c, const TC* restrict T_c, const TC* restrict qs_c,
+            const TF* restrict qt, const TF* restrict ph,
+            const int istart, const int iend,
+            const int jstart, const int jend,
+            const int kstart, const int kend,
+            const int igc, const int jgc, const int kgc,
+            const int jj, const int kk,
+            const int jj_nogc, const int kk_nogc)
+    {
+        // Full level part of `calc_radiation_fields()`, `rh` is skipped if it is a nullptr.
+        #pragma omp parallel for
+        for (int k=kstart; k<kend; ++k)
+        {
+            const TF dpg = (ph[k] - ph[k+1]) / Constants::grav<TF>;
+            for (int j=jstart; j<jend; ++j)
+                #pragma ivdep
+                for (int i=istart; i<iend; ++i)
+                {
+                    const int ijk = i + j*jj + k*kk;
+                    const int ijk_nogc = (i-igc) + (j-jgc)*jj_nogc + (k-kgc)*kk_nogc;
+
+                    const TF ql = static_cast<TF>(ql_c[ijk]);
+                    const TF qi = static_cast<TF>(qi_c[ijk]);
+
+                    clwp[ijk_nogc] = ql * dpg;
+                    ciwp[ijk_nogc] = qi * dpg;
+
+                    const TF qv = qt[ijk] - ql - qi;
+                    vmr_h2o[ijk_nogc] = qv / (ep<TF> - ep<TF>*qv);
+
+                    T[ijk_nogc] = static_cast<TF>(T_c[ijk]);
+                }
+
+            if (rh != nullptr)
+                for (int j=jstart; j<jend; ++j)
+                    #pragma ivdep
+                    for (int i=istart; i<iend; ++i)
+                    {
+                        const int ijk = i + j*jj + k*kk;
+                        const int ijk_nogc = (i-igc) + (j-jgc)*jj_nogc + (k-kgc)*kk_nogc;
+                        rh[ijk_nogc] = std::min(qt[ijk] / static_cast<TF>(qs_c[ijk]), TF(1.));
+                    }
+        }
     }
 
     template<typename TF>
@@ -1115,6 +1230,31 @@ Thermo_moist<TF>::Thermo_moist(Master& masterin, Grid<TF>& gridin, Fields<TF>& f
     // swupdate..=1 -> base state pressure updated before saturation calculation
     bs.swupdatebasestate = inputin.get_item<bool>("thermo", "swupdatebasestate", "", true);
 
+    // Cache the saturation adjustment at the full levels, such that all consumers
+    // of ql, qi, T and qsat within one (sub)step share a single computation.
+    satcache.swcache = inputin.get_item<bool>("thermo", "swsatcache", "", false);
+    if (satcache.swcache)
+    {
+        satcache.swfloat = inputin.get_item<bool>("thermo", "swsatcachefloat", "", false);
+        satcache.maxmem = inputin.get_item<TF>("thermo", "satcachemaxmem", "", 1024.);
+    }
+    else
+    {
+        satcache.swfloat = false;
+        satcache.maxmem = 0.;
+        inputin.flag_as_used("thermo", "swsatcachefloat", "");
+        inputin.flag_as_used("thermo", "satcachemaxmem", "");
+    }
+    satcache.is_valid = false;
+
+    #ifdef USECUDA
+    if (satcache.swcache)
+    {
+        master.print_warning("swsatcache is not supported on the GPU, the cache is disabled\n");
+        satcache.swcache = false;
+    }
+    #endif
+
     // Time variable surface pressure
     tdep_pbot = std::make_unique<Timedep<TF>>(master, grid, "p_sbot", inputin.get_item<bool>("thermo", "swtimedep_pbot", "", false));
 
@@ -1148,6 +1288,37 @@ void Thermo_moist<TF>::init()
     bs.prefh.resize(gd.kcells);
     bs.rhoref.resize(gd.kcells);
     bs.rhorefh.resize(gd.kcells);
+
+    #ifdef ESAT_TABLE
+    const std::pair<double, double> esat_err = esat_table_max_error<TF>();
+    master.print_message(
+            "Saturation vapor pressure from lookup tables, max. relative error: liquid %.2e, ice %.2e\n",
+            esat_err.first, esat_err.second);
+    #endif
+
+    if (satcache.swcache)
+    {
+        const std::size_t nbytes = 4 * gd.ncells * (satcache.swfloat ? sizeof(float) : sizeof(TF));
+        const TF mbytes = static_cast<TF>(nbytes) / (1024*1024);
+
+        if (mbytes > satcache.maxmem)
+        {
+            master.print_warning(
+                    "Saturation adjustment cache needs %.1f MB, more than satcachemaxmem=%.1f MB, the cache is disabled\n",
+                    mbytes, satcache.maxmem);
+            satcache.swcache = false;
+        }
+        else
+        {
+            satcache.pref.resize(gd.kcells);
+            if (satcache.swfloat)
+                satcache.fld_float.resize(4*gd.ncells);
+            else
+                satcache.fld.resize(4*gd.ncells);
+        }
+    }
+
+    field3d_io.init();
 }
 
 template<typename TF>
@@ -1217,6 +1388,9 @@ void Thermo_moist<TF>::load(const int iotime)
 {
     auto& gd = grid.get_grid_data();
 
+    // The prognostic fields are replaced, so the cached saturation adjustment is outdated.
+    satcache.is_valid = false;
+
     int nerror = 0;
 
     if ( (master.get_mpiid() == 0) && bs.swupdatebasestate)
@@ -1493,6 +1667,116 @@ template<typename TF>
 void Thermo_moist<TF>::update_time_dependent(Timeloop<TF>& timeloop)
 {
     tdep_pbot->update_time_dependent(bs.pbot, timeloop);
+
+    // This is called once at the start of every (sub)step, after the
+    // integration of the previous one, which outdates the cache.
+    satcache.is_valid = false;
+}
+
+template<typename TF>
+void Thermo_moist<TF>::update_satcache(const std::vector<TF>& pref) const
+{
+    // The cache is reused as long as the prognostic fields and the pressure
+    // that it was computed with have not changed.
+    if (satcache.is_valid && satcache.pref == pref)
+        return;
+
+    auto& gd = grid.get_grid_data();
+
+    auto fill = [&](auto* fld_cache)
+    {
+        calc_satcache(
+                &fld_cache[0*gd.ncells], &fld_cache[1*gd.ncells],
+                &fld_cache[2*gd.ncells], &fld_cache[3*gd.ncells],
+                fields.sp.at("thl")->fld.data(), fields.sp.at("qt")->fld.data(), pref.data(),
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    };
+
+    if (satcache.swfloat)
+        fill(satcache.fld_float.data());
+    else
+        fill(satcache.fld.data());
+
+    satcache.pref = pref;
+    satcache.is_valid = true;
+}
+
+template<typename TF>
+template<typename TC>
+void Thermo_moist<TF>::get_thermo_field_cached(
+        Field3d<TF>& fld, const std::string& name, const std::vector<TC>& fld_cache)
+{
+    auto& gd = grid.get_grid_data();
+
+    const TC* ql_c = &fld_cache[0*gd.ncells];
+    const TC* qi_c = &fld_cache[1*gd.ncells];
+    const TC* T_c  = &fld_cache[2*gd.ncells];
+    const TC* qs_c = &fld_cache[3*gd.ncells];
+
+    if (name == "ql")
+        copy_from_satcache(
+                fld.fld.data(), ql_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else if (name == "qi")
+        copy_from_satcache(
+                fld.fld.data(), qi_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else if (name == "qsat")
+        copy_from_satcache(
+                fld.fld.data(), qs_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else if (name == "T")
+        copy_from_satcache(
+                fld.fld.data(), T_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else if (name == "qlqi")
+        calc_condensate_from_satcache(
+                fld.fld.data(), fields.sp.at("qt")->fld.data(), qs_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else if (name == "rh")
+        calc_relative_humidity_from_satcache(
+                fld.fld.data(), fields.sp.at("qt")->fld.data(), qs_c,
+                gd.istart, gd.iend, gd.jstart, gd.jend, gd.kstart, gd.kend, gd.icells, gd.ijcells);
+    else
+    {
+        std::string error_message = "Can not get cached thermo field: \"" + name + "\"";
+        throw std::runtime_error(error_message);
+    }
+}
+
+template<typename TF>
+template<typename TC>
+void Thermo_moist<TF>::get_radiation_fields_cached(
+        Field3d<TF>& T, Field3d<TF>& T_h, Field3d<TF>& qv, TF* rh, Field3d<TF>& clwp, Field3d<TF>& ciwp,
+        const std::vector<TC>& fld_cache) const
+{
+    auto& gd = grid.get_grid_data();
+
+    calc_radiation_fields_from_satcache(
+            T.fld.data(), qv.fld.data(), rh,
+            clwp.fld.data(), ciwp.fld.data(),
+            &fld_cache[0*gd.ncells], &fld_cache[1*gd.ncells],
+            &fld_cache[2*gd.ncells], &fld_cache[3*gd.ncells],
+            fields.sp.at("qt")->fld.data(), bs.prefh.data(),
+            gd.istart, gd.iend,
+            gd.jstart, gd.jend,
+            gd.kstart, gd.kend,
+            gd.igc, gd.jgc, gd.kgc,
+            gd.icells, gd.ijcells,
+            gd.imax, gd.imax*gd.jmax);
+
+    calc_radiation_fields_h(
+            T_h.fld.data(), T_h.fld_bot.data(),
+            T.fld_bot.data(), T.fld_top.data(),  // These 2d fields are used as tmp arrays.
+            fields.sp.at("thl")->fld.data(), fields.sp.at("qt")->fld.data(),
+            fields.sp.at("thl")->fld_bot.data(),
+            bs.prefh.data(),
+            gd.istart, gd.iend,
+            gd.jstart, gd.jend,
+            gd.kstart, gd.kend,
+            gd.igc, gd.jgc, gd.kgc,
+            gd.icells, gd.ijcells,
+            gd.imax, gd.imax*gd.jmax);
 }
 
 template<typename TF>
@@ -1518,7 +1802,19 @@ void Thermo_moist<TF>::get_thermo_field(
         fields.release_tmp(tmp);
     }
 
-    if (name == "b")
+    const bool use_satcache = satcache.swcache &&
+        (name == "ql" || name == "qi" || name == "qlqi" || name == "qsat" || name == "rh" || name == "T");
+
+    if (use_satcache)
+    {
+        update_satcache(base.pref);
+
+        if (satcache.swfloat)
+            get_thermo_field_cached(fld, name, satcache.fld_float);
+        else
+            get_thermo_field_cached(fld, name, satcache.fld);
+    }
+    else if (name == "b")
     {
         auto tmp  = fields.get_tmp();
         auto tmp2 = fields.get_tmp();
@@ -1619,6 +1915,17 @@ void Thermo_moist<TF>::get_radiation_fields(
 {
     auto& gd = grid.get_grid_data();
 
+    if (satcache.swcache)
+    {
+        update_satcache(bs.pref);
+
+        if (satcache.swfloat)
+            get_radiation_fields_cached(T, T_h, qv, nullptr, clwp, ciwp, satcache.fld_float);
+        else
+            get_radiation_fields_cached(T, T_h, qv, nullptr, clwp, ciwp, satcache.fld);
+        return;
+    }
+
     calc_radiation_fields(
             T.fld.data(), T_h.fld.data(), qv.fld.data(),
             clwp.fld.data(), ciwp.fld.data(), T_h.fld_bot.data(),
@@ -1640,6 +1947,17 @@ void Thermo_moist<TF>::get_radiation_fields(
 {
     auto& gd = grid.get_grid_data();
 
+    if (satcache.swcache)
+    {
+        update_satcache(bs.pref);
+
+        if (satcache.swfloat)
+            get_radiation_fields_cached(T, T_h, qv, rh.fld.data(), clwp, ciwp, satcache.fld_float);
+        else
+            get_radiation_fields_cached(T, T_h, qv, rh.fld.data(), clwp, ciwp, satcache.fld);
+        return;
+    }
+
     calc_radiation_fields(
             T.fld.data(), T_h.fld.data(), qv.fld.data(), rh.fld.data(),
             clwp.fld.data(), ciwp.fld.data(), T_h.fld_bot.data(),
@@ -2043,106 +2361,131 @@ void Thermo_moist<TF>::exec_stats(Stats<TF>& stats)
     const TF no_threshold = 0.;
 
     // Calculate the virtual temperature stats.
-    auto thv = fields.get_tmp();
-    thv->loc = gd.sloc;
-    get_thermo_field(*thv, "thv", true, true);
-    get_thermo_field(*thv, "thv_fluxbot", true, true);
+    if (stats.is_needed("thv"))
+    {
+        auto thv = fields.get_tmp();
+        thv->loc = gd.sloc;
+        get_thermo_field(*thv, "thv", true, true);
+        get_thermo_field(*thv, "thv_fluxbot", true, true);
 
-    stats.calc_stats("thv", *thv, no_offset, no_threshold);
+        stats.calc_stats("thv", *thv, no_offset, no_threshold);
 
-    fields.release_tmp(thv);
+        fields.release_tmp(thv);
+    }
 
     // Calculate the absolute temperature stats.
-    auto T = fields.get_tmp();
-    T->loc = gd.sloc;
+    if (stats.is_needed("T"))
+    {
+        auto T = fields.get_tmp();
+        T->loc = gd.sloc;
 
-    get_thermo_field(*T, "T", true, true);
-    stats.calc_stats("T", *T, no_offset, no_threshold);
+        get_thermo_field(*T, "T", true, true);
+        stats.calc_stats("T", *T, no_offset, no_threshold);
 
-    fields.release_tmp(T);
+        fields.release_tmp(T);
+    }
 
     // Calculate the liquid water stats
-    auto ql = fields.get_tmp();
-    ql->loc = gd.sloc;
+    if (stats.is_needed("ql"))
+    {
+        auto ql = fields.get_tmp();
+        ql->loc = gd.sloc;
 
-    for (int n=0; n<gd.ncells; ++n)
-        ql->fld[n] = 0.;
+        for (int n=0; n<gd.ncells; ++n)
+            ql->fld[n] = 0.;
 
-    for (int n=0; n<gd.ijcells; ++n)
-    {
-        ql->flux_bot[n] = 0.;
-        ql->flux_top[n] = 0.;
-    }
+        for (int n=0; n<gd.ijcells; ++n)
+        {
+            ql->flux_bot[n] = 0.;
+            ql->flux_top[n] = 0.;
+        }
 
-    get_thermo_field(*ql, "ql", true, true);
-    stats.calc_stats("ql", *ql, no_offset, no_threshold);
+        get_thermo_field(*ql, "ql", true, true);
+        stats.calc_stats("ql", *ql, no_offset, no_threshold);
 
-    // set all values to zero
-    for (int n=0; n<gd.ncells; ++n)
-        ql->fld[n] = 0.;
+        // The half level liquid water is only required for the fluxes.
+        if (stats.is_any_needed({"ql_w", "ql_flux"}))
+        {
+            // set all values to zero
+            for (int n=0; n<gd.ncells; ++n)
+                ql->fld[n] = 0.;
 
-    for (int n=0; n<gd.kcells; ++n)
-        ql->fld_mean[n] = 0.;
+            for (int n=0; n<gd.kcells; ++n)
+                ql->fld_mean[n] = 0.;
 
-    for (int n=0; n<gd.ijcells; ++n)
-    {
-        ql->fld_bot [n] = 0.;
-        ql->fld_top [n] = 0.;
-        ql->grad_bot[n] = 0.;
-        ql->grad_top[n] = 0.;
-        ql->flux_bot[n] = 0.;
-        ql->flux_top[n] = 0.;
-    }
+            for (int n=0; n<gd.ijcells; ++n)
+            {
+                ql->fld_bot [n] = 0.;
+                ql->fld_top [n] = 0.;
+                ql->grad_bot[n] = 0.;
+                ql->grad_top[n] = 0.;
+                ql->flux_bot[n] = 0.;
+                ql->flux_top[n] = 0.;
+            }
 
-    ql->loc = gd.wloc;
-    get_thermo_field(*ql, "ql_h", true, true);
-    ql->loc = gd.wloc;
+            ql->loc = gd.wloc;
+            get_thermo_field(*ql, "ql_h", true, true);
+            ql->loc = gd.wloc;
 
-    stats.calc_stats_w("ql", *ql, no_offset);
-    stats.calc_stats_flux("ql", *ql, no_offset);
+            stats.calc_stats_w("ql", *ql, no_offset);
+            stats.calc_stats_flux("ql", *ql, no_offset);
+        }
 
-    fields.release_tmp(ql);
+        fields.release_tmp(ql);
+    }
 
     // Calculate the ice stats
-    auto qi = fields.get_tmp();
-    qi->loc = gd.sloc;
+    if (stats.is_needed("qi"))
+    {
+        auto qi = fields.get_tmp();
+        qi->loc = gd.sloc;
 
-    get_thermo_field(*qi, "qi", true, true);
-    stats.calc_stats("qi", *qi, no_offset, no_threshold);
+        get_thermo_field(*qi, "qi", true, true);
+        stats.calc_stats("qi", *qi, no_offset, no_threshold);
 
-    fields.release_tmp(qi);
+        fields.release_tmp(qi);
+    }
 
     // Calculate the combined liquid water and ice stats
-    auto qlqi = fields.get_tmp();
-    qlqi->loc = gd.sloc;
+    if (stats.is_needed("qlqi"))
+    {
+        auto qlqi = fields.get_tmp();
+        qlqi->loc = gd.sloc;
 
-    get_thermo_field(*qlqi, "qlqi", true, true);
-    stats.calc_stats("qlqi", *qlqi, no_offset, no_threshold);
+        get_thermo_field(*qlqi, "qlqi", true, true);
+        stats.calc_stats("qlqi", *qlqi, no_offset, no_threshold);
 
-    fields.release_tmp(qlqi);
+        fields.release_tmp(qlqi);
+    }
 
     // Calculate the saturated water vapor stats
-    auto qsat = fields.get_tmp();
-    qsat->loc = gd.sloc;
+    if (stats.is_needed("qsat"))
+    {
+        auto qsat = fields.get_tmp();
+        qsat->loc = gd.sloc;
 
-    get_thermo_field(*qsat, "qsat", true, true);
-    stats.calc_stats("qsat", *qsat, no_offset, no_threshold);
+        get_thermo_field(*qsat, "qsat", true, true);
+        stats.calc_stats("qsat", *qsat, no_offset, no_threshold);
 
-    fields.release_tmp(qsat);
+        fields.release_tmp(qsat);
+    }
 
     // Calculate the relative humidity
-    auto rh = fields.get_tmp();
-    rh->loc = gd.sloc;
+    if (stats.is_needed("rh"))
+    {
+        auto rh = fields.get_tmp();
+        rh->loc = gd.sloc;
 
-    get_thermo_field(*rh, "rh", true, true);
-    stats.calc_stats("rh", *rh, no_offset, no_threshold);
+        get_thermo_field(*rh, "rh", true, true);
+        stats.calc_stats("rh", *rh, no_offset, no_threshold);
+
+        fields.release_tmp(rh);
+    }
 
     // // Surface values
     // stats.calc_stats_2d("thl_bot", fields.ap.at("thl")->fld_bot, no_offset);
     // stats.calc_stats_2d("qt_bot", fields.ap.at("qt")->fld_bot, no_offset);
 
-    fields.release_tmp(rh);
-
     if (bs_stats.swupdatebasestate)
     {
         stats.set_prof("phydro" , bs_stats.pref);